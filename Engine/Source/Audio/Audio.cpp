@@ -12,6 +12,9 @@
 
 #include <vorbis/vorbisenc.h>
 
+#define OV_EXCLUDE_STATIC_CALLBACKS
+#include <vorbis/vorbisfile.h>
+
 // Most of this vorbis encoding / decoding code was taken from the official libvorbis samples.
 
 #define READ 1024
@@ -203,9 +206,9 @@ void AUD_EncodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format)
     LogDebug("Encoded Vorbis: %d bytes -> %d bytes", inStream.GetSize(), outStream.GetSize());
 }
 
-static ogg_int16_t convbuffer[4096]; /* take 8k out of the data segment, not the stack */
-static uint8_t convbuffer8[4096];
-static int convsize = 4096;
+// Sounds are decoded on async load worker threads, so each thread gets its own conversion buffers.
+static thread_local ogg_int16_t convbuffer[4096]; /* take 8k out of the data segment, not the stack */
+static thread_local uint8_t convbuffer8[4096];
 
 void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format)
 {
@@ -348,7 +351,7 @@ void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format)
             OCT_ASSERT(vi.rate == (int)format.mSampleRate);
         }
 
-        convsize = 4096 / vi.channels;
+        int convsize = 4096 / vi.channels;
 
         /* OK, got and parsed all three headers. Initialize the Vorbis
            packet->PCM decoder. */
@@ -483,3 +486,128 @@ void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format)
     LogDebug("Decoded Vorbis: %d bytes -> %d bytes", inStream.GetSize(), outStream.GetSize());
 }
 
+
+struct VorbisStream
+{
+    OggVorbis_File mFile = {};
+    const uint8_t* mData = nullptr;
+    uint32_t mSize = 0;
+    uint32_t mPos = 0;
+    PcmFormat mFormat;
+};
+
+static size_t VorbisStreamRead(void* ptr, size_t size, size_t nmemb, void* datasource)
+{
+    VorbisStream* stream = (VorbisStream*)datasource;
+    size_t bytes = size * nmemb;
+    size_t remaining = stream->mSize - stream->mPos;
+    bytes = (bytes < remaining) ? bytes : remaining;
+
+    memcpy(ptr, stream->mData + stream->mPos, bytes);
+    stream->mPos += (uint32_t)bytes;
+
+    return (size > 0) ? (bytes / size) : 0;
+}
+
+static int VorbisStreamSeek(void* datasource, ogg_int64_t offset, int whence)
+{
+    VorbisStream* stream = (VorbisStream*)datasource;
+    ogg_int64_t newPos = 0;
+
+    switch (whence)
+    {
+    case SEEK_SET: newPos = offset; break;
+    case SEEK_CUR: newPos = stream->mPos + offset; break;
+    case SEEK_END: newPos = stream->mSize + offset; break;
+    default: return -1;
+    }
+
+    if (newPos < 0 || newPos > stream->mSize)
+        return -1;
+
+    stream->mPos = (uint32_t)newPos;
+    return 0;
+}
+
+static long VorbisStreamTell(void* datasource)
+{
+    VorbisStream* stream = (VorbisStream*)datasource;
+    return (long)stream->mPos;
+}
+
+VorbisStream* AUD_CreateVorbisStream(const uint8_t* data, uint32_t size, PcmFormat format)
+{
+    VorbisStream* stream = new VorbisStream();
+    stream->mData = data;
+    stream->mSize = size;
+    stream->mFormat = format;
+
+    ov_callbacks callbacks;
+    callbacks.read_func = VorbisStreamRead;
+    callbacks.seek_func = VorbisStreamSeek;
+    callbacks.close_func = nullptr;
+    callbacks.tell_func = VorbisStreamTell;
+
+    if (ov_open_callbacks(stream, &stream->mFile, nullptr, 0, callbacks) != 0)
+    {
+        LogError("Failed to open Vorbis stream.");
+        delete stream;
+        return nullptr;
+    }
+
+    OCT_ASSERT(ov_info(&stream->mFile, -1)->channels == (int)format.mNumChannels);
+
+    return stream;
+}
+
+void AUD_DestroyVorbisStream(VorbisStream* stream)
+{
+    if (stream != nullptr)
+    {
+        ov_clear(&stream->mFile);
+        delete stream;
+    }
+}
+
+uint32_t AUD_ReadVorbisStream(VorbisStream* stream, uint8_t* outData, uint32_t numFrames)
+{
+    const int bytesPerSample = (int)stream->mFormat.mBytesPerSample;
+    const int bytesPerFrame = bytesPerSample * (int)stream->mFormat.mNumChannels;
+    const int signedSamples = (bytesPerSample == 2) ? 1 : 0;
+
+    int bytesRemaining = int(numFrames) * bytesPerFrame;
+    int bytesRead = 0;
+    int bitstream = 0;
+
+    while (bytesRemaining > 0)
+    {
+        long ret = ov_read(&stream->mFile, (char*)(outData + bytesRead), bytesRemaining, 0, bytesPerSample, signedSamples, &bitstream);
+
+        if (ret == 0)
+        {
+            // End of stream
+            break;
+        }
+        else if (ret < 0)
+        {
+            // OV_HOLE is recoverable, anything else is not.
+            if (ret != OV_HOLE)
+            {
+                LogError("Error decoding Vorbis stream (%ld)", ret);
+                break;
+            }
+        }
+        else
+        {
+            bytesRead += (int)ret;
+            bytesRemaining -= (int)ret;
+        }
+    }
+
+    return uint32_t(bytesRead / bytesPerFrame);
+}
+
+bool AUD_SeekVorbisStream(VorbisStream* stream, uint32_t frame)
+{
+    return ov_pcm_seek(&stream->mFile, (ogg_int64_t)frame) == 0;
+}
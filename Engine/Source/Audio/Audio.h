@@ -5,6 +5,7 @@
 class Stream;
 class SoundWave;
 class Audio3D;
+struct VorbisStream;
 
 struct PcmFormat
 {
@@ -35,6 +36,22 @@ uint8_t* AUD_AllocWaveBuffer(uint32_t size);
 void AUD_FreeWaveBuffer(void* buffer);
 void AUD_ProcessWaveBuffer(SoundWave* soundWave);
 
+#if PLATFORM_LINUX
+// Headless mode skips the sound device and mix thread. Must be set before AUD_Initialize().
+// Audio is then only mixed when AUD_MixHeadless() is called, which makes output deterministic.
+// If AUD_MixHeadless() is never called, AUD_Update() advances voices in real time without mixing.
+void AUD_SetHeadless(bool headless);
+bool AUD_IsHeadless();
+uint32_t AUD_MixHeadless(int16_t* outBuffer, uint32_t numFrames);
+#endif
+
 // Platform Independent
 void AUD_EncodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format);
 void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format);
+
+// Incremental decoding of a resident Ogg Vorbis buffer. Used for streaming SoundWaves.
+// The data must stay valid until the stream is destroyed.
+VorbisStream* AUD_CreateVorbisStream(const uint8_t* data, uint32_t size, PcmFormat format);
+void AUD_DestroyVorbisStream(VorbisStream* stream);
+uint32_t AUD_ReadVorbisStream(VorbisStream* stream, uint8_t* outData, uint32_t numFrames); // Returns 0 at end of stream
+bool AUD_SeekVorbisStream(VorbisStream* stream, uint32_t frame);
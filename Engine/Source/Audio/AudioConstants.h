@@ -10,4 +10,13 @@
 #define AUDIO_MAX_VOICES 8
 #elif PLATFORM_3DS
 #define AUDIO_MAX_VOICES 8
-#endif
\ No newline at end of file
+#endif
+
+// Whether the audio backend can decode compressed SoundWaves on the fly.
+// Otherwise streaming SoundWaves are fully decoded at load time.
+#if PLATFORM_LINUX
+#define AUDIO_STREAMING_SUPPORTED 1
+#define AUDIO_STREAM_BUFFER_FRAMES 16384
+#else
+#define AUDIO_STREAMING_SUPPORTED 0
+#endif
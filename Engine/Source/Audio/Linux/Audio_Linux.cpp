@@ -9,31 +9,606 @@
 #include "Maths.h"
 
 #include <alsa/asoundlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define AUDIO_MIX_SSE 1
+#else
+#define AUDIO_MIX_SSE 0
+#endif
 
-snd_pcm_t* sSoundDevice = nullptr;
-snd_pcm_uframes_t sPlaybackFrames = 0;
-uint32_t sMixBufferLen = 0;
-int16_t* sMixBuffer = nullptr;
+#define AUDIO_OUTPUT_RATE 44100
+#define AUDIO_COMMAND_QUEUE_SIZE 256
+#define AUDIO_MIX_THREAD_WAIT_MS 10
+
+enum class AudioCommandType : uint8_t
+{
+    Play,
+    Stop,
+    SetVolume,
+    SetPitch,
+
+    Count
+};
+
+struct AudioCommand
+{
+    AudioCommandType mType = AudioCommandType::Count;
+    uint8_t mVoice = 0;
+    bool mLoop = false;
+    uint32_t mPlayId = 0;
+    uint8_t* mSrcBuffer = nullptr;
+    uint32_t mSrcFrames = 0;
+    VorbisStream* mStream = nullptr;
+    uint32_t mNumChannels = 2;
+    uint32_t mBytesPerSample = 2;
+    int32_t mSampleRate = AUDIO_OUTPUT_RATE;
+    float mVolumeL = 1.0f;
+    float mVolumeR = 1.0f;
+    float mPitch = 1.0f;
+    float mStartTime = 0.0f;
+};
 
+// Only touched by the mix thread (or the main thread in headless mode).
 struct SoundVoice
 {
-    int32_t mSampleRate = 44100;
+    int32_t mSampleRate = AUDIO_OUTPUT_RATE;
     float mPitch = 1.0f;
     float mVolumeL = 1.0f;
     float mVolumeR = 1.0f;
     uint8_t* mSrcBuffer = nullptr;
-    uint32_t mSrcBufferLen = 0;
     uint32_t mSrcFrames = 0;
-    float mCurFrame = 0;
+    double mCurFrame = 0.0;
     uint32_t mNumChannels = 2;
     uint32_t mBytesPerSample = 2;
+    uint32_t mPlayId = 0;
     bool mLoop = false;
     bool mActive = false;
+
+    // Streaming voices decode into a small window buffer instead of reading a full PCM buffer.
+    // mCurFrame is relative to the start of the window.
+    VorbisStream* mStream = nullptr;
+    uint8_t* mStreamBuffer = nullptr;
+    uint32_t mStreamFrames = 0;
+    bool mStreamEnded = false;
+};
+
+// Only touched by the main thread.
+struct VoiceState
+{
+    uint32_t mPlayId = 0;
+    bool mActive = false;
 };
 
+snd_pcm_t* sSoundDevice = nullptr;
+snd_pcm_uframes_t sPlaybackFrames = 0;
+uint32_t sMixBufferLen = 0;
+int16_t* sMixBuffer = nullptr;
+float* sAccumBuffer = nullptr;
+
 static SoundVoice sVoices[AUDIO_MAX_VOICES];
+static VoiceState sVoiceStates[AUDIO_MAX_VOICES];
+static std::atomic<uint32_t> sVoiceFinishedIds[AUDIO_MAX_VOICES];
 
-void AUD_Initialize()
+// Single producer (main thread) / single consumer (mix thread) command ring.
+static AudioCommand sCommandQueue[AUDIO_COMMAND_QUEUE_SIZE];
+static std::atomic<uint32_t> sCommandWriteIndex(0);
+static std::atomic<uint32_t> sCommandReadIndex(0);
+
+static ThreadObject* sMixThread = nullptr;
+static std::atomic<bool> sMixThreadRunning(false);
+static bool sHeadless = false;
+static bool sHeadlessMixed = false;
+static uint64_t sLastUpdateTime = 0;
+
+static void ProcessAudioCommands();
+
+static void PushAudioCommand(const AudioCommand& command)
+{
+    uint32_t writeIndex = sCommandWriteIndex.load(std::memory_order_relaxed);
+
+    // If the mix thread has fallen behind, wait for it to make room rather than drop commands.
+    while (sMixThreadRunning &&
+           writeIndex - sCommandReadIndex.load(std::memory_order_acquire) >= AUDIO_COMMAND_QUEUE_SIZE)
+    {
+        SYS_Sleep(1);
+    }
+
+    sCommandQueue[writeIndex % AUDIO_COMMAND_QUEUE_SIZE] = command;
+    sCommandWriteIndex.store(writeIndex + 1, std::memory_order_release);
+
+    // Without a mix thread (headless) nothing else drains the ring, so apply the command now.
+    if (!sMixThreadRunning)
+    {
+        ProcessAudioCommands();
+    }
+}
+
+static void ProcessAudioCommands()
+{
+    uint32_t readIndex = sCommandReadIndex.load(std::memory_order_relaxed);
+    uint32_t writeIndex = sCommandWriteIndex.load(std::memory_order_acquire);
+
+    while (readIndex != writeIndex)
+    {
+        const AudioCommand& cmd = sCommandQueue[readIndex % AUDIO_COMMAND_QUEUE_SIZE];
+        SoundVoice& voice = sVoices[cmd.mVoice];
+
+        switch (cmd.mType)
+        {
+        case AudioCommandType::Play:
+            AUD_DestroyVorbisStream(voice.mStream);
+            voice.mStream = cmd.mStream;
+            voice.mStreamFrames = 0;
+            voice.mStreamEnded = false;
+            voice.mActive = true;
+            voice.mPlayId = cmd.mPlayId;
+            voice.mSrcBuffer = cmd.mSrcBuffer;
+            voice.mSrcFrames = cmd.mSrcFrames;
+            voice.mNumChannels = cmd.mNumChannels;
+            voice.mBytesPerSample = cmd.mBytesPerSample;
+            voice.mSampleRate = cmd.mSampleRate;
+            voice.mVolumeL = cmd.mVolumeL;
+            voice.mVolumeR = cmd.mVolumeR;
+            voice.mPitch = cmd.mPitch;
+            voice.mLoop = cmd.mLoop;
+            voice.mCurFrame = voice.mStream ? 0.0 : glm::max(0.0, double(cmd.mStartTime) * cmd.mSampleRate);
+            if (voice.mLoop && voice.mSrcFrames > 0)
+            {
+                voice.mCurFrame = fmod(voice.mCurFrame, (double)voice.mSrcFrames);
+            }
+            break;
+        case AudioCommandType::Stop:
+            voice.mActive = false;
+            voice.mSrcBuffer = nullptr;
+            AUD_DestroyVorbisStream(voice.mStream);
+            voice.mStream = nullptr;
+            break;
+        case AudioCommandType::SetVolume:
+            voice.mVolumeL = cmd.mVolumeL;
+            voice.mVolumeR = cmd.mVolumeR;
+            break;
+        case AudioCommandType::SetPitch:
+            voice.mPitch = cmd.mPitch;
+            break;
+        default:
+            OCT_ASSERT(0);
+            break;
+        }
+
+        ++readIndex;
+    }
+
+    sCommandReadIndex.store(readIndex, std::memory_order_release);
+}
+
+static void FlushAudioCommands()
+{
+    if (sMixThreadRunning)
+    {
+        // Once every queued command has been consumed, the mix thread can no longer
+        // be reading from a wave buffer belonging to a stopped voice.
+        uint32_t target = sCommandWriteIndex.load(std::memory_order_relaxed);
+        while ((int32_t)(sCommandReadIndex.load(std::memory_order_acquire) - target) < 0)
+        {
+            SYS_Sleep(1);
+        }
+    }
+    else
+    {
+        ProcessAudioCommands();
+    }
+}
+
+template<uint32_t NumChannels, uint32_t BytesPerSample>
+static inline void LoadFrame(const uint8_t* src, int32_t frame, float& outL, float& outR)
+{
+    if (BytesPerSample == 1)
+    {
+        const uint8_t* samples = src + frame * NumChannels;
+        outL = (float(samples[0]) - 128.0f) * 256.0f;
+        outR = (NumChannels == 1) ? outL : (float(samples[1]) - 128.0f) * 256.0f;
+    }
+    else
+    {
+        const int16_t* samples = ((const int16_t*)src) + frame * NumChannels;
+        outL = float(samples[0]);
+        outR = (NumChannels == 1) ? outL : float(samples[1]);
+    }
+}
+
+// Mixes a run of frames where every interpolation pair (i, i + 1) is known to be in range,
+// so the inner loop has no bounds checks or wrapping.
+template<uint32_t NumChannels, uint32_t BytesPerSample>
+static void MixSpan(const SoundVoice& voice, const uint8_t* src, int32_t baseFrame, float baseAlpha, float step, float* dst, int32_t numFrames)
+{
+    int32_t f = 0;
+
+#if AUDIO_MIX_SSE
+    const __m128 volL = _mm_set1_ps(voice.mVolumeL);
+    const __m128 volR = _mm_set1_ps(voice.mVolumeR);
+    const __m128 steps = _mm_set_ps(3.0f * step, 2.0f * step, step, 0.0f);
+
+    for (; f + 4 <= numFrames; f += 4)
+    {
+        __m128 pos = _mm_add_ps(_mm_set1_ps(baseAlpha + f * step), steps);
+        __m128i posInt = _mm_cvttps_epi32(pos);
+        __m128 alpha = _mm_sub_ps(pos, _mm_cvtepi32_ps(posInt));
+
+        alignas(16) int32_t idx[4];
+        _mm_store_si128((__m128i*)idx, posInt);
+
+        alignas(16) float l0[4];
+        alignas(16) float r0[4];
+        alignas(16) float l1[4];
+        alignas(16) float r1[4];
+
+        for (int32_t k = 0; k < 4; ++k)
+        {
+            int32_t frame = baseFrame + idx[k];
+            LoadFrame<NumChannels, BytesPerSample>(src, frame, l0[k], r0[k]);
+            LoadFrame<NumChannels, BytesPerSample>(src, frame + 1, l1[k], r1[k]);
+        }
+
+        __m128 a0 = _mm_load_ps(l0);
+        __m128 b0 = _mm_load_ps(r0);
+        __m128 left = _mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(l1), a0), alpha));
+        __m128 right = _mm_add_ps(b0, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(r1), b0), alpha));
+        left = _mm_mul_ps(left, volL);
+        right = _mm_mul_ps(right, volR);
+
+        // Interleave into LRLR and accumulate
+        float* out = dst + f * 2;
+        _mm_storeu_ps(out + 0, _mm_add_ps(_mm_loadu_ps(out + 0), _mm_unpacklo_ps(left, right)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(left, right)));
+    }
+#endif
+
+    for (; f < numFrames; ++f)
+    {
+        float pos = baseAlpha + f * step;
+        int32_t posInt = int32_t(pos);
+        float alpha = pos - posInt;
+        int32_t frame = baseFrame + posInt;
+
+        float l0, r0, l1, r1;
+        LoadFrame<NumChannels, BytesPerSample>(src, frame, l0, r0);
+        LoadFrame<NumChannels, BytesPerSample>(src, frame + 1, l1, r1);
+
+        dst[f * 2 + 0] += (l0 + (l1 - l0) * alpha) * voice.mVolumeL;
+        dst[f * 2 + 1] += (r0 + (r1 - r0) * alpha) * voice.mVolumeR;
+    }
+}
+
+template<uint32_t NumChannels, uint32_t BytesPerSample>
+static void MixVoiceFormat(SoundVoice& voice, const uint8_t* src, int32_t srcFrames, bool loop, float* dst, int32_t frames)
+{
+    const float step = voice.mPitch * (voice.mSampleRate / float(AUDIO_OUTPUT_RATE));
+
+    int32_t dstFrame = 0;
+
+    while (dstFrame < frames)
+    {
+        double pos = voice.mCurFrame;
+
+        if (pos >= srcFrames)
+        {
+            if (!loop)
+                break;
+
+            pos = fmod(pos, (double)srcFrames);
+            voice.mCurFrame = pos;
+        }
+
+        int32_t baseFrame = int32_t(pos);
+        float baseAlpha = float(pos - baseFrame);
+
+        // How many dst frames can we produce before the second interpolation frame runs off the end?
+        // Keep a one frame margin so float rounding in the span can never read past the buffer.
+        int32_t spanFrames = 0;
+        double room = (srcFrames - 2) - pos;
+        if (step > 0.0f && room >= 0.0)
+        {
+            double spanCount = room / step + 1.0;
+            spanFrames = int32_t(glm::min(spanCount, double(frames - dstFrame)));
+        }
+
+        if (spanFrames > 0)
+        {
+            MixSpan<NumChannels, BytesPerSample>(voice, src, baseFrame, baseAlpha, step, dst + dstFrame * 2, spanFrames);
+            dstFrame += spanFrames;
+            voice.mCurFrame += spanFrames * double(step);
+        }
+        else
+        {
+            // Edge frame: the next frame wraps (looping) or is silence (one-shot).
+            float l0, r0;
+            float l1 = 0.0f;
+            float r1 = 0.0f;
+            LoadFrame<NumChannels, BytesPerSample>(src, baseFrame, l0, r0);
+
+            int32_t nextFrame = baseFrame + 1;
+            if (nextFrame < srcFrames)
+            {
+                LoadFrame<NumChannels, BytesPerSample>(src, nextFrame, l1, r1);
+            }
+            else if (loop)
+            {
+                LoadFrame<NumChannels, BytesPerSample>(src, 0, l1, r1);
+            }
+
+            dst[dstFrame * 2 + 0] += (l0 + (l1 - l0) * baseAlpha) * voice.mVolumeL;
+            dst[dstFrame * 2 + 1] += (r0 + (r1 - r0) * baseAlpha) * voice.mVolumeR;
+            ++dstFrame;
+            voice.mCurFrame += step;
+
+            if (step <= 0.0f)
+            {
+                // A zero pitch voice just holds its current frame.
+                for (; dstFrame < frames; ++dstFrame)
+                {
+                    dst[dstFrame * 2 + 0] += l0 * voice.mVolumeL;
+                    dst[dstFrame * 2 + 1] += r0 * voice.mVolumeR;
+                }
+            }
+        }
+    }
+
+    if (loop)
+    {
+        voice.mCurFrame = fmod(voice.mCurFrame, (double)srcFrames);
+    }
+}
+
+static void MixVoice(SoundVoice& voice, const uint8_t* src, uint32_t srcFrames, bool loop, float* dst, int32_t frames)
+{
+    OCT_ASSERT(srcFrames > 0);
+
+    if (voice.mNumChannels == 1)
+    {
+        if (voice.mBytesPerSample == 1)
+            MixVoiceFormat<1, 1>(voice, src, int32_t(srcFrames), loop, dst, frames);
+        else
+            MixVoiceFormat<1, 2>(voice, src, int32_t(srcFrames), loop, dst, frames);
+    }
+    else
+    {
+        if (voice.mBytesPerSample == 1)
+            MixVoiceFormat<2, 1>(voice, src, int32_t(srcFrames), loop, dst, frames);
+        else
+            MixVoiceFormat<2, 2>(voice, src, int32_t(srcFrames), loop, dst, frames);
+    }
+}
+
+static void MixStreamingVoice(SoundVoice& voice, float* dst, int32_t frames)
+{
+    const uint32_t bytesPerFrame = voice.mNumChannels * voice.mBytesPerSample;
+    const float step = voice.mPitch * (voice.mSampleRate / float(AUDIO_OUTPUT_RATE));
+
+    // Mix in chunks small enough that the source frames a chunk needs always fit in the window.
+    int32_t chunkFrames = int32_t((AUDIO_STREAM_BUFFER_FRAMES - 4) / glm::max(step, 1.0f));
+    chunkFrames = glm::max(chunkFrames, 1);
+
+    int32_t dstFrame = 0;
+
+    while (dstFrame < frames)
+    {
+        int32_t numFrames = glm::min(chunkFrames, frames - dstFrame);
+
+        // Discard frames that have already been played.
+        uint32_t consumed = glm::min(uint32_t(voice.mCurFrame), voice.mStreamFrames);
+        if (consumed > 0)
+        {
+            memmove(
+                voice.mStreamBuffer,
+                voice.mStreamBuffer + consumed * bytesPerFrame,
+                (voice.mStreamFrames - consumed) * bytesPerFrame);
+            voice.mStreamFrames -= consumed;
+            voice.mCurFrame -= consumed;
+        }
+
+        // Decode just enough to cover this chunk plus the interpolation frame.
+        uint32_t needed = uint32_t(voice.mCurFrame + numFrames * double(step)) + 2;
+        needed = glm::min(needed, (uint32_t)AUDIO_STREAM_BUFFER_FRAMES);
+        bool rewound = false;
+
+        while (voice.mStreamFrames < needed && !voice.mStreamEnded)
+        {
+            uint32_t decodeFrames = glm::min<uint32_t>(
+                glm::max<uint32_t>(needed - voice.mStreamFrames, 4096),
+                AUDIO_STREAM_BUFFER_FRAMES - voice.mStreamFrames);
+
+            uint32_t decoded = AUD_ReadVorbisStream(
+                voice.mStream,
+                voice.mStreamBuffer + voice.mStreamFrames * bytesPerFrame,
+                decodeFrames);
+
+            voice.mStreamFrames += decoded;
+
+            if (decoded > 0)
+            {
+                rewound = false;
+            }
+            else if (voice.mLoop && !rewound && AUD_SeekVorbisStream(voice.mStream, 0))
+            {
+                // Looping streams rewind the decoder and keep appending to the window,
+                // so the loop point is sample accurate with no gap.
+                rewound = true;
+            }
+            else
+            {
+                voice.mStreamEnded = true;
+            }
+        }
+
+        if (voice.mStreamFrames == 0)
+            break;
+
+        MixVoice(voice, voice.mStreamBuffer, voice.mStreamFrames, false, dst + dstFrame * 2, numFrames);
+        dstFrame += numFrames;
+
+        if (voice.mStreamEnded &&
+            voice.mCurFrame >= voice.mStreamFrames)
+        {
+            break;
+        }
+    }
+}
+
+static void ConvertAccumToPcm(const float* src, int16_t* dst, int32_t numSamples)
+{
+    int32_t i = 0;
+
+#if AUDIO_MIX_SSE
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        // cvtps rounds to nearest and packs saturates to [-32768, 32767]
+        __m128i a = _mm_cvtps_epi32(_mm_loadu_ps(src + i));
+        __m128i b = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 4));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+    }
+#endif
+
+    // lrintf() rounds to nearest like cvtps, so the tail matches the SSE path.
+    for (; i < numSamples; ++i)
+    {
+        dst[i] = (int16_t)lrintf(glm::clamp(src[i], -32768.0f, 32767.0f));
+    }
+}
+
+static void FinishVoice(uint32_t voiceIndex)
+{
+    // Let the main thread know this sound has finished.
+    SoundVoice& voice = sVoices[voiceIndex];
+    voice.mActive = false;
+    voice.mSrcBuffer = nullptr;
+    AUD_DestroyVorbisStream(voice.mStream);
+    voice.mStream = nullptr;
+    sVoiceFinishedIds[voiceIndex].store(voice.mPlayId, std::memory_order_release);
+}
+
+static void MixFrames(int16_t* dst, int32_t frames)
+{
+    ProcessAudioCommands();
+
+    memset(sAccumBuffer, 0, frames * 2 * sizeof(float));
+
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        SoundVoice& voice = sVoices[i];
+
+        if (voice.mActive)
+        {
+            bool finished = false;
+
+            if (voice.mStream != nullptr)
+            {
+                MixStreamingVoice(voice, sAccumBuffer, frames);
+                finished = (voice.mStreamEnded && voice.mCurFrame >= voice.mStreamFrames);
+            }
+            else
+            {
+                MixVoice(voice, voice.mSrcBuffer, voice.mSrcFrames, voice.mLoop, sAccumBuffer, frames);
+                finished = (!voice.mLoop && voice.mCurFrame >= voice.mSrcFrames);
+            }
+
+            if (finished)
+            {
+                FinishVoice(i);
+            }
+        }
+    }
+
+    ConvertAccumToPcm(sAccumBuffer, dst, frames * 2);
+}
+
+// Headless without anyone calling AUD_MixHeadless(). Nothing is mixed, but voices still need to
+// progress so one-shot sounds finish and their voices get freed (e.g. on a dedicated server).
+static void AdvanceVoices(double seconds)
+{
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        SoundVoice& voice = sVoices[i];
+
+        if (!voice.mActive || voice.mLoop)
+            continue;
+
+        // Streaming voices are never decoded here, mSrcFrames holds the frames left to play.
+        voice.mCurFrame += seconds * voice.mPitch * voice.mSampleRate;
+
+        if (voice.mCurFrame >= voice.mSrcFrames)
+        {
+            FinishVoice(i);
+        }
+    }
+}
+
+static ThreadFuncRet MixThreadFunc(void* arg)
+{
+    // Real-time priority keeps the mixer from getting starved by the game.
+    // This usually requires extra privileges, so failing is not an error.
+    sched_param schedParam = {};
+    schedParam.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &schedParam) != 0)
+    {
+        LogDebug("Audio mix thread running without real-time priority.");
+    }
+
+    int32_t maxFrames = int32_t(sMixBufferLen) / 4;
+
+    while (sMixThreadRunning)
+    {
+        snd_pcm_wait(sSoundDevice, AUDIO_MIX_THREAD_WAIT_MS);
+
+        int32_t frames = (int32_t) snd_pcm_avail(sSoundDevice);
+
+        if (frames < 0)
+        {
+            //LogWarning("Audio buffer underrun.");
+            snd_pcm_prepare(sSoundDevice);
+            continue;
+        }
+
+        frames = glm::min(maxFrames, frames);
+
+        if (frames == 0)
+        {
+            // Still pick up commands so stopped voices release their wave buffers promptly.
+            ProcessAudioCommands();
+            continue;
+        }
+
+        MixFrames(sMixBuffer, frames);
+
+        snd_pcm_sframes_t framesWritten = snd_pcm_writei(sSoundDevice, sMixBuffer, frames);
+
+        if (framesWritten == -EPIPE)
+        {
+            snd_pcm_prepare(sSoundDevice);
+        }
+        else if (framesWritten < 0)
+        {
+            LogError("Can't write to PCM device. %s", snd_strerror(framesWritten));
+            snd_pcm_recover(sSoundDevice, (int)framesWritten, 1);
+        }
+    }
+
+    THREAD_RETURN();
+}
+
+static void AllocateMixBuffers(uint32_t frames)
+{
+    sMixBufferLen = frames * 4; // ( 2 samples (L/R) * 2 bytes per sample)
+    sMixBuffer = new int16_t[sMixBufferLen / 2];
+    memset(sMixBuffer, 0, sMixBufferLen);
+    sAccumBuffer = (float*)SYS_AlignedMalloc(frames * 2 * sizeof(float), 16);
+}
+
+static bool OpenSoundDevice()
 {
     int err = snd_pcm_open( &sSoundDevice, "default", SND_PCM_STREAM_PLAYBACK, 0 );
     snd_pcm_hw_params_t* hw_params = nullptr;
@@ -41,8 +616,8 @@ void AUD_Initialize()
     if( err < 0 )
     {
         LogError("Cannot open audio device");
-        OCT_ASSERT(0);
-        return;
+        sSoundDevice = nullptr;
+        return false;
     }
     else
     {
@@ -53,18 +628,19 @@ void AUD_Initialize()
     {
         LogError("Failed to allocate hardware params");
         OCT_ASSERT(0);
-        return;
+        return false;
     }
 
     if ((err = snd_pcm_hw_params_any(sSoundDevice, hw_params)) < 0)
     {
         LogError("Failed to initialize hardware params");
         OCT_ASSERT(0);
-        return;
+        return false;
     }
 
-    // Create enough buffer room for a 30 fps update rate.
-    sPlaybackFrames = snd_pcm_uframes_t((1 / 15.0f) * 44100);
+    // The mix thread refills the buffer as soon as there is room, so this only needs
+    // to cover the thread's worst case wake up latency rather than a whole game frame.
+    sPlaybackFrames = snd_pcm_uframes_t((1 / 15.0f) * AUDIO_OUTPUT_RATE);
 
     err = snd_pcm_hw_params_set_rate_resample(sSoundDevice, hw_params, 1);
     err = snd_pcm_hw_params_set_access(sSoundDevice, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
@@ -72,7 +648,7 @@ void AUD_Initialize()
     err = snd_pcm_hw_params_set_channels(sSoundDevice, hw_params, 2);
     err = snd_pcm_hw_params_set_buffer_size(sSoundDevice, hw_params, sPlaybackFrames);
 
-    unsigned int playbackRate = 44100;
+    unsigned int playbackRate = AUDIO_OUTPUT_RATE;
     err = snd_pcm_hw_params_set_rate_near(sSoundDevice, hw_params, &playbackRate, 0);
 
     err = snd_pcm_hw_params(sSoundDevice, hw_params);
@@ -90,159 +666,122 @@ void AUD_Initialize()
     snd_pcm_hw_params_free(hw_params);
     err = snd_pcm_prepare(sSoundDevice);
 
-    sMixBufferLen = sPlaybackFrames * 4; // ( 2 samples (L/R) * 2 bytes per sample)
-    sMixBuffer = new int16_t[sMixBufferLen / 2];
-    memset(sMixBuffer, 0, sMixBufferLen);
-    snd_pcm_writei(sSoundDevice, sMixBuffer, sPlaybackFrames);
-    //snd_pcm_start(sSoundDevice);
-
     LogDebug("PCM name: '%s'", snd_pcm_name(sSoundDevice));
     LogDebug("PCM state: %s", snd_pcm_state_name(snd_pcm_state(sSoundDevice)));
+
+    return true;
 }
 
-void AUD_Shutdown()
+void AUD_SetHeadless(bool headless)
 {
-    delete [] sMixBuffer;
-    sMixBuffer = nullptr;
+    OCT_ASSERT(sMixBuffer == nullptr);
+    sHeadless = headless;
+}
 
-    if (sSoundDevice != nullptr)
+bool AUD_IsHeadless()
+{
+    return sHeadless;
+}
+
+uint32_t AUD_MixHeadless(int16_t* outBuffer, uint32_t numFrames)
+{
+    OCT_ASSERT(sHeadless);
+    sHeadlessMixed = true;
+    uint32_t maxFrames = sMixBufferLen / 4;
+    uint32_t framesMixed = 0;
+
+    while (framesMixed < numFrames)
     {
-        snd_pcm_close(sSoundDevice);
+        uint32_t frames = glm::min(maxFrames, numFrames - framesMixed);
+        MixFrames(outBuffer + framesMixed * 2, (int32_t)frames);
+        framesMixed += frames;
     }
+
+    return framesMixed;
 }
 
-void AUD_Update()
-{   
-    int32_t frames = (int32_t) snd_pcm_avail(sSoundDevice);
-    frames = glm::min(int32_t(sMixBufferLen) / 4, frames);
+void AUD_Initialize()
+{
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        sVoiceFinishedIds[i] = 0;
 
-    //LogDebug("Frames to mix: %d", frames);
-    //LogDebug("PCM state: %s", snd_pcm_state_name(snd_pcm_state(sSoundDevice)));
+        // Stream windows are allocated up front so the mix thread never allocates them.
+        sVoices[i].mStreamBuffer = (uint8_t*)SYS_AlignedMalloc(AUDIO_STREAM_BUFFER_FRAMES * 4, 16);
+    }
 
-    if (frames > 0)
+    if (!sHeadless && !OpenSoundDevice())
     {
-        // We need to mix an audio buffer
-        //OCT_ASSERT(frames * 4  <= int32_t(sMixBufferLen));
-        memset(sMixBuffer, 0, frames * 4);
+        LogWarning("Falling back to headless audio.");
+        sHeadless = true;
+    }
 
-        for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
-        {
-            if (sVoices[i].mActive)
-            {
-                SoundVoice& voice = sVoices[i];
-                OCT_ASSERT(voice.mSrcFrames > 0);
+    if (sHeadless)
+    {
+        // Mix in small fixed blocks so results don't depend on the caller's request size.
+        AllocateMixBuffers(1024);
+        return;
+    }
 
-                // If the voice is active, that means we need to mix *frames* number of frames
-                // into the mix buffer. The src voice may move at a faster or slower pace based on the 
-                // pitch value, so we will need to interpolate between frames.
+    AllocateMixBuffers((uint32_t)sPlaybackFrames);
+    snd_pcm_writei(sSoundDevice, sMixBuffer, sPlaybackFrames);
 
-                // TODO: Handle pitch
-                float srcDeltaFrame = 1 * voice.mPitch * (voice.mSampleRate / 44100.0f);
+    sMixThreadRunning = true;
+    sMixThread = SYS_CreateThread(MixThreadFunc, nullptr);
+}
 
-                for (int32_t dstFrame = 0; dstFrame < frames; ++dstFrame)
-                {
-                    float srcFrameFloat = voice.mCurFrame + (dstFrame * srcDeltaFrame);
-
-                    int32_t srcFrames[2] = { int32_t(srcFrameFloat), int32_t(srcFrameFloat) + 1 };
-                    float frameInterpAlpha = fmod(srcFrameFloat, 1.0f);
-
-                    int16_t srcSampleL[2] = { 0, 0 };
-                    int16_t srcSampleR[2] = { 0, 0 };
-
-                    if (voice.mLoop)
-                    {
-                        if (srcFrames[0] >= int32_t(voice.mSrcFrames))
-                            srcFrames[0] = srcFrames[0] % voice.mSrcFrames;
-                        if (srcFrames[1] >= int32_t(voice.mSrcFrames))
-                            srcFrames[1] = srcFrames[1] % voice.mSrcFrames;
-                    }
-
-                    // Interpolate between the two src frames
-                    for (int32_t f = 0; f < 2; ++f)
-                    {
-                        int32_t frameIndex = srcFrames[f];
-
-                        if (frameIndex >= int32_t(voice.mSrcFrames))
-                        {
-                            srcSampleL[f] = 0;
-                            srcSampleR[f] = 0;
-                        }
-                        else if (voice.mNumChannels == 1)
-                        {
-                            // Use same src sample for left and right dst samples
-
-                            if (voice.mBytesPerSample == 1)
-                            {
-                                // uint8 samples
-                                // Convert from uint8_t to int16_t
-                                srcSampleL[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 1 * 1)));
-                                srcSampleL[f] = srcSampleL[f] * 256 - 32767;
-                                srcSampleR[f] = srcSampleL[f];   
-                            }
-                            else
-                            {
-                                // int16 samples
-                                srcSampleL[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 1 * 2)));
-                                srcSampleR[f] = srcSampleL[f];
-                            }
-                        }
-                        else
-                        {
-                            if (voice.mBytesPerSample == 1)
-                            {
-                                // uint8 samples
-                                srcSampleL[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 2 * 1)));
-                                srcSampleR[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 2 * 1 + 1)));
-                                srcSampleL[f] = srcSampleL[f] * 256 - 32767;
-                                srcSampleR[f] = srcSampleR[f] * 256 - 32767;
-                            }
-                            else
-                            {
-                                // int16 samples
-                                srcSampleL[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 2 * 2)));
-                                srcSampleR[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 2 * 2 + 2)));
-                            }
-                        }
-                    }
-
-                    // We have four samples now, so now we need to linearly interpolate between the left and right channels
-                    // to get a final 2 samples that we will accumulate into the mix buffer.
-                    int32_t finalSampleL = (int32_t)glm::mix(srcSampleL[0], srcSampleL[1], frameInterpAlpha);
-                    int32_t finalSampleR = (int32_t)glm::mix(srcSampleR[0], srcSampleR[1], frameInterpAlpha);
-                    finalSampleL = int32_t(finalSampleL * voice.mVolumeL);
-                    finalSampleR = int32_t(finalSampleR * voice.mVolumeR);
-                    finalSampleL = glm::clamp(finalSampleL + (int32_t)sMixBuffer[dstFrame * 2 + 0], -32768, 32767);
-                    finalSampleR = glm::clamp(finalSampleR + (int32_t)sMixBuffer[dstFrame * 2 + 1], -32768, 32767);
-                    sMixBuffer[dstFrame * 2 + 0] = (int16_t)finalSampleL;
-                    sMixBuffer[dstFrame * 2 + 1] = (int16_t)finalSampleR;
-                }
+void AUD_Shutdown()
+{
+    if (sMixThread != nullptr)
+    {
+        sMixThreadRunning = false;
+        SYS_JoinThread(sMixThread);
+        SYS_DestroyThread(sMixThread);
+        sMixThread = nullptr;
+    }
 
-                // We've finished getting all of the samples for this voice. Increase the current sample value
-                // to keep track of where to pick up next frame. If the sound is looping we need to mod the frame value
-                // otherwise let the curFrame exceed the *voice.mSrcFrames* count so we can determine that it is finished playing.
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        AUD_DestroyVorbisStream(sVoices[i].mStream);
+        sVoices[i].mStream = nullptr;
+        sVoices[i].mActive = false;
 
-                voice.mCurFrame += (frames * srcDeltaFrame);
+        SYS_AlignedFree(sVoices[i].mStreamBuffer);
+        sVoices[i].mStreamBuffer = nullptr;
+    }
 
-                if (voice.mLoop)
-                {
-                    voice.mCurFrame = fmod(voice.mCurFrame, (float) voice.mSrcFrames);
-                }
-            }
-        }
+    delete [] sMixBuffer;
+    sMixBuffer = nullptr;
+
+    if (sAccumBuffer != nullptr)
+    {
+        SYS_AlignedFree(sAccumBuffer);
+        sAccumBuffer = nullptr;
     }
 
-    snd_pcm_sframes_t framesWritten = 0;
-    // We've generated the frames we need for this update, so now we just need to sent it to the audio driver.
-    if (frames < 0 ||
-        (frames > 0 && (framesWritten = snd_pcm_writei(sSoundDevice, sMixBuffer, frames)) == -EPIPE))
+    if (sSoundDevice != nullptr)
     {
-        //LogWarning("Audio buffer underrun.");
-        snd_pcm_prepare(sSoundDevice);
-    } 
-    else if (framesWritten < 0)
+        snd_pcm_close(sSoundDevice);
+        sSoundDevice = nullptr;
+    }
+}
+
+void AUD_Update()
+{
+    // Mixing happens on the mix thread (or in AUD_MixHeadless()).
+    // In headless mode we still want to apply commands so voice state stays in sync.
+    if (sHeadless)
     {
-        LogError("Can't write to PCM device. %s", snd_strerror(framesWritten));
-        return;
+        ProcessAudioCommands();
+
+        uint64_t time = SYS_GetTimeMicroseconds();
+
+        if (!sHeadlessMixed && sLastUpdateTime != 0)
+        {
+            AdvanceVoices((time - sLastUpdateTime) / 1000000.0);
+        }
+
+        sLastUpdateTime = time;
     }
 }
 
@@ -255,48 +794,108 @@ void AUD_Play(
     float startTime,
     bool spatial)
 {
-    OCT_ASSERT(!sVoices[voiceIndex].mActive);
-
-    sVoices[voiceIndex].mActive = true;
-    sVoices[voiceIndex].mBytesPerSample = soundWave->GetBitsPerSample() / 8;
-    sVoices[voiceIndex].mCurFrame = 0.0f;
-    sVoices[voiceIndex].mLoop = loop;
-    sVoices[voiceIndex].mNumChannels = soundWave->GetNumChannels();
-    sVoices[voiceIndex].mPitch = pitch;
-    sVoices[voiceIndex].mSampleRate = soundWave->GetSampleRate();
-    sVoices[voiceIndex].mSrcBuffer = soundWave->GetWaveData();
-    sVoices[voiceIndex].mSrcBufferLen = soundWave->GetWaveDataSize();
-    sVoices[voiceIndex].mVolumeL = spatial ? 0.0f : volume;
-    sVoices[voiceIndex].mVolumeR = spatial ? 0.0f : volume;
-    
-    int32_t bytesPerFrame = sVoices[voiceIndex].mBytesPerSample * sVoices[voiceIndex].mNumChannels;
-    sVoices[voiceIndex].mSrcFrames = sVoices[voiceIndex].mSrcBufferLen / bytesPerFrame;
-
-    OCT_ASSERT(sVoices[voiceIndex].mSrcBufferLen % bytesPerFrame == 0);
+    OCT_ASSERT(!sVoiceStates[voiceIndex].mActive);
+
+    uint32_t bytesPerSample = soundWave->GetBitsPerSample() / 8;
+    uint32_t numChannels = soundWave->GetNumChannels();
+    uint32_t bytesPerFrame = bytesPerSample * numChannels;
+
     OCT_ASSERT(bytesPerFrame > 0 &&
            bytesPerFrame <= 4);
+    OCT_ASSERT(soundWave->GetWaveDataSize() % bytesPerFrame == 0);
+
+    uint32_t srcFrames = soundWave->GetWaveDataSize() / bytesPerFrame;
+    VorbisStream* stream = nullptr;
+
+    if (soundWave->IsStreaming())
+    {
+        PcmFormat format;
+        format.mNumChannels = numChannels;
+        format.mBytesPerSample = bytesPerSample;
+        format.mSampleRate = soundWave->GetSampleRate();
+
+        // The decoder is set up here so the mix thread only has to decode.
+        stream = AUD_CreateVorbisStream(soundWave->GetCompressedData(), soundWave->GetCompressedSize(), format);
+
+        if (stream == nullptr)
+            return;
+
+        uint32_t startFrame = 0;
+
+        if (startTime > 0.0f)
+        {
+            startFrame = uint32_t(startTime * format.mSampleRate);
+            AUD_SeekVorbisStream(stream, startFrame);
+        }
+
+        // The mixer finds the end of a stream by decoding it. This length is only used by headless AdvanceVoices().
+        uint32_t totalFrames = soundWave->GetNumSamples() / numChannels;
+        srcFrames = (totalFrames > startFrame) ? (totalFrames - startFrame) : 0;
+    }
+    else if (srcFrames == 0)
+    {
+        return;
+    }
+
+    VoiceState& state = sVoiceStates[voiceIndex];
+    state.mActive = true;
+    state.mPlayId++;
+
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::Play;
+    cmd.mVoice = (uint8_t)voiceIndex;
+    cmd.mPlayId = state.mPlayId;
+    cmd.mSrcBuffer = soundWave->GetWaveData();
+    cmd.mSrcFrames = srcFrames;
+    cmd.mStream = stream;
+    cmd.mNumChannels = numChannels;
+    cmd.mBytesPerSample = bytesPerSample;
+    cmd.mSampleRate = soundWave->GetSampleRate();
+    cmd.mVolumeL = spatial ? 0.0f : volume;
+    cmd.mVolumeR = spatial ? 0.0f : volume;
+    cmd.mPitch = pitch;
+    cmd.mLoop = loop;
+    cmd.mStartTime = startTime;
+    PushAudioCommand(cmd);
 }
 
 void AUD_Stop(uint32_t voiceIndex)
 {
-    sVoices[voiceIndex].mActive = false;
+    if (!sVoiceStates[voiceIndex].mActive)
+        return;
+
+    sVoiceStates[voiceIndex].mActive = false;
+
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::Stop;
+    cmd.mVoice = (uint8_t)voiceIndex;
+    PushAudioCommand(cmd);
 }
 
 bool AUD_IsPlaying(uint32_t voiceIndex)
 {
-    return sVoices[voiceIndex].mActive &&
-           sVoices[voiceIndex].mCurFrame < sVoices[voiceIndex].mSrcFrames;
+    const VoiceState& state = sVoiceStates[voiceIndex];
+    return state.mActive &&
+           sVoiceFinishedIds[voiceIndex].load(std::memory_order_acquire) != state.mPlayId;
 }
 
 void AUD_SetVolume(uint32_t voiceIndex, float leftVolume, float rightVolume)
 {
-    sVoices[voiceIndex].mVolumeL = leftVolume;
-    sVoices[voiceIndex].mVolumeR = rightVolume;
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::SetVolume;
+    cmd.mVoice = (uint8_t)voiceIndex;
+    cmd.mVolumeL = leftVolume;
+    cmd.mVolumeR = rightVolume;
+    PushAudioCommand(cmd);
 }
 
 void AUD_SetPitch(uint32_t voiceIndex, float pitch)
 {
-    sVoices[voiceIndex].mPitch = pitch;
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::SetPitch;
+    cmd.mVoice = (uint8_t)voiceIndex;
+    cmd.mPitch = pitch;
+    PushAudioCommand(cmd);
 }
 
 uint8_t* AUD_AllocWaveBuffer(uint32_t size)
@@ -306,6 +905,8 @@ uint8_t* AUD_AllocWaveBuffer(uint32_t size)
 
 void AUD_FreeWaveBuffer(void* buffer)
 {
+    // Make sure the mixer has seen any Stop for voices that were reading this buffer.
+    FlushAudioCommands();
     SYS_AlignedFree(buffer);
 }
 
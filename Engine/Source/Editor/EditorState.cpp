@@ -16,6 +16,7 @@
 #include "Grid.h"
 #include "World.h"
 #include "ScriptUtils.h"
+#include "ScriptScheduler.h"
 #include "NetworkManager.h"
 #include "AssetDir.h"
 #include "TimerManager.h"
@@ -573,6 +574,7 @@ void EditorState::EndPlayInEditor()
 
     GetWorld(0)->DestroyRootNode();
     GetTimerManager()->ClearAllTimers();
+    ScriptScheduler::StopAllCoroutines();
 
     AudioManager::StopAllSounds();
 
@@ -9,13 +9,17 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
 
 class Stream;
 class Property;
 class AssetDir;
 
 #define ASSET_MAGIC_NUMBER 0x4f435421
-#define ASSET_CURRENT_VERSION 1
+#define ASSET_CURRENT_VERSION 2
+
+#define ASSET_VERSION_BASE 1
+#define ASSET_VERSION_SOUNDWAVE_STREAM 2
 
 #define DECLARE_ASSET(Base, Parent) DECLARE_FACTORY(Base, Asset); DECLARE_RTTI(Base, Parent);
 #define DEFINE_ASSET(Base) DEFINE_FACTORY(Base, Asset); DEFINE_RTTI(Base);
@@ -133,7 +137,7 @@ protected:
     bool mTransient = false;
 
     std::string mName = "Asset";
-    int32_t mRefCount = 0;
+    std::atomic<int32_t> mRefCount{ 0 }; // Async loads take refs from worker threads
 
 #if OCT_SCENE_CONVERSION
     TypeId mOldType = INVALID_TYPE_ID;
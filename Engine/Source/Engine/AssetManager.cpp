@@ -26,11 +26,23 @@
 #include <string>
 #include <functional>
 
+#if (PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_ANDROID)
+#include <thread>
+#endif
+
 #if EDITOR
 #include "Editor/EditorState.h"
 #endif
 
-#define ASYNC_REQUEUE_LIMIT 30
+#if (PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_ANDROID)
+#define ASYNC_LOAD_MAX_WORKERS 4
+#else
+#define ASYNC_LOAD_MAX_WORKERS 1
+#endif
+
+// Time spent finishing async loads (Asset::Create) on the main thread each frame.
+// At least one load is always finished per frame.
+#define ASYNC_LOAD_FINALIZE_BUDGET_US 2000
 
 AssetManager* AssetManager::sInstance = nullptr;
 
@@ -91,13 +103,30 @@ AssetManager::~AssetManager()
     Purge(true);
 
     SYS_LockMutex(mMutex);
-    // Flag that we are destructing so that the async load thread can exit.
+    // Flag that we are destructing so that the async load threads can exit.
     mDestructing = true;
+    SYS_BroadcastCondition(mLoadCondition);
     SYS_UnlockMutex(mMutex);
 
-    SYS_JoinThread(mAsyncLoadThread);
-    SYS_DestroyThread(mAsyncLoadThread);
-    mAsyncLoadThread = nullptr;
+    for (uint32_t i = 0; i < mAsyncLoadThreads.size(); ++i)
+    {
+        SYS_JoinThread(mAsyncLoadThreads[i]);
+        SYS_DestroyThread(mAsyncLoadThreads[i]);
+    }
+    mAsyncLoadThreads.clear();
+
+    // Discard any loads that never finished.
+    for (auto& pair : mLoadRequests)
+    {
+        delete pair.second->mAsset;
+        delete pair.second;
+    }
+    mLoadRequests.clear();
+    mBeginLoadQueue.clear();
+    mEndLoadQueue.clear();
+
+    SYS_DestroyCondition(mLoadCondition);
+    mLoadCondition = nullptr;
 
     SYS_DestroyMutex(mMutex);
     mMutex = nullptr;
@@ -108,7 +137,20 @@ void AssetManager::Initialize()
     mRootDirectory = new AssetDir("Root", "", nullptr);
 
     mMutex = SYS_CreateMutex();
-    mAsyncLoadThread = SYS_CreateThread(AsyncLoadThreadFunc, this);
+    mLoadCondition = SYS_CreateCondition();
+
+    uint32_t numWorkers = 1;
+#if (PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_ANDROID)
+    // Leave a core for the main thread.
+    uint32_t numCores = std::thread::hardware_concurrency();
+    numWorkers = (numCores > 1) ? (numCores - 1) : 1;
+#endif
+    numWorkers = glm::clamp<uint32_t>(numWorkers, 1, ASYNC_LOAD_MAX_WORKERS);
+
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        mAsyncLoadThreads.push_back(SYS_CreateThread(AsyncLoadThreadFunc, this));
+    }
 }
 
 void AssetManager::Update(float deltaTime)
@@ -770,7 +812,7 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
     if (targetRef != nullptr &&
         targetRef->mLoadRequest != nullptr)
     {
-        EraseAsyncLoadRef(*targetRef);
+        RemoveAsyncLoadRef(*targetRef);
     }
 
     // (2) Check to see if the asset is already loaded. If so, assign the target ref immediately.
@@ -784,27 +826,23 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
         return;
     }
 
-    // (3) Check to see if an AsyncLoadRequest is already in flight (in begin/end queues) and if so, add this ref to the list.
-    for (uint32_t i = 0; i < mBeginLoadQueue.size(); ++i)
+    // (3) Check to see if an AsyncLoadRequest is already in flight (queued, loading, or waiting on dependencies)
+    // and if so, add this ref to the list.
+    auto it = mLoadRequests.find(stub);
+    if (it != mLoadRequests.end())
     {
-        if (mBeginLoadQueue[i]->mName == name)
+        if (targetRef != nullptr)
         {
-            mBeginLoadQueue[i]->mTargetRefs.push_back(targetRef);
-            return;
+            it->second->mTargetRefs.push_back(targetRef);
+            targetRef->mLoadRequest = it->second;
         }
-    }
 
-    for (uint32_t i = 0; i < mEndLoadQueue.size(); ++i)
-    {
-        if (mEndLoadQueue[i]->mName == name)
-        {
-            mEndLoadQueue[i]->mTargetRefs.push_back(targetRef);
-            return;
-        }
+        return;
     }
     
     // (4) Otherwise, malloc and enqueue a new AsyncLoadRequest to the BeginLoadQueue
     AsyncLoadRequest* newRequest = new AsyncLoadRequest();
+    mLoadRequests.insert({ stub, newRequest });
     mBeginLoadQueue.push_back(newRequest);
 
     // (5) Set the data on the request, including the targetRef.
@@ -812,6 +850,7 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
     newRequest->mPath = stub->mPath;
     newRequest->mType = stub->mType;
     newRequest->mEmbeddedData = stub->mEmbeddedData;
+    newRequest->mStub = stub;
 
     if (targetRef != nullptr)
     {
@@ -820,6 +859,9 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
         // (6) Set the request pointer on the AssetRef.
         targetRef->mLoadRequest = newRequest;
     }
+
+    // (7) Wake up a loader thread.
+    SYS_SignalCondition(mLoadCondition);
 }
 
 void AssetManager::SaveAsset(const std::string& name)
@@ -913,25 +955,24 @@ bool AssetManager::UnloadAsset(AssetStub& stub)
 void AssetManager::EraseAsyncLoadRef(AssetRef& assetRef)
 {
     SCOPED_LOCK(mMutex);
+    RemoveAsyncLoadRef(assetRef);
+}
 
-    auto eraseRef = [](std::deque<AsyncLoadRequest*>& queue, AssetRef& ref)
+void AssetManager::RemoveAsyncLoadRef(AssetRef& assetRef)
+{
+    // Expects mMutex to be locked.
+    for (auto& pair : mLoadRequests)
     {
-        for (uint32_t i = 0; i < queue.size(); ++i)
-        {
-            std::vector<AssetRef*>& refs = queue[i]->mTargetRefs;
+        std::vector<AssetRef*>& refs = pair.second->mTargetRefs;
 
-            for (int32_t r = int32_t(refs.size()) - 1; r >= 0; --r)
+        for (int32_t r = int32_t(refs.size()) - 1; r >= 0; --r)
+        {
+            if (refs[r] == &assetRef)
             {
-                if (refs[r] == &ref)
-                {
-                    refs.erase(refs.begin() + r);
-                }
+                refs.erase(refs.begin() + r);
             }
         }
-    };
-
-    eraseRef(mBeginLoadQueue, assetRef);
-    eraseRef(mEndLoadQueue, assetRef);
+    }
 
     assetRef.mLoadRequest = nullptr;
 }
@@ -1082,19 +1123,24 @@ std::unordered_map<std::string, AssetStub*>& AssetManager::GetAssetMap()
 ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
 {
     AssetManager& am = *((AssetManager*)in);
-    bool exit = false;
 
-    while (!exit)
+    while (true)
     {
         AsyncLoadRequest* request = nullptr;
 
-        // Pop off the next request from the queue.
+        // Pop off the next request from the queue, sleeping until one arrives.
         SYS_LockMutex(am.mMutex);
+        while (!am.mDestructing && am.mBeginLoadQueue.size() == 0)
+        {
+            SYS_WaitCondition(am.mLoadCondition, am.mMutex);
+        }
+
         bool exit = am.mDestructing;
-        if (am.mBeginLoadQueue.size() > 0)
+        if (!exit)
         {
             request = am.mBeginLoadQueue.front();
             am.mBeginLoadQueue.pop_front();
+            am.mNumActiveLoads++;
         }
         SYS_UnlockMutex(am.mMutex);
 
@@ -1103,138 +1149,241 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
             break;
         }
 
-        if (request != nullptr)
+        // We have a request, so we need to
+        // (1) Create the Asset type
+        Asset* newAsset = Asset::CreateInstance(request->mType);
+        OCT_ASSERT(newAsset);
+
+        // (2) Load the file into a stream
+        // (3) Call asset->LoadStream()
+        // The call to Asset::Create() is made on the main thread, that's why we queue it up on the EndLoadQueue
+        if (request->mEmbeddedData != nullptr)
         {
-            // We have a request, so we need to
-            // (1) Create the Asset type
-            Asset* newAsset = Asset::CreateInstance(request->mType);
-            OCT_ASSERT(newAsset);
-
-            // (2) Load the file into a stream
-            // (3) Call asset->LoadStream()
-            // The call to Asset::Create() is made on the main thread, that's why we queue it up on the EndLoadQueue
-            if (request->mEmbeddedData != nullptr)
-            {
-                newAsset->LoadEmbedded(request->mEmbeddedData, request);
-            }
-            else
-            {
-                newAsset->LoadFile(request->mPath.c_str(), request);
-            }
+            newAsset->LoadEmbedded(request->mEmbeddedData, request);
+        }
+        else
+        {
+            newAsset->LoadFile(request->mPath.c_str(), request);
+        }
 
+        // (4) Hook the request into the dependency graph. It's added to the EndLoadQueue
+        // once every asset it references has finished loading.
+        {
+            SCOPED_LOCK(am.mMutex);
             request->mAsset = newAsset;
+            am.mNumActiveLoads--;
+            am.ScheduleLoadedRequest(request);
+        }
+    }
 
-            // (4) Add the request to the EndLoadQueue
-            {
-                SCOPED_LOCK(am.mMutex);
-                am.mEndLoadQueue.push_back(request);
-            }
+    THREAD_RETURN();
+}
+
+void AssetManager::ScheduleLoadedRequest(AsyncLoadRequest* request)
+{
+    // Expects mMutex to be locked.
+    for (uint32_t i = 0; i < request->mDependentAssets.size(); ++i)
+    {
+        AssetStub* depStub = request->mDependentAssets[i];
+
+        if (depStub->mAsset != nullptr)
+        {
+            continue;
         }
-        else
+
+        auto it = mLoadRequests.find(depStub);
+        if (it != mLoadRequests.end() &&
+            it->second != request)
         {
-            // If nothing to process then sleep, for a bit so we don't was cpu cycles checking.
-            SYS_Sleep(2);
+            it->second->mDependentRequests.push_back(request);
+            request->mNumPendingDependencies++;
         }
     }
 
-    THREAD_RETURN();
+    if (request->mNumPendingDependencies == 0)
+    {
+        mEndLoadQueue.push_back(request);
+    }
 }
 
-void AssetManager::UpdateEndLoadQueue()
+void AssetManager::BreakDependencyCycle()
 {
-    SCOPED_LOCK(mMutex);
+    // Expects mMutex to be locked.
+    // Nothing is queued or loading, yet requests remain. They can only be waiting on each other.
+    AsyncLoadRequest* forced = nullptr;
+
+    for (auto& pair : mLoadRequests)
+    {
+        if (pair.second->mNumPendingDependencies > 0)
+        {
+            forced = pair.second;
+            break;
+        }
+    }
 
-    const uint32_t maxIterations = 3;
-    uint32_t numIterations = 0;
+    if (forced == nullptr)
+        return;
 
-    bool handled = false;
+    LogWarning("Cyclical dependency detected while async loading %s. Forcing load.", forced->mName.c_str());
 
-    do
+    for (auto& pair : mLoadRequests)
     {
-        handled = false;
-        AsyncLoadRequest* loadRequest = (mEndLoadQueue.size() > 0) ? mEndLoadQueue.front() : nullptr;
+        std::vector<AsyncLoadRequest*>& dependents = pair.second->mDependentRequests;
 
-        if (mEndLoadQueue.size() > 0)
+        for (int32_t d = int32_t(dependents.size()) - 1; d >= 0; --d)
         {
-            mEndLoadQueue.pop_front();
+            if (dependents[d] == forced)
+            {
+                dependents.erase(dependents.begin() + d);
+            }
         }
+    }
 
-        if (loadRequest != nullptr)
+    forced->mNumPendingDependencies = 0;
+    mEndLoadQueue.push_back(forced);
+}
+
+void AssetManager::FinishLoadRequest(AsyncLoadRequest* loadRequest)
+{
+    OCT_ASSERT(loadRequest->mAsset != nullptr);
+
+    AssetStub* stub = GetAssetStub(loadRequest->mName);
+    bool create = false;
+
+    if (stub == nullptr)
+    {
+        LogError("Cannot find asset for async load request");
+    }
+    else if (stub->mAsset != nullptr)
+    {
+        LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
+    }
+    else
+    {
+        bool allDependenciesLoaded = true;
+
+        for (uint32_t i = 0; i < loadRequest->mDependentAssets.size(); ++i)
         {
-            numIterations++;
+            if (loadRequest->mDependentAssets[i]->mAsset == nullptr)
+            {
+                allDependenciesLoaded = false;
+                break;
+            }
+        }
 
-            // Check load dependencies before finish the load
-            bool allDependenciesLoaded = true;
+        if (allDependenciesLoaded)
+        {
+            create = true;
+        }
+        else
+        {
+            // Only happens when breaking a dependency cycle. Load synchronously so that
+            // the dependencies get loaded too, and discard the async copy.
+            LoadAsset(*stub);
+        }
+    }
+
+    if (create)
+    {
+        LogDebug("Finished Async Loading: %s", loadRequest->mName.c_str());
+
+        // Finish the load on the main thread. This can create GPU resources, so it's done without holding the mutex.
+        loadRequest->mAsset->Create();
+    }
+
+    Asset* discardedAsset = nullptr;
+
+    {
+        SCOPED_LOCK(mMutex);
 
-            for (uint32_t i = 0; i < loadRequest->mDependentAssets.size(); ++i)
+        if (create)
+        {
+            // Assign the stub's mAsset so that it is officially "Loaded"
+            stub->mAsset = loadRequest->mAsset;
+        }
+        else
+        {
+            discardedAsset = loadRequest->mAsset;
+            loadRequest->mAsset = nullptr;
+        }
+
+        Asset* loadedAsset = (stub != nullptr) ? stub->mAsset : nullptr;
+
+        // Now assign the asset to all of the refs that had requested the load
+        for (uint32_t i = 0; i < loadRequest->mTargetRefs.size(); ++i)
+        {
+            if (loadRequest->mTargetRefs[i] != nullptr)
             {
-                if (loadRequest->mDependentAssets[i]->mAsset == nullptr)
-                {
-                    allDependenciesLoaded = false;
-                    break;
-                }
+                // The load request of the target ref should match this load request but...
+                // We need to make sure we handle the case where an AssetRef is assigned twice to an async load
+                // before the first one finishes. Might mean Canceling the request if one already exists in AsyncLoadAsset()
+                OCT_ASSERT(loadRequest->mTargetRefs[i]->mLoadRequest == nullptr ||
+                    loadRequest->mTargetRefs[i]->mLoadRequest == loadRequest);
+
+                (*loadRequest->mTargetRefs[i]) = loadedAsset;
+                loadRequest->mTargetRefs[i]->mLoadRequest = nullptr;
             }
+        }
+
+        // Any request that was waiting on this one may now be ready to finish.
+        for (uint32_t i = 0; i < loadRequest->mDependentRequests.size(); ++i)
+        {
+            AsyncLoadRequest* dependent = loadRequest->mDependentRequests[i];
+            OCT_ASSERT(dependent->mNumPendingDependencies > 0);
+            dependent->mNumPendingDependencies--;
 
-            if (allDependenciesLoaded)
+            if (dependent->mNumPendingDependencies == 0)
             {
-                handled = true;
+                mEndLoadQueue.push_back(dependent);
+            }
+        }
 
-                AssetStub* stub = GetAssetStub(loadRequest->mName);
+        mLoadRequests.erase(loadRequest->mStub);
+        delete loadRequest;
+    }
 
-                if (stub == nullptr)
-                {
-                    LogError("Cannot find asset for async load request");
-                }
-                else if (stub->mAsset != nullptr)
-                {
-                    LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
-                }
-                else
-                {
-                    LogDebug("Finished Async Loading: %s", loadRequest->mName.c_str());
-
-                    // Finish the load on the main thread and assign the stub's mAsset so that it is officially "Loaded"
-                    OCT_ASSERT(loadRequest->mAsset != nullptr);
-                    loadRequest->mAsset->Create();
-                    stub->mAsset = loadRequest->mAsset;
-
-                    // Now assign the asset to all of the refs that had requested the load
-                    for (uint32_t i = 0; i < loadRequest->mTargetRefs.size(); ++i)
-                    {
-                        if (loadRequest->mTargetRefs[i] != nullptr)
-                        {
-                            // The load request of the target ref should match this load request but...
-                            // We need to make sure we handle the case where an AssetRef is assigned twice to an async load
-                            // before the first one finishes. Might mean Canceling the request if one already exists in AsyncLoadAsset()
-                            OCT_ASSERT(loadRequest->mTargetRefs[i]->mLoadRequest == nullptr ||
-                                loadRequest->mTargetRefs[i]->mLoadRequest == loadRequest);
-
-                            (*loadRequest->mTargetRefs[i]) = loadRequest->mAsset;
-                            loadRequest->mTargetRefs[i]->mLoadRequest = nullptr;
-                        }
-                    }
-                }
+    // Deleted outside of the lock because the asset's AssetRefs will call EraseAsyncLoadRef().
+    delete discardedAsset;
+}
 
-                delete loadRequest;
-                loadRequest = nullptr;
+void AssetManager::UpdateEndLoadQueue()
+{
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+
+    while (true)
+    {
+        AsyncLoadRequest* loadRequest = nullptr;
+
+        {
+            SCOPED_LOCK(mMutex);
+
+            if (mEndLoadQueue.size() == 0 &&
+                mBeginLoadQueue.size() == 0 &&
+                mNumActiveLoads == 0 &&
+                mLoadRequests.size() > 0)
+            {
+                BreakDependencyCycle();
             }
-            else
+
+            if (mEndLoadQueue.size() > 0)
             {
-                // Still waiting on some dependent assets, so push this on the back of the queue
-                // This might happen several times before the dependent assests make their way to the front
-                // of the mEndLoadQueue.
-                LogWarning("Async load for %s is still waiting on dependencies", loadRequest->mName.c_str());
-                mEndLoadQueue.push_back(loadRequest);
-                loadRequest->mRequeueCount++;
-
-                if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
-                {
-                    LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
-                    LoadAsset(loadRequest->mName);
-                }
+                loadRequest = mEndLoadQueue.front();
+                mEndLoadQueue.pop_front();
             }
         }
-    } while (handled && numIterations < maxIterations);
+
+        if (loadRequest == nullptr)
+        {
+            break;
+        }
+
+        FinishLoadRequest(loadRequest);
+
+        if (SYS_GetTimeMicroseconds() - startTime >= ASYNC_LOAD_FINALIZE_BUDGET_US)
+        {
+            break;
+        }
+    }
 }
 
 #if EDITOR
@@ -21,10 +21,12 @@ struct AsyncLoadRequest
     std::string mPath;
     std::vector<AssetRef*> mTargetRefs;
     std::vector<AssetStub*> mDependentAssets;
+    std::vector<AsyncLoadRequest*> mDependentRequests; // Requests that can't finish until this one does
     const EmbeddedFile* mEmbeddedData = nullptr;
+    AssetStub* mStub = nullptr;
     TypeId mType = INVALID_TYPE_ID;
     Asset* mAsset = nullptr;
-    int32_t mRequeueCount = 0;
+    uint32_t mNumPendingDependencies = 0;
 };
 
 Asset* FetchAsset(const std::string& name);
@@ -122,6 +124,10 @@ protected:
     AssetManager();
 
     void UpdateEndLoadQueue();
+    void ScheduleLoadedRequest(AsyncLoadRequest* request);
+    void FinishLoadRequest(AsyncLoadRequest* request);
+    void BreakDependencyCycle();
+    void RemoveAsyncLoadRef(AssetRef& assetRef);
 
     std::unordered_map<std::string, AssetStub*> mAssetMap;
     std::vector<Asset*> mTransientAssets;
@@ -130,8 +136,11 @@ protected:
     bool mDestructing = false;
     std::deque<AsyncLoadRequest*> mBeginLoadQueue;
     std::deque<AsyncLoadRequest*> mEndLoadQueue;
-    ThreadObject* mAsyncLoadThread = {};
+    std::unordered_map<AssetStub*, AsyncLoadRequest*> mLoadRequests;
+    std::vector<ThreadObject*> mAsyncLoadThreads;
     MutexObject* mMutex = {};
+    ConditionObject* mLoadCondition = {};
+    uint32_t mNumActiveLoads = 0;
 
 #if EDITOR
 public:
@@ -6,6 +6,7 @@
 #include "AudioManager.h"
 
 #include "Audio/Audio.h"
+#include "Audio/AudioConstants.h"
 #include "System/System.h"
 
 FORCE_LINK_DEF(SoundWave);
@@ -51,6 +52,11 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
     mCompress = stream.ReadBool();
     mCompressInternal = stream.ReadBool();
 
+    if (mVersion >= ASSET_VERSION_SOUNDWAVE_STREAM)
+    {
+        mStream = stream.ReadBool();
+    }
+
     // Waveform Format
     mNumChannels = stream.ReadUint32();
     mBitsPerSample = stream.ReadUint32();
@@ -65,24 +71,36 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
     {
         uint32_t compressedSize = stream.ReadUint32();
 
-#if EDITOR
-        // In Editor, we want to keep the compressed data around so in case we save the file again,
-        // we won't be recompressing the sound a second time (adding more artifacts / distortion).
-        mCompressedData = new uint8_t[compressedSize];
-        mCompressedSize = compressedSize;
-        memcpy(mCompressedData, stream.GetData() + stream.GetPos(), compressedSize);
-#endif
+        // Streaming sounds keep only the compressed data resident and the audio backend decodes
+        // it just ahead of playback. The editor always decodes fully since saving needs the PCM.
+        bool streaming = (mStream && AUDIO_STREAMING_SUPPORTED && !EDITOR);
 
-        Stream outStream;
-        PcmFormat format;
-        format.mBytesPerSample = (mBitsPerSample / 8);
-        format.mNumChannels = mNumChannels;
-        format.mSampleRate = mSampleRate;
-        AUD_DecodeVorbis(stream, outStream, format);
+        if (streaming || EDITOR)
+        {
+            // In Editor, we want to keep the compressed data around so in case we save the file again,
+            // we won't be recompressing the sound a second time (adding more artifacts / distortion).
+            mCompressedData = AUD_AllocWaveBuffer(compressedSize);
+            mCompressedSize = compressedSize;
+            memcpy(mCompressedData, stream.GetData() + stream.GetPos(), compressedSize);
+        }
 
-        mWaveDataSize = outStream.GetSize();
-        mWaveData = AUD_AllocWaveBuffer(mWaveDataSize);
-        memcpy(mWaveData, outStream.GetData(), mWaveDataSize);
+        if (streaming)
+        {
+            stream.SetPos(stream.GetPos() + compressedSize);
+        }
+        else
+        {
+            Stream outStream;
+            PcmFormat format;
+            format.mBytesPerSample = (mBitsPerSample / 8);
+            format.mNumChannels = mNumChannels;
+            format.mSampleRate = mSampleRate;
+            AUD_DecodeVorbis(stream, outStream, format);
+
+            mWaveDataSize = outStream.GetSize();
+            mWaveData = AUD_AllocWaveBuffer(mWaveDataSize);
+            memcpy(mWaveData, outStream.GetData(), mWaveDataSize);
+        }
     }
     else
     {
@@ -108,6 +126,7 @@ void SoundWave::SaveStream(Stream& stream, Platform platform)
     stream.WriteInt8(mAudioClass);
     stream.WriteBool(mCompress);
     stream.WriteBool(mCompressInternal);
+    stream.WriteBool(mStream);
 
     uint32_t numChannels = mNumChannels;
     uint32_t bitsPerSample = mBitsPerSample;
@@ -286,20 +305,24 @@ void SoundWave::Destroy()
 {
     Asset::Destroy();
 
-    if (mWaveData != nullptr)
+    if (mWaveData != nullptr || mCompressedData != nullptr)
     {
         AudioManager::StopSounds(this);
+    }
+
+    if (mWaveData != nullptr)
+    {
         AUD_FreeWaveBuffer(mWaveData);
         mWaveData = nullptr;
     }
 
     if (mCompressedData != nullptr)
     {
-#if !EDITOR
-        // We should only have compressed data in EDITOR.
-        OCT_ASSERT(0);
-#endif
-        delete mCompressedData;
+        // Outside of EDITOR, we only keep compressed data for streaming sounds.
+        OCT_ASSERT(EDITOR || mStream);
+        AUD_FreeWaveBuffer(mCompressedData);
+        mCompressedData = nullptr;
+        mCompressedSize = 0;
     }
 }
 
@@ -375,6 +398,7 @@ void SoundWave::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Byte, "Audio Class", this, &mAudioClass));
     outProps.push_back(Property(DatumType::Bool, "Compress", this, &mCompress));
     outProps.push_back(Property(DatumType::Bool, "Compress Internal", this, &mCompressInternal));
+    outProps.push_back(Property(DatumType::Bool, "Stream", this, &mStream));
 }
 
 glm::vec4 SoundWave::GetTypeColor()
@@ -435,6 +459,22 @@ float SoundWave::GetVolumeMultiplier() const
     return mVolumeMultiplier;
 }
 
+bool SoundWave::IsStreaming() const
+{
+    // Sounds are only streamed when no fully decoded PCM is available.
+    return (mStream && mWaveData == nullptr && mCompressedData != nullptr);
+}
+
+const uint8_t* SoundWave::GetCompressedData() const
+{
+    return mCompressedData;
+}
+
+uint32_t SoundWave::GetCompressedSize() const
+{
+    return mCompressedSize;
+}
+
 uint8_t* SoundWave::GetWaveData() const
 {
     return mWaveData;
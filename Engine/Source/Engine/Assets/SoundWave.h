@@ -32,6 +32,10 @@ public:
     void SetAudioClass(int8_t audioClass);
     int8_t GetAudioClass() const;
 
+    bool IsStreaming() const;
+    const uint8_t* GetCompressedData() const;
+    uint32_t GetCompressedSize() const;
+
     uint8_t* GetWaveData() const;
     uint32_t GetWaveDataSize() const;
     uint32_t GetNumChannels() const;
@@ -59,6 +63,7 @@ protected:
     int8_t mAudioClass = 0;
     bool mCompress = false;
     bool mCompressInternal = false;
+    bool mStream = false;
 
     // Soundwave Format
     uint32_t mNumChannels = 1;
@@ -353,8 +353,12 @@ void Texture::Create()
     // This pixel data is transferred to the GPU resource in GFX_CreateTextureResource(), so now 
     // we can clear the mPixels vector and shrink it so to free memory.
     // Keep copy of pixels when in editor so they can be saved without reading from the texture.
-    mPixels.clear();
-    mPixels.shrink_to_fit();
+    // Headless runs have no GPU resource, so the pixels stay as the only copy of the data.
+    if (!IsHeadless())
+    {
+        mPixels.clear();
+        mPixels.shrink_to_fit();
+    }
 #endif
 }
 
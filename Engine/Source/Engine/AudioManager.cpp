@@ -13,10 +13,26 @@
 #include "Audio/Audio.h"
 #include "Audio/AudioConstants.h"
 
+#include <unordered_map>
+#include <algorithm>
+
 // TODO: define max audio sources as AUDIO_MAX_VOICES
 #define MAX_AUDIO_SOURCES AUDIO_MAX_VOICES
 #define MAX_AUDIO_CLASSES 16
 
+// Audio3D nodes are bucketed into a 2D (XZ) grid by the extent of their outer radius,
+// so only emitters whose hearing range overlaps the listener's cell are evaluated each frame.
+#define AUDIO_GRID_CELL_SIZE 32.0f
+#define AUDIO_GRID_MAX_CELL_SPAN 8
+#define AUDIO_GRID_REFRESH_FRAMES 8
+#define AUDIO_GRID_MIN_REFRESH_COUNT 32
+
+// Component voices quieter than this are virtualized (play time keeps advancing, but nothing is mixed).
+#define AUDIO_INAUDIBLE_VOLUME 0.001f
+
+// A virtual emitter must be this much louder than a real voice of equal priority to take its place.
+#define AUDIO_VIRTUALIZE_HYSTERESIS 1.5f
+
 struct AudioClassData
 {
     float mVolume = 1.0f;
@@ -35,6 +51,7 @@ struct AudioSource
     float mOuterRadius;
     AttenuationFunc mAttenuationFunc;
     int8_t mAudioClass;
+    float mAudibility;
 
     AudioSource()
     {
@@ -63,6 +80,7 @@ struct AudioSource
         mOuterRadius = outerRadius;
         mAttenuationFunc = attenFunc;
         mAudioClass = glm::clamp<int8_t>(audioClass, 0, MAX_AUDIO_CLASSES - 1);
+        mAudibility = volumeMult;
     }
 
     void Reset()
@@ -77,6 +95,7 @@ struct AudioSource
         mOuterRadius = -1.0f;
         mAttenuationFunc = AttenuationFunc::Count;
         mAudioClass = 0;
+        mAudibility = 0.0f;
     }
 
     bool IsSpatial() const
@@ -85,11 +104,167 @@ struct AudioSource
     }
 };
 
+struct AudioEmitter
+{
+    Audio3D* mNode = nullptr;
+    glm::ivec2 mCellMin = { 0, 0 };
+    glm::ivec2 mCellMax = { -1, -1 };
+    bool mUnbounded = false;
+    bool mInGrid = false;
+};
+
+struct AudioCandidate
+{
+    Audio3D* mNode = nullptr;
+    glm::vec3 mPosition = { 0.0f, 0.0f, 0.0f };
+    float mAudibility = 0.0f;
+    int32_t mPriority = 0;
+};
+
 static AudioClassData sAudioClassData[MAX_AUDIO_CLASSES];
 static AudioSource sAudioSources[MAX_AUDIO_SOURCES];
 static float sMasterVolume = 1.0f;
 static float sMasterPitch = 1.0f;
 
+static std::vector<AudioEmitter> sAudioEmitters;
+static std::unordered_map<Audio3D*, uint32_t> sAudioEmitterMap;
+static std::unordered_map<uint64_t, std::vector<Audio3D*>> sAudioGrid;
+static std::vector<Audio3D*> sUnboundedEmitters;
+static std::vector<Audio3D*> sPendingEmitters;
+static std::vector<AudioCandidate> sAudioCandidates;
+static uint32_t sEmitterRefreshCursor = 0;
+
+static uint64_t GetAudioCellKey(int32_t x, int32_t z)
+{
+    return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(z));
+}
+
+static glm::ivec2 GetAudioCell(float x, float z)
+{
+    return glm::ivec2(
+        int32_t(glm::floor(x / AUDIO_GRID_CELL_SIZE)),
+        int32_t(glm::floor(z / AUDIO_GRID_CELL_SIZE)));
+}
+
+static void EraseEmitterFromList(std::vector<Audio3D*>& list, Audio3D* node)
+{
+    for (uint32_t i = 0; i < list.size(); ++i)
+    {
+        if (list[i] == node)
+        {
+            list[i] = list.back();
+            list.pop_back();
+            break;
+        }
+    }
+}
+
+static void RemoveEmitterFromGrid(AudioEmitter& emitter)
+{
+    if (!emitter.mInGrid)
+        return;
+
+    if (emitter.mUnbounded)
+    {
+        EraseEmitterFromList(sUnboundedEmitters, emitter.mNode);
+    }
+    else
+    {
+        for (int32_t x = emitter.mCellMin.x; x <= emitter.mCellMax.x; ++x)
+        {
+            for (int32_t z = emitter.mCellMin.y; z <= emitter.mCellMax.y; ++z)
+            {
+                auto it = sAudioGrid.find(GetAudioCellKey(x, z));
+                OCT_ASSERT(it != sAudioGrid.end());
+
+                EraseEmitterFromList(it->second, emitter.mNode);
+
+                if (it->second.empty())
+                {
+                    sAudioGrid.erase(it);
+                }
+            }
+        }
+    }
+
+    emitter.mInGrid = false;
+}
+
+static void RefreshEmitter(AudioEmitter& emitter)
+{
+    Audio3D* node = emitter.mNode;
+    glm::vec3 position = node->GetWorldPosition();
+    float radius = glm::max(0.0f, node->GetOuterRadius());
+
+    glm::ivec2 cellMin = GetAudioCell(position.x - radius, position.z - radius);
+    glm::ivec2 cellMax = GetAudioCell(position.x + radius, position.z + radius);
+    glm::ivec2 span = cellMax - cellMin;
+    bool unbounded = (span.x >= AUDIO_GRID_MAX_CELL_SPAN || span.y >= AUDIO_GRID_MAX_CELL_SPAN);
+
+    if (emitter.mInGrid &&
+        emitter.mUnbounded == unbounded &&
+        (unbounded || (emitter.mCellMin == cellMin && emitter.mCellMax == cellMax)))
+    {
+        // Still covers the same cells
+        return;
+    }
+
+    RemoveEmitterFromGrid(emitter);
+
+    emitter.mCellMin = cellMin;
+    emitter.mCellMax = cellMax;
+    emitter.mUnbounded = unbounded;
+    emitter.mInGrid = true;
+
+    if (unbounded)
+    {
+        // Emitters with huge hearing ranges (music, ambience beds) are always evaluated.
+        sUnboundedEmitters.push_back(node);
+    }
+    else
+    {
+        for (int32_t x = cellMin.x; x <= cellMax.x; ++x)
+        {
+            for (int32_t z = cellMin.y; z <= cellMax.y; ++z)
+            {
+                sAudioGrid[GetAudioCellKey(x, z)].push_back(node);
+            }
+        }
+    }
+}
+
+static void RefreshEmitters()
+{
+    // Newly registered nodes usually get positioned after being added to the world,
+    // so they are placed into the grid on the first update after registration.
+    for (uint32_t i = 0; i < sPendingEmitters.size(); ++i)
+    {
+        auto it = sAudioEmitterMap.find(sPendingEmitters[i]);
+        if (it != sAudioEmitterMap.end())
+        {
+            RefreshEmitter(sAudioEmitters[it->second]);
+        }
+    }
+    sPendingEmitters.clear();
+
+    // Emitters can move, so revalidate a slice of them every frame.
+    // A moving emitter can be picked up by the listener up to AUDIO_GRID_REFRESH_FRAMES late.
+    uint32_t numEmitters = uint32_t(sAudioEmitters.size());
+    uint32_t refreshCount = glm::max<uint32_t>(AUDIO_GRID_MIN_REFRESH_COUNT, numEmitters / AUDIO_GRID_REFRESH_FRAMES + 1);
+    refreshCount = glm::min(refreshCount, numEmitters);
+
+    for (uint32_t i = 0; i < refreshCount; ++i)
+    {
+        if (sEmitterRefreshCursor >= numEmitters)
+        {
+            sEmitterRefreshCursor = 0;
+        }
+
+        RefreshEmitter(sAudioEmitters[sEmitterRefreshCursor]);
+        ++sEmitterRefreshCursor;
+    }
+}
+
 float CalcVolumeAttenuation(AttenuationFunc func, float innerRadius, float outerRadius, float distance)
 {
     float ret = 1.0f;
@@ -226,34 +401,74 @@ void StopAudio(uint32_t sourceIndex)
     sAudioSources[sourceIndex].Reset();
 }
 
-uint32_t FindAvailableAudioSourceIndex(int32_t inPriority)
+uint32_t FindAvailableAudioSourceIndex(int32_t inPriority, float inAudibility = 0.0f)
 {
     uint32_t availableIndex = MAX_AUDIO_SOURCES;
-    int32_t lowestPriority = 0x7fffffff;
-    uint32_t lowestPriorityIndex = 0;
+    uint32_t weakestIndex = MAX_AUDIO_SOURCES;
 
     for (uint32_t i = 0; i < MAX_AUDIO_SOURCES; ++i)
     {
-        if (sAudioSources[i].mSoundWave.Get() == nullptr)
+        const AudioSource& source = sAudioSources[i];
+
+        if (source.mSoundWave.Get() == nullptr)
         {
             availableIndex = i;
             break;
         }
 
-        if (sAudioSources[i].mPriority < lowestPriority)
+        // The weakest source has the lowest priority. On ties, prefer sources that belong to
+        // a component (they are only virtualized, not lost), and then the quietest one.
+        if (weakestIndex == MAX_AUDIO_SOURCES)
+        {
+            weakestIndex = i;
+            continue;
+        }
+
+        const AudioSource& weakest = sAudioSources[weakestIndex];
+        bool isComp = (source.mComponent != nullptr);
+        bool weakestIsComp = (weakest.mComponent != nullptr);
+
+        if (source.mPriority != weakest.mPriority)
+        {
+            if (source.mPriority < weakest.mPriority)
+            {
+                weakestIndex = i;
+            }
+        }
+        else if (isComp != weakestIsComp)
         {
-            lowestPriority = sAudioSources[i].mPriority;
-            lowestPriorityIndex = i;
+            if (isComp)
+            {
+                weakestIndex = i;
+            }
+        }
+        else if (source.mAudibility < weakest.mAudibility)
+        {
+            weakestIndex = i;
         }
     }
 
-    // All sources are being used. But see if we can evict one with lower priority
+    // All sources are being used. But see if we can evict one with lower priority,
+    // or virtualize a component voice of equal priority that is much quieter.
     if (availableIndex == MAX_AUDIO_SOURCES &&
-        lowestPriority < inPriority)
+        weakestIndex < MAX_AUDIO_SOURCES)
     {
-        LogWarning("Evicting lower priority sound");
-        StopAudio(lowestPriorityIndex);
-        availableIndex = lowestPriorityIndex;
+        const AudioSource& weakest = sAudioSources[weakestIndex];
+        bool lowerPriority = weakest.mPriority < inPriority;
+        bool quieter = weakest.mPriority == inPriority &&
+            weakest.mComponent != nullptr &&
+            weakest.mAudibility * AUDIO_VIRTUALIZE_HYSTERESIS < inAudibility;
+
+        if (lowerPriority || quieter)
+        {
+            if (weakest.mComponent == nullptr)
+            {
+                LogWarning("Evicting lower priority sound");
+            }
+
+            StopAudio(weakestIndex);
+            availableIndex = weakestIndex;
+        }
     }
 
     return availableIndex;
@@ -266,22 +481,28 @@ void AudioManager::Initialize()
 
 void AudioManager::Shutdown()
 {
-
+    sAudioEmitters.clear();
+    sAudioEmitterMap.clear();
+    sAudioGrid.clear();
+    sUnboundedEmitters.clear();
+    sPendingEmitters.clear();
+    sAudioCandidates.clear();
+    sEmitterRefreshCursor = 0;
 }
 
 void AudioManager::Update(float deltaTime)
 {
     SCOPED_FRAME_STAT("Audio");
 
-    // TODO:
     // (1) -- Update Active Sources --
     //     Iterate through audio sources and update volume for any 3D sounds (including components)
     //     If an source has finished playing, Reset the source (and notify the component if applicable).
     //     Do not evict 3D sounds that are out of range. We want to hear them when we return.
-    //     Evict components if out of hearing range.
+    //     Virtualize components if out of hearing range or inaudible.
     // (2) -- Play New Sounds --
-    //     Iterate over Audio3D list. If any component is playing and in range, but has no audio source active,
-    //     then find an available audio source and Play(). Use component's mPlayTime var to start at correct time.
+    //     Query the emitter grid at the listener's cell. If any component is playing and in range, but has no
+    //     audio source active, then it is virtual. Sort these by priority and loudness and promote as many
+    //     as will fit. Use component's mPlayTime var to start at correct time.
 
 
     // (1) Update Active Sources
@@ -332,10 +553,10 @@ void AudioManager::Update(float deltaTime)
                 float dist = glm::distance(listenerPos, sAudioSources[i].mPosition);
 
                 if (sAudioSources[i].mComponent != nullptr && 
-                    dist > sAudioSources[i].mOuterRadius)
+                    (dist > sAudioSources[i].mOuterRadius || sAudioSources[i].mVolumeMult <= 0.0f))
                 {
                     // Sound is no longer in hearing range.
-                    // If this belongs to a component, StopAudio() the sound.
+                    // If this belongs to a component, StopAudio() the sound. It keeps playing virtually.
                     StopAudio(i);
                     stopped = true;
                 }
@@ -366,10 +587,20 @@ void AudioManager::Update(float deltaTime)
                         volLeft,
                         volRight);
 
+                    sAudioSources[i].mAudibility = glm::max(volLeft, volRight) * sAudioSources[i].mVolumeMult;
+
                     volLeft = volLeft * sAudioSources[i].mVolumeMult * soundWave->GetVolumeMultiplier() * classVolume * sMasterVolume;
                     volRight = volRight * sAudioSources[i].mVolumeMult * soundWave->GetVolumeMultiplier() * classVolume * sMasterVolume;
                     AUD_SetVolume(i, volLeft, volRight);
 #endif
+
+                    if (sAudioSources[i].mComponent != nullptr &&
+                        sAudioSources[i].mAudibility < AUDIO_INAUDIBLE_VOLUME)
+                    {
+                        // Too quiet to be worth a voice. Virtualize it until it gets louder.
+                        StopAudio(i);
+                        stopped = true;
+                    }
                 }
 
                 if (!stopped &&
@@ -389,19 +620,48 @@ void AudioManager::Update(float deltaTime)
     World* world = GetWorld(0);
     if (world != nullptr)
     {
-        const std::vector<Audio3D*>& audioNodes = world->GetAudios();
+        RefreshEmitters();
 
-        for (uint32_t i = 0; i < audioNodes.size(); ++i)
+        sAudioCandidates.clear();
+
+        glm::ivec2 listenerCell = GetAudioCell(listenerPos.x, listenerPos.z);
+        auto cellIt = sAudioGrid.find(GetAudioCellKey(listenerCell.x, listenerCell.y));
+        const std::vector<Audio3D*>* lists[2] =
+        {
+            (cellIt != sAudioGrid.end()) ? &cellIt->second : nullptr,
+            &sUnboundedEmitters
+        };
+
+        for (uint32_t l = 0; l < 2; ++l)
         {
-            Audio3D* node = audioNodes[i];
-
-            // In the case that the node is playing, but it is inaudible (not a current sound source)
-            // Then we need to check if it should be audible
-            if (node->IsPlaying() &&
-                !node->IsAudible() &&
-                node->GetVolume() > 0.0f &&
-                node->GetSoundWave() != nullptr)
+            if (lists[l] == nullptr)
+                continue;
+
+            const std::vector<Audio3D*>& audioNodes = *lists[l];
+
+            for (uint32_t i = 0; i < audioNodes.size(); ++i)
             {
+                Audio3D* node = audioNodes[i];
+
+                // In the case that the node is playing, but it is inaudible (not a current sound source)
+                // Then we need to check if it should be audible
+                if (!node->IsPlaying() ||
+                    node->IsAudible() ||
+                    node->GetVolume() <= 0.0f ||
+                    node->GetSoundWave() == nullptr)
+                {
+                    continue;
+                }
+
+                float soundDuration = node->GetSoundWave()->GetDuration();
+                if (!node->GetLoop() &&
+                    node->GetStartOffset() + node->GetPlayTime() >= soundDuration)
+                {
+                    // Finished playing while virtual.
+                    node->StopAudio();
+                    continue;
+                }
+
                 // We need to check the distance to the listener. Should it be audible?
                 glm::vec3 nodePosition = node->GetWorldPosition();
                 float dist = glm::distance(listenerPos, nodePosition);
@@ -409,35 +669,73 @@ void AudioManager::Update(float deltaTime)
 
                 if (dist < outerRadius)
                 {
-                    // It should be audible, so attempt to add it as a sound source.
-                    uint32_t sourceIndex = FindAvailableAudioSourceIndex(node->GetPriority());
+                    float audibility = node->GetVolume() * CalcVolumeAttenuation(
+                        node->GetAttenuationFunc(),
+                        node->GetInnerRadius(),
+                        outerRadius,
+                        dist);
 
-                    float soundDuration = node->GetSoundWave()->GetDuration();
-                    float startTime = glm::mod(node->GetStartOffset() + node->GetPlayTime(), soundDuration);
-                    if (startTime >= soundDuration)
+                    if (audibility >= AUDIO_INAUDIBLE_VOLUME)
                     {
-                        startTime = 0.0f;
+                        AudioCandidate candidate;
+                        candidate.mNode = node;
+                        candidate.mPosition = nodePosition;
+                        candidate.mAudibility = audibility;
+                        candidate.mPriority = node->GetPriority();
+                        sAudioCandidates.push_back(candidate);
                     }
+                }
+            }
+        }
 
-                    if (sourceIndex < MAX_AUDIO_SOURCES)
-                    {
-                        PlayAudio(
-                            sourceIndex,
-                            node->GetSoundWave(),
-                            node,
-                            node->GetVolume(),
-                            node->GetPitch(),
-                            node->GetPriority(),
-                            nodePosition,
-                            node->GetInnerRadius(),
-                            node->GetOuterRadius(),
-                            node->GetAttenuationFunc(),
-                            node->GetAudioClass(),
-                            node->GetLoop(),
-                            startTime);
-                    }
+        std::sort(sAudioCandidates.begin(), sAudioCandidates.end(),
+            [](const AudioCandidate& a, const AudioCandidate& b)
+            {
+                if (a.mPriority != b.mPriority)
+                {
+                    return a.mPriority > b.mPriority;
                 }
+
+                return a.mAudibility > b.mAudibility;
+            });
+
+        for (uint32_t i = 0; i < sAudioCandidates.size(); ++i)
+        {
+            const AudioCandidate& candidate = sAudioCandidates[i];
+            Audio3D* node = candidate.mNode;
+
+            // It should be audible, so attempt to add it as a sound source.
+            uint32_t sourceIndex = FindAvailableAudioSourceIndex(candidate.mPriority, candidate.mAudibility);
+
+            if (sourceIndex >= MAX_AUDIO_SOURCES)
+            {
+                // Candidates are sorted, so none of the remaining ones can take a voice either.
+                break;
+            }
+
+            float soundDuration = node->GetSoundWave()->GetDuration();
+            float startTime = glm::mod(node->GetStartOffset() + node->GetPlayTime(), soundDuration);
+            if (startTime >= soundDuration)
+            {
+                startTime = 0.0f;
             }
+
+            PlayAudio(
+                sourceIndex,
+                node->GetSoundWave(),
+                node,
+                node->GetVolume(),
+                node->GetPitch(),
+                node->GetPriority(),
+                candidate.mPosition,
+                node->GetInnerRadius(),
+                node->GetOuterRadius(),
+                node->GetAttenuationFunc(),
+                node->GetAudioClass(),
+                node->GetLoop(),
+                startTime);
+
+            sAudioSources[sourceIndex].mAudibility = candidate.mAudibility;
         }
     }
 }
@@ -540,6 +838,41 @@ void AudioManager::UpdateSound(
     }
 }
 
+void AudioManager::RegisterAudio3D(Audio3D* comp)
+{
+    OCT_ASSERT(sAudioEmitterMap.find(comp) == sAudioEmitterMap.end());
+
+    AudioEmitter emitter;
+    emitter.mNode = comp;
+
+    sAudioEmitterMap[comp] = uint32_t(sAudioEmitters.size());
+    sAudioEmitters.push_back(emitter);
+    sPendingEmitters.push_back(comp);
+}
+
+void AudioManager::UnregisterAudio3D(Audio3D* comp)
+{
+    auto it = sAudioEmitterMap.find(comp);
+    OCT_ASSERT(it != sAudioEmitterMap.end());
+
+    if (it != sAudioEmitterMap.end())
+    {
+        uint32_t index = it->second;
+        RemoveEmitterFromGrid(sAudioEmitters[index]);
+        sAudioEmitterMap.erase(it);
+
+        // Swap-remove, fixing up the index of the emitter that moved into the hole.
+        if (index != sAudioEmitters.size() - 1)
+        {
+            sAudioEmitters[index] = sAudioEmitters.back();
+            sAudioEmitterMap[sAudioEmitters[index].mNode] = index;
+        }
+
+        sAudioEmitters.pop_back();
+        EraseEmitterFromList(sPendingEmitters, comp);
+    }
+}
+
 void AudioManager::StopComponent(Audio3D* comp)
 {
     for (uint32_t i = 0; i < MAX_AUDIO_SOURCES; ++i)
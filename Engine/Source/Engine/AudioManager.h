@@ -40,6 +40,10 @@ public:
         bool loop = false,
         int32_t priority = 0);
 
+    // Audio3D nodes are tracked in a spatial grid so that only nearby emitters are considered for playback.
+    static void RegisterAudio3D(Audio3D* comp);
+    static void UnregisterAudio3D(Audio3D* comp);
+
     static void StopComponent(Audio3D* comp);
     static void StopSounds(SoundWave* soundWave);
     static void StopSound(const std::string& name);
@@ -42,6 +42,12 @@
 #define INVALID_HOST_ID 0
 #define SERVER_HOST_ID 1
 
+// Max reliable packets in flight per host. Must fit in the 32 bit selective ack field.
+#define OCT_RELIABLE_WINDOW_SIZE 32
+
+// Transform snapshots kept per interpolated node on clients.
+#define OCT_NET_SNAPSHOT_BUFFER_SIZE 8
+
 #define MAX_NET_FUNC_PARAMS 8
 
 #define OCT_SESSION_NAME_LEN 31
@@ -9,15 +9,19 @@
 #include "Assets/Scene.h"
 #include "AssetManager.h"
 #include "NetworkManager.h"
+#include "NetworkBenchmark.h"
 #include "AudioManager.h"
 #include "Constants.h"
 #include "Utilities.h"
 #include "Profiler.h"
+#include "ScriptProfiler.h"
+#include "ScriptScheduler.h"
 #include "Maths.h"
 #include "ScriptAutoReg.h"
 #include "ScriptFunc.h"
 #include "TimerManager.h"
 #include "Nodes/Widgets/TextField.h"
+#include "LuaBindings/Vector_Lua.h"
 
 #include "System/System.h"
 #include "Graphics/Graphics.h"
@@ -30,6 +34,7 @@
 #endif
 
 #define OCT_LUA_DEBUGGING (PLATFORM_WINDOWS)
+#define OCT_SCRIPT_HOT_RELOAD_INTERVAL_US 1000000
 
 #if OCT_LUA_DEBUGGING
 #include "LuaSocket/luasocket.h"
@@ -48,6 +53,12 @@ static EngineConfig sEngineConfig;
 
 static std::vector<World*> sWorlds;
 static Clock sClock;
+#if EDITOR
+static bool sScriptHotReload = true;
+#else
+static bool sScriptHotReload = false;
+#endif
+static uint64_t sLastScriptReloadCheck = 0;
 
 void ForceLinkage()
 {
@@ -140,6 +151,65 @@ void ReadCommandLineArgs(int32_t argc, char** argv)
             sEngineConfig.mValidateGraphics = (validate != 0);
             ++i;
         }
+        else if (strcmp(argv[i], "-netsim") == 0)
+        {
+            // -netsim <latencyMs> <jitterMs> <packetLoss>
+            OCT_ASSERT(i + 3 < argc);
+            sEngineConfig.mNetSim.mLatencyMs = (float)atof(argv[i + 1]);
+            sEngineConfig.mNetSim.mJitterMs = (float)atof(argv[i + 2]);
+            sEngineConfig.mNetSim.mPacketLoss = (float)atof(argv[i + 3]);
+            i += 3;
+        }
+        else if (strcmp(argv[i], "-netdup") == 0)
+        {
+            OCT_ASSERT(i + 1 < argc);
+            sEngineConfig.mNetSim.mDuplicate = (float)atof(argv[i + 1]);
+            ++i;
+        }
+        else if (strcmp(argv[i], "-netreorder") == 0)
+        {
+            OCT_ASSERT(i + 1 < argc);
+            sEngineConfig.mNetSim.mReorder = (float)atof(argv[i + 1]);
+            ++i;
+        }
+        else if (strcmp(argv[i], "-netseed") == 0)
+        {
+            OCT_ASSERT(i + 1 < argc);
+            sEngineConfig.mNetSim.mSeed = (uint32_t)strtoul(argv[i + 1], nullptr, 10);
+            ++i;
+        }
+        else if (strcmp(argv[i], "-netbench") == 0)
+        {
+            // -netbench <clients> <nodes> <ticks>
+            OCT_ASSERT(i + 3 < argc);
+            sEngineConfig.mNetBenchmark.mNumClients = (uint32_t)atoi(argv[i + 1]);
+            sEngineConfig.mNetBenchmark.mNumNodes = (uint32_t)atoi(argv[i + 2]);
+            sEngineConfig.mNetBenchmark.mNumTicks = (uint32_t)atoi(argv[i + 3]);
+            sEngineConfig.mRunNetBenchmark = true;
+            i += 3;
+        }
+        else if (strcmp(argv[i], "-headless") == 0)
+        {
+            sEngineConfig.mHeadless = true;
+        }
+        else if (strcmp(argv[i], "-server") == 0)
+        {
+            // Dedicated server: no window, GPU or audio device, and a LAN session is opened on startup.
+            sEngineConfig.mHeadless = true;
+            sEngineConfig.mDedicatedServer = true;
+        }
+        else if (strcmp(argv[i], "-port") == 0)
+        {
+            OCT_ASSERT(i + 1 < argc);
+            sEngineConfig.mServerPort = (uint16_t)atoi(argv[i + 1]);
+            ++i;
+        }
+        else if (strcmp(argv[i], "-tickrate") == 0)
+        {
+            OCT_ASSERT(i + 1 < argc);
+            sEngineConfig.mHeadlessTickRate = glm::clamp((float)atof(argv[i + 1]), 1.0f, 1000.0f);
+            ++i;
+        }
     }
 }
 
@@ -250,6 +320,12 @@ bool Initialize(InitOptions& initOptions)
     }
 #endif
 
+    if (sEngineConfig.mHeadless)
+    {
+        // No graphics device is created. The graphics backend treats every GFX_ call as a no-op.
+        LogDebug("Running headless");
+    }
+    else
     {
         SCOPED_STAT("GFX_Initialize");
         GFX_Initialize();
@@ -260,6 +336,9 @@ bool Initialize(InitOptions& initOptions)
     }
     {
         SCOPED_STAT("AUD_Initialize");
+#if PLATFORM_LINUX
+        AUD_SetHeadless(sEngineConfig.mHeadless);
+#endif
         AUD_Initialize();
     }
     {
@@ -269,6 +348,7 @@ bool Initialize(InitOptions& initOptions)
 
     renderer->Initialize();
     NetworkManager::Get()->Initialize();
+    NetworkManager::Get()->SetSimulatedConditions(sEngineConfig.mNetSim);
 
     sClock.Start();
 
@@ -302,6 +382,12 @@ bool Initialize(InitOptions& initOptions)
         InitAutoRegScripts();
         ScriptFunc::CreateRefTable();
 
+        ScriptUtils::InitGarbageCollector();
+        if (sEngineConfig.mHeadless)
+        {
+            ScriptUtils::SetGarbageCollectTargetFrameTime(1000.0f / sEngineConfig.mHeadlessTickRate);
+        }
+
 #if OCT_LUA_DEBUGGING
         ScriptUtils::RunScript("StartLuaPanda.lua");
 #endif
@@ -338,9 +424,22 @@ bool Update()
     }
 
     GetProfiler()->BeginFrame();
+    uint64_t frameStartTime = SYS_GetTimeMicroseconds();
 
     BEGIN_FRAME_STAT("Frame");
 
+#if LUA_ENABLED
+    // Scratch vectors from Vector.Temp() are only valid for one frame.
+    Vector_Lua::ResetTempPool();
+
+    if (sScriptHotReload &&
+        frameStartTime - sLastScriptReloadCheck >= OCT_SCRIPT_HOT_RELOAD_INTERVAL_US)
+    {
+        sLastScriptReloadCheck = frameStartTime;
+        ReloadModifiedScripts(false);
+    }
+#endif
+
     {
         SCOPED_FRAME_STAT("Audio");
         AUD_Update();
@@ -393,6 +492,7 @@ bool Update()
     sEngineState.mRealElapsedTime += realDeltaTime;
 
     GetTimerManager()->Update(gameDeltaTime);
+    ScriptScheduler::Update(gameDeltaTime);
 
     for (uint32_t i = 0; i < sWorlds.size(); ++i)
     {
@@ -407,6 +507,9 @@ bool Update()
     EditorImguiDraw();
 #endif
 
+    // Rendering waits on vsync / the GPU, so only count the CPU work before it against the GC budget.
+    uint64_t preRenderTime = SYS_GetTimeMicroseconds();
+
     for (int32_t i = 0; i < int32_t(sWorlds.size()); ++i)
     {
         Renderer::Get()->Render(sWorlds[i], i);
@@ -414,9 +517,18 @@ bool Update()
 
     AssetManager::Get()->Update(realDeltaTime);
 
+#if LUA_ENABLED
+    {
+        // Spend whatever is left of the frame on garbage collection.
+        SCOPED_FRAME_STAT("Lua GC");
+        ScriptUtils::StepGarbageCollector((preRenderTime - frameStartTime) / 1000.0f, realDeltaTime * 1000.0f);
+    }
+#endif
+
     END_FRAME_STAT("Frame");
 
     GetProfiler()->EndFrame();
+    ScriptProfiler::EndFrame(realDeltaTime);
 
     if (doFrameStep)
     {
@@ -439,6 +551,9 @@ void Shutdown()
 
     sWorlds.clear();
 
+    // Coroutines without an owner node outlive the worlds. Release their threads while Lua is still open.
+    ScriptScheduler::StopAllCoroutines();
+
 #if LUA_ENABLED
     lua_close(sEngineState.mLua);
     sEngineState.mLua = nullptr;
@@ -507,6 +622,11 @@ bool IsShuttingDown()
     return sEngineState.mQuit;
 }
 
+bool IsHeadless()
+{
+    return sEngineConfig.mHeadless;
+}
+
 void LoadProject(const std::string& path, bool discoverAssets)
 {
     SCOPED_STAT("LoadProject");
@@ -684,12 +804,101 @@ void ReloadAllScripts(bool restartComponents)
             scripts[i]->SetScriptProperties(scriptProps[i]);
         }
     }
+    else
+    {
+        // Class tables are patched in place, so running instances only need to pick up the new functions.
+        for (uint32_t i = 0; i < nodes.size(); ++i)
+        {
+            Script* script = nodes[i]->GetScript();
+
+            if (script != nullptr)
+            {
+                script->OnClassReloaded(false);
+            }
+        }
+    }
 
     LogDebug("--Reloaded All Scripts--");
 
 #endif
 }
 
+uint32_t ReloadModifiedScripts(bool restartComponents)
+{
+    uint32_t numReloaded = 0;
+
+#if LUA_ENABLED
+    std::vector<std::string> fileNames;
+    ScriptUtils::GatherModifiedScriptFiles(fileNames);
+
+    std::vector<std::string> classNames;
+
+    for (uint32_t i = 0; i < fileNames.size(); ++i)
+    {
+        if (ScriptUtils::ReloadScriptFile(fileNames[i]))
+        {
+            classNames.push_back(ScriptUtils::GetClassNameFromFileName(fileNames[i]));
+        }
+    }
+
+    if (classNames.size() > 0)
+    {
+        std::vector<Node*> nodes;
+
+        for (uint32_t i = 0; i < sWorlds.size(); ++i)
+        {
+            sWorlds[i]->GatherNodes(nodes);
+        }
+
+        // Only instances of the reloaded classes (or classes derived from them) are touched.
+        for (uint32_t i = 0; i < nodes.size(); ++i)
+        {
+            Script* script = nodes[i]->GetScript();
+
+            if (script == nullptr)
+                continue;
+
+            for (uint32_t c = 0; c < classNames.size(); ++c)
+            {
+                if (script->InheritsFromClass(classNames[c]))
+                {
+                    std::vector<Property> scriptProps;
+
+                    if (restartComponents)
+                    {
+                        scriptProps = script->GetScriptProperties();
+                    }
+
+                    script->OnClassReloaded(restartComponents);
+
+                    if (restartComponents)
+                    {
+                        script->SetScriptProperties(scriptProps);
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        numReloaded = uint32_t(classNames.size());
+        LogDebug("--Reloaded %d Modified Script(s)--", int32_t(numReloaded));
+    }
+#endif
+
+    return numReloaded;
+}
+
+void EnableScriptHotReload(bool enable)
+{
+    sScriptHotReload = enable;
+}
+
+bool IsScriptHotReloadEnabled()
+{
+    return sScriptHotReload;
+}
+
 void SetPaused(bool paused)
 {
     sEngineState.mPaused = paused;
@@ -761,11 +970,59 @@ void GameMain(int32_t argc, char** argv)
     EnableConsole(false);
 
     bool loop = true;
+
+    if (sEngineConfig.mRunNetBenchmark)
+    {
+        // Benchmark runs replace the game loop so they can be scripted in CI.
+        RunReplicationBenchmark(sEngineConfig.mNetBenchmark);
+        loop = false;
+    }
+    else if (sEngineConfig.mDedicatedServer)
+    {
+        NetSessionOpenOptions sessionOptions;
+        sessionOptions.mName = sEngineState.mProjectName;
+        sessionOptions.mLan = true;
+
+        if (sEngineConfig.mServerPort != 0)
+        {
+            sessionOptions.mPort = sEngineConfig.mServerPort;
+        }
+
+        NetworkManager::Get()->OpenSession(sessionOptions);
+
+        if (!NetworkManager::Get()->IsServer())
+        {
+            LogError("Dedicated server failed to open a session on port %d", (int32_t)sessionOptions.mPort);
+            loop = false;
+        }
+    }
+
+    // Without a swapchain there is no vsync to pace frames, so headless runs tick at a fixed
+    // rate and sleep away the rest of each tick instead of spinning a core.
+    const uint64_t tickMicroseconds = uint64_t(1000000.0f / sEngineConfig.mHeadlessTickRate);
+    uint64_t nextTickTime = SYS_GetTimeMicroseconds();
+
     while (loop)
     {
         OctPreUpdate();
         loop = Update();
         OctPostUpdate();
+
+        if (sEngineConfig.mHeadless)
+        {
+            nextTickTime += tickMicroseconds;
+            uint64_t time = SYS_GetTimeMicroseconds();
+
+            if (time < nextTickTime)
+            {
+                SYS_Sleep(uint32_t((nextTickTime - time) / 1000));
+            }
+            else if (time - nextTickTime > tickMicroseconds)
+            {
+                // Fell behind by more than a tick. Don't try to catch up with a burst of ticks.
+                nextTickTime = time;
+            }
+        }
     }
 
     OctPreShutdown();
@@ -31,6 +31,9 @@ const class Clock* GetAppClock();
 
 bool IsShuttingDown();
 
+// True when running with -headless or -server. No window, graphics device or audio device is created.
+bool IsHeadless();
+
 void LoadProject(const std::string& path, bool discoverAssets = true);
 
 void EnableConsole(bool enable);
@@ -44,6 +47,12 @@ bool IsGameTickEnabled();
 
 void ReloadAllScripts(bool restartComponents = true);
 
+// Reloads only the script classes whose files changed on disk. Runs automatically about once a second
+// when hot reload is enabled (default in editor builds). Returns the number of classes reloaded.
+uint32_t ReloadModifiedScripts(bool restartComponents = false);
+void EnableScriptHotReload(bool enable);
+bool IsScriptHotReloadEnabled();
+
 void SetPaused(bool paused);
 bool IsPaused();
 void FrameStep();
@@ -3,6 +3,8 @@
 
 #include <Bullet/btBulletDynamicsCommon.h>
 
+#include <algorithm>
+
 IgnoreConvexResultCallback::IgnoreConvexResultCallback(
     const btVector3& convexFromWorld,
     const btVector3& convexToWorld) : 
@@ -35,10 +37,44 @@ bool IgnoreConvexResultCallback::needsCollision(btBroadphaseProxy* proxy0) const
     return collides;
 }
 
-ReliablePacket::ReliablePacket(uint16_t seqNum, const char* data, uint32_t size)
+void ReliablePacket::SetData(uint16_t seqNum, const char* data, uint32_t size)
 {
     OCT_ASSERT(size <= OCT_MAX_MSG_SIZE);
     mSeq = seqNum;
-    mData.resize(size);
-    memcpy(mData.data(), data, size);
+    mSize = glm::min<uint32_t>(size, OCT_MAX_MSG_SIZE);
+    memcpy(mData, data, mSize);
+}
+
+ReliablePacket& ReliablePacketQueue::Push()
+{
+    if (mCount == mPackets.size())
+    {
+        // Unroll the ring so the new slots are appended after the newest packet.
+        std::rotate(mPackets.begin(), mPackets.begin() + mHead, mPackets.end());
+        mHead = 0;
+        mPackets.resize(glm::max<uint32_t>(mCount * 2, OCT_RELIABLE_WINDOW_SIZE));
+    }
+
+    ReliablePacket& packet = mPackets[(mHead + mCount) % mPackets.size()];
+    mCount++;
+    return packet;
+}
+
+ReliablePacket& ReliablePacketQueue::Front()
+{
+    OCT_ASSERT(mCount > 0);
+    return mPackets[mHead];
+}
+
+void ReliablePacketQueue::Pop()
+{
+    OCT_ASSERT(mCount > 0);
+    mHead = (mHead + 1) % mPackets.size();
+    mCount--;
+}
+
+void ReliablePacketQueue::Clear()
+{
+    mHead = 0;
+    mCount = 0;
 }
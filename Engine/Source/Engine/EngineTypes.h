@@ -2,10 +2,13 @@
 
 #include <string>
 #include <string.h>
+#include <unordered_map>
 
 #include "Constants.h"
 #include "Maths.h"
 
+#include "Network/NetworkConstants.h"
+
 #include "System/SystemTypes.h"
 #include "Graphics/GraphicsTypes.h"
 #include "Input/InputTypes.h"
@@ -17,6 +20,7 @@
 #endif
 
 class Level;
+class Node;
 class Primitive3D;
 class Node3D;
 class Node;
@@ -247,6 +251,26 @@ struct InitOptions
     std::string mDefaultScene;
 };
 
+// Simulated network conditions applied to outgoing packets. Used to test netcode without external tools.
+// Random rolls come from a seeded generator so a run can be reproduced.
+struct NetSimConditions
+{
+    float mLatencyMs = 0.0f;
+    float mJitterMs = 0.0f;
+    float mPacketLoss = 0.0f;   // Chance [0-1] to drop a packet
+    float mDuplicate = 0.0f;    // Chance [0-1] to send a packet twice
+    float mReorder = 0.0f;      // Chance [0-1] to hold a packet back so that later packets overtake it
+    uint32_t mSeed = 1;
+};
+
+struct NetBenchmarkOptions
+{
+    uint32_t mNumClients = 8;
+    uint32_t mNumNodes = 256;
+    uint32_t mNumTicks = 600;
+    float mTickRate = 60.0f;
+};
+
 struct EngineConfig
 {
     EngineConfig()
@@ -262,6 +286,13 @@ struct EngineConfig
     int32_t mWindowHeight = 0;
     bool mValidateGraphics = false;
     bool mFullscreen = false;
+    NetSimConditions mNetSim;
+    NetBenchmarkOptions mNetBenchmark;
+    bool mRunNetBenchmark = false;
+    bool mHeadless = false;
+    bool mDedicatedServer = false;
+    uint16_t mServerPort = 0; // 0 uses OCT_DEFAULT_PORT
+    float mHeadlessTickRate = 60.0f;
 };
 
 enum class ConsoleMode
@@ -412,15 +443,79 @@ struct NetHost
     uint64_t mOnlineId = 0;
 };
 
+// Payload is stored inline so the reliable windows and queue act as slabs that never allocate per packet.
 struct ReliablePacket
 {
-    ReliablePacket(uint16_t seqNum, const char* data, uint32_t size);
+    void SetData(uint16_t seqNum, const char* data, uint32_t size);
 
-    float mTimeSinceSend = 0.0f;
+    uint64_t mSendTime = 0; // Microseconds
     uint32_t mNumSends = 0;
 
-    std::vector<char> mData;
+    char mData[OCT_MAX_MSG_SIZE];
+    uint32_t mSize = 0;
     uint16_t mSeq = 0;
+    bool mActive = false;
+};
+
+// Ring buffer of reliable packets waiting for room in the send window.
+// Slots are recycled, storage only grows when more packets are queued than ever before.
+struct ReliablePacketQueue
+{
+    ReliablePacket& Push();
+    ReliablePacket& Front();
+    void Pop();
+    void Clear();
+
+    uint32_t GetSize() const { return mCount; }
+    bool IsEmpty() const { return mCount == 0; }
+
+    std::vector<ReliablePacket> mPackets;
+    uint32_t mHead = 0;
+    uint32_t mCount = 0;
+};
+
+// Encoded value of one replicated variable. Used both for the server's latest snapshot of a node
+// and for the last state a client has acknowledged (its delta baseline).
+struct NetRepVarState
+{
+    std::vector<uint8_t> mData;
+    uint32_t mNumBits = 0;
+    uint32_t mSerial = 0; // 0 = no value yet
+};
+
+struct NetRepBaseline
+{
+    // [0] = native replicated data, [1] = script replicated data
+    std::vector<NetRepVarState> mVars[2];
+};
+
+struct NetRepSnapshot
+{
+    // [0] = native replicated data, [1] = script replicated data
+    std::vector<NetRepVarState> mVars[2];
+    uint32_t mFrame = 0;
+};
+
+// A node that is spawned on a client because it is currently relevant to it.
+struct NetRelevantNode
+{
+    Node* mNode = nullptr;
+    float mPriority = 0.0f;     // Accumulates every update, node is sent once it reaches 1
+    float mScale = 1.0f;        // Distance falloff from the last relevancy pass
+    bool mNeedsInitialRep = false;
+};
+
+// A replicate message that has been sent to a client but not acknowledged yet.
+struct NetRepPending
+{
+    NetId mNetId = 0;
+    uint32_t mSerial = 0;
+    uint16_t mSeq = 0;
+    uint8_t mChannel = 0;
+    bool mReliable = false;
+    std::vector<uint16_t> mIndices;
+    std::vector<uint32_t> mOffsets;
+    std::vector<uint8_t> mData;
 };
 
 struct NetHostProfile
@@ -432,13 +527,40 @@ struct NetHostProfile
     float mTimeSinceLastMsg = 0.0f;
     std::vector<char> mSendBuffer;
     std::vector<char> mReliableSendBuffer;
-    std::vector<ReliablePacket> mOutgoingPackets;
-    std::vector<ReliablePacket> mIncomingPackets;
     uint16_t mOutgoingReliableSeq = 0;
     uint16_t mIncomingReliableSeq = 0;
     uint16_t mOutgoingUnreliableSeq = 0;
     uint16_t mIncomingUnreliableSeq = 0;
     bool mReady = true;
+
+    // Reliable channel. Sent and out of order received packets live in ring buffers indexed by seq.
+    // Packets beyond the send window wait in mOutgoingQueue until older packets are acked.
+    ReliablePacket mOutgoingWindow[OCT_RELIABLE_WINDOW_SIZE];
+    ReliablePacket mIncomingWindow[OCT_RELIABLE_WINDOW_SIZE];
+    ReliablePacketQueue mOutgoingQueue;
+    uint16_t mOutgoingReliableBase = 0; // Oldest unacked seq
+    uint16_t mOutgoingReliableEnd = 0;  // Next seq to enter the window
+    float mSmoothedRtt = 0.0f;
+    float mRttVariance = 0.0f;
+    float mResendTimeout = 0.1f; // Adapts to the measured RTT once acks arrive
+    bool mReliableAckDirty = false;
+
+    // Server: per node acked state and in flight replicate messages for delta compression.
+    std::unordered_map<NetId, NetRepBaseline> mRepBaselines;
+    std::vector<NetRepPending> mRepPending;
+    std::vector<NetRepPending> mRepPendingFree; // Recycled entries that keep their buffer capacity
+    uint32_t mNextRepSerial = 1;
+
+    // Server: interest management. Nodes are only spawned/replicated on a client while relevant to it.
+    std::unordered_map<NetId, NetRelevantNode> mRelevantNodes;
+    glm::vec3 mViewPosition = {};
+    NetId mViewNetId = INVALID_NET_ID;
+    bool mHasViewPosition = false;
+
+    // Client: unreliable packets received since the last replication ack was sent.
+    uint32_t mRepAckBits = 0;
+    uint16_t mRepAckSeq = 0;
+    bool mRepAckDirty = false;
 };
 
 typedef NetHostProfile NetClient;
@@ -453,6 +575,15 @@ enum class ReplicationRate : uint8_t
     Count
 };
 
+enum class NetRelevancy : uint8_t
+{
+    Default,    // Relevant within the relevancy distance of a client's view (if the node is 3D)
+    Always,
+    OwnerOnly,
+
+    Count
+};
+
 enum class Platform
 {
     Windows,
@@ -3,9 +3,91 @@
 #include "AssetRef.h"
 #include "Log.h"
 #include "Script.h"
+#include "AssetManager.h"
+#include "NetworkManager.h"
+#include "Nodes/Node.h"
 
 #include <string.h>
 
+// Integers are zigzag encoded and prefixed with their bit length.
+#define NET_VAR_BITS_LENGTH_BITS 6
+#define NET_PRECISION_MAX_STEPS ((1 << 30) - 1)
+
+static uint32_t GetBitLength(uint32_t value)
+{
+    uint32_t length = 0;
+    while (value != 0)
+    {
+        value >>= 1;
+        ++length;
+    }
+    return length;
+}
+
+static uint32_t ZigZagEncode(int32_t value)
+{
+    return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+}
+
+static int32_t ZigZagDecode(uint32_t value)
+{
+    return int32_t(value >> 1) ^ -int32_t(value & 1);
+}
+
+static uint32_t GetVarBitsSize(uint32_t value)
+{
+    return NET_VAR_BITS_LENGTH_BITS + GetBitLength(value);
+}
+
+static void WriteVarBits(Stream& stream, uint32_t value)
+{
+    uint32_t length = GetBitLength(value);
+    stream.WriteBits(length, NET_VAR_BITS_LENGTH_BITS);
+    stream.WriteBits(value, length);
+}
+
+static uint32_t ReadVarBits(Stream& stream)
+{
+    uint32_t length = stream.ReadBits(NET_VAR_BITS_LENGTH_BITS);
+    return stream.ReadBits(glm::min<uint32_t>(length, 32));
+}
+
+static uint32_t FloatToBits(float value)
+{
+    uint32_t ret;
+    memcpy(&ret, &value, sizeof(ret));
+    return ret;
+}
+
+static float BitsToFloat(uint32_t value)
+{
+    float ret;
+    memcpy(&ret, &value, sizeof(ret));
+    return ret;
+}
+
+static uint32_t GetMaxQuantizedValue(uint32_t numBits)
+{
+    return (numBits >= 32) ? 0xffffffff : ((1u << numBits) - 1);
+}
+
+static int32_t QuantizePrecision(float value, float precision)
+{
+    float steps = glm::round(value / precision);
+    steps = glm::clamp(steps, -float(NET_PRECISION_MAX_STEPS), float(NET_PRECISION_MAX_STEPS));
+    return int32_t(steps);
+}
+
+static glm::quat EulerToQuat(const glm::vec3& euler)
+{
+    return glm::normalize(glm::quat(euler * DEGREES_TO_RADIANS));
+}
+
+static glm::vec3 QuatToEuler(const glm::quat& quat)
+{
+    return glm::eulerAngles(quat) * RADIANS_TO_DEGREES;
+}
+
 NetDatum::NetDatum()
 {
 
@@ -113,6 +195,381 @@ void NetDatum::PostReplicate()
     }
 }
 
+NetDatum& NetDatum::SetQuantizeRange(float minValue, float maxValue, uint32_t numBits)
+{
+    OCT_ASSERT(maxValue > minValue);
+    OCT_ASSERT(numBits > 0 && numBits <= 32);
+    mQuantize = NetQuantize::Range;
+    mQuantizeMin = minValue;
+    mQuantizeMax = maxValue;
+    mQuantizeBits = uint8_t(glm::clamp<uint32_t>(numBits, 1, 32));
+    return *this;
+}
+
+NetDatum& NetDatum::SetQuantizePrecision(float precision)
+{
+    OCT_ASSERT(precision > 0.0f);
+    mQuantize = NetQuantize::Precision;
+    mQuantizeMin = precision;
+    return *this;
+}
+
+NetDatum& NetDatum::SetQuantizeRotation(uint32_t numBits)
+{
+    // Rotation quantization only makes sense for euler angle vectors.
+    OCT_ASSERT(mType == DatumType::Vector);
+    OCT_ASSERT(numBits > 1 && numBits <= 16);
+    mQuantize = NetQuantize::Rotation;
+    mQuantizeBits = uint8_t(glm::clamp<uint32_t>(numBits, 2, 16));
+    return *this;
+}
+
+static uint32_t GetFloatBits(NetQuantize quantize, uint32_t quantizeBits, float precision, float value)
+{
+    uint32_t bits = 32;
+
+    switch (quantize)
+    {
+    case NetQuantize::Range: bits = quantizeBits; break;
+    case NetQuantize::Precision: bits = GetVarBitsSize(ZigZagEncode(QuantizePrecision(value, precision))); break;
+    default: break;
+    }
+
+    return bits;
+}
+
+static void WriteFloatBits(Stream& stream, NetQuantize quantize, uint32_t quantizeBits, float minValue, float maxValue, float value)
+{
+    switch (quantize)
+    {
+    case NetQuantize::Range:
+    {
+        uint32_t maxQuant = GetMaxQuantizedValue(quantizeBits);
+        float alpha = glm::clamp((value - minValue) / (maxValue - minValue), 0.0f, 1.0f);
+        stream.WriteBits(uint32_t(double(alpha) * maxQuant + 0.5), quantizeBits);
+        break;
+    }
+    case NetQuantize::Precision:
+        WriteVarBits(stream, ZigZagEncode(QuantizePrecision(value, minValue)));
+        break;
+    default:
+        stream.WriteBits(FloatToBits(value), 32);
+        break;
+    }
+}
+
+static float ReadFloatBits(Stream& stream, NetQuantize quantize, uint32_t quantizeBits, float minValue, float maxValue)
+{
+    float ret = 0.0f;
+
+    switch (quantize)
+    {
+    case NetQuantize::Range:
+    {
+        uint32_t maxQuant = GetMaxQuantizedValue(quantizeBits);
+        uint32_t quant = stream.ReadBits(quantizeBits);
+        ret = minValue + float(double(quant) / maxQuant) * (maxValue - minValue);
+        break;
+    }
+    case NetQuantize::Precision:
+        ret = ZigZagDecode(ReadVarBits(stream)) * minValue;
+        break;
+    default:
+        ret = BitsToFloat(stream.ReadBits(32));
+        break;
+    }
+
+    return ret;
+}
+
+static void WriteRotationBits(Stream& stream, uint32_t numBits, const glm::vec3& euler)
+{
+    // Smallest three: drop the largest component (it can be rebuilt from the unit length),
+    // and the other three are bounded by +/- 1/sqrt(2).
+    glm::quat quat = EulerToQuat(euler);
+    float comps[4] = { quat.x, quat.y, quat.z, quat.w };
+
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        if (glm::abs(comps[i]) > glm::abs(comps[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    float sign = (comps[largest] < 0.0f) ? -1.0f : 1.0f;
+    const float bound = 0.70710678f;
+    stream.WriteBits(largest, 2);
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+        {
+            WriteFloatBits(stream, NetQuantize::Range, numBits, -bound, bound, comps[i] * sign);
+        }
+    }
+}
+
+static glm::vec3 ReadRotationBits(Stream& stream, uint32_t numBits)
+{
+    const float bound = 0.70710678f;
+    uint32_t largest = stream.ReadBits(2);
+    float comps[4] = {};
+    float sumSq = 0.0f;
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+        {
+            comps[i] = ReadFloatBits(stream, NetQuantize::Range, numBits, -bound, bound);
+            sumSq += comps[i] * comps[i];
+        }
+    }
+
+    comps[largest] = glm::sqrt(glm::max(0.0f, 1.0f - sumSq));
+
+    glm::quat quat(comps[3], comps[0], comps[1], comps[2]);
+    return QuatToEuler(glm::normalize(quat));
+}
+
+uint32_t NetDatum::GetNetSerializationBits() const
+{
+    uint32_t bits = 0;
+    float precision = mQuantizeMin;
+
+    for (uint32_t i = 0; i < mCount; ++i)
+    {
+        switch (mType)
+        {
+            case DatumType::Integer: bits += GetVarBitsSize(ZigZagEncode(mData.i[i])); break;
+            case DatumType::Float: bits += GetFloatBits(mQuantize, mQuantizeBits, precision, mData.f[i]); break;
+            case DatumType::Bool: bits += 1; break;
+            case DatumType::String: bits += GetVarBitsSize(uint32_t(mData.s[i].size())) + 8 * uint32_t(mData.s[i].size()); break;
+            case DatumType::Vector2D:
+                for (uint32_t c = 0; c < 2; ++c)
+                    bits += GetFloatBits(mQuantize, mQuantizeBits, precision, mData.v2[i][c]);
+                break;
+            case DatumType::Vector:
+                if (mQuantize == NetQuantize::Rotation)
+                {
+                    bits += 2 + 3 * mQuantizeBits;
+                }
+                else
+                {
+                    for (uint32_t c = 0; c < 3; ++c)
+                        bits += GetFloatBits(mQuantize, mQuantizeBits, precision, mData.v3[i][c]);
+                }
+                break;
+            case DatumType::Color:
+                for (uint32_t c = 0; c < 4; ++c)
+                    bits += GetFloatBits(mQuantize, mQuantizeBits, precision, mData.v4[i][c]);
+                break;
+            case DatumType::Asset:
+            {
+                Asset* asset = mData.as[i].Get();
+                uint32_t len = asset ? uint32_t(asset->GetName().size()) : 0;
+                bits += GetVarBitsSize(len) + 8 * len;
+                break;
+            }
+            case DatumType::Byte: bits += 8; break;
+            case DatumType::Pointer:
+            {
+                Node* node = mData.p[i] ? mData.p[i]->As<Node>() : nullptr;
+                bits += GetVarBitsSize(node ? uint32_t(node->GetNetId()) : uint32_t(INVALID_NET_ID));
+                break;
+            }
+            case DatumType::Short: bits += 16; break;
+            case DatumType::Table: OCT_ASSERT(0); break; // Table not supported for replication
+            case DatumType::Function: OCT_ASSERT(0); break; // Functions not supported for replication
+
+            case DatumType::Count: break;
+        }
+    }
+
+    return bits;
+}
+
+void NetDatum::WriteNetStream(Stream& stream) const
+{
+    OCT_ASSERT(mType != DatumType::Count);
+
+    for (uint32_t i = 0; i < mCount; ++i)
+    {
+        switch (mType)
+        {
+            case DatumType::Integer: WriteVarBits(stream, ZigZagEncode(mData.i[i])); break;
+            case DatumType::Float: WriteFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax, mData.f[i]); break;
+            case DatumType::Bool: stream.WriteBits(mData.b[i] ? 1 : 0, 1); break;
+            case DatumType::String:
+            {
+                const std::string& str = mData.s[i];
+                WriteVarBits(stream, uint32_t(str.size()));
+                for (uint32_t c = 0; c < str.size(); ++c)
+                {
+                    stream.WriteBits(uint8_t(str[c]), 8);
+                }
+                break;
+            }
+            case DatumType::Vector2D:
+                for (uint32_t c = 0; c < 2; ++c)
+                    WriteFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax, mData.v2[i][c]);
+                break;
+            case DatumType::Vector:
+                if (mQuantize == NetQuantize::Rotation)
+                {
+                    WriteRotationBits(stream, mQuantizeBits, mData.v3[i]);
+                }
+                else
+                {
+                    for (uint32_t c = 0; c < 3; ++c)
+                        WriteFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax, mData.v3[i][c]);
+                }
+                break;
+            case DatumType::Color:
+                for (uint32_t c = 0; c < 4; ++c)
+                    WriteFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax, mData.v4[i][c]);
+                break;
+            case DatumType::Asset:
+            {
+                Asset* asset = mData.as[i].Get();
+                const std::string emptyName;
+                const std::string& name = asset ? asset->GetName() : emptyName;
+                WriteVarBits(stream, uint32_t(name.size()));
+                for (uint32_t c = 0; c < name.size(); ++c)
+                {
+                    stream.WriteBits(uint8_t(name[c]), 8);
+                }
+                break;
+            }
+            case DatumType::Byte: stream.WriteBits(mData.by[i], 8); break;
+            case DatumType::Pointer:
+            {
+                // Pointers can only be replicated if they point to a net node.
+                Node* node = mData.p[i] ? mData.p[i]->As<Node>() : nullptr;
+                WriteVarBits(stream, node ? uint32_t(node->GetNetId()) : uint32_t(INVALID_NET_ID));
+                break;
+            }
+            case DatumType::Short: stream.WriteBits(uint16_t(mData.sh[i]), 16); break;
+            case DatumType::Table: OCT_ASSERT(0); break; // Table not supported for replication
+            case DatumType::Function: OCT_ASSERT(0); break; // Functions not supported for replication
+
+            case DatumType::Count: break;
+        }
+    }
+}
+
+void NetDatum::ReadNetStream(Stream& stream)
+{
+    OCT_ASSERT(mType != DatumType::Count);
+
+    // Decode each element and only call SetValue() (and thus the OnRep handler) if it changed.
+    for (uint32_t i = 0; i < mCount; ++i)
+    {
+        switch (mType)
+        {
+            case DatumType::Integer:
+            {
+                int32_t value = ZigZagDecode(ReadVarBits(stream));
+                if (value != mData.i[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Float:
+            {
+                float value = ReadFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax);
+                if (value != mData.f[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Bool:
+            {
+                bool value = (stream.ReadBits(1) != 0);
+                if (value != mData.b[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::String:
+            {
+                uint32_t len = ReadVarBits(stream);
+                std::string value;
+                value.resize(len);
+                for (uint32_t c = 0; c < len; ++c)
+                {
+                    value[c] = char(stream.ReadBits(8));
+                }
+                if (value != mData.s[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Vector2D:
+            {
+                glm::vec2 value;
+                for (uint32_t c = 0; c < 2; ++c)
+                    value[c] = ReadFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax);
+                if (value != mData.v2[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Vector:
+            {
+                glm::vec3 value;
+                if (mQuantize == NetQuantize::Rotation)
+                {
+                    value = ReadRotationBits(stream, mQuantizeBits);
+                }
+                else
+                {
+                    for (uint32_t c = 0; c < 3; ++c)
+                        value[c] = ReadFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax);
+                }
+                if (value != mData.v3[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Color:
+            {
+                glm::vec4 value;
+                for (uint32_t c = 0; c < 4; ++c)
+                    value[c] = ReadFloatBits(stream, mQuantize, mQuantizeBits, mQuantizeMin, mQuantizeMax);
+                if (value != mData.v4[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Asset:
+            {
+                uint32_t len = ReadVarBits(stream);
+                std::string name;
+                name.resize(len);
+                for (uint32_t c = 0; c < len; ++c)
+                {
+                    name[c] = char(stream.ReadBits(8));
+                }
+
+                AssetRef value = (len > 0) ? LoadAsset(name) : nullptr;
+                if (value.Get() != mData.as[i].Get()) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Byte:
+            {
+                uint8_t value = uint8_t(stream.ReadBits(8));
+                if (value != mData.by[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Pointer:
+            {
+                NetId netId = (NetId)ReadVarBits(stream);
+                RTTI* value = NetworkManager::Get()->GetNetNode(netId);
+                if (value != mData.p[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Short:
+            {
+                int16_t value = int16_t(stream.ReadBits(16));
+                if (value != mData.sh[i]) SetValue(&value, i, 1);
+                break;
+            }
+            case DatumType::Table: OCT_ASSERT(0); break; // Table not supported for replication
+            case DatumType::Function: OCT_ASSERT(0); break; // Functions not supported for replication
+
+            case DatumType::Count: break;
+        }
+    }
+}
+
 void NetDatum::Destroy()
 {
     if (mPrevData.vp != nullptr)
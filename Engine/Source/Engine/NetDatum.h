@@ -4,6 +4,17 @@
 
 #include <string>
 
+// How float components of a NetDatum are encoded for replication.
+enum class NetQuantize : uint8_t
+{
+    None,       // Full 32-bit float
+    Range,      // Fixed number of bits spread across [min, max]
+    Precision,  // Rounded to a step size and sent with as few bits as needed
+    Rotation,   // Euler angles (degrees) sent as a smallest-three quaternion
+
+    Count
+};
+
 class NetDatum : public Datum
 {
 public:
@@ -17,6 +28,16 @@ public:
         bool alwaysReplicate = false);
     bool ShouldReplicate() const;
     void PostReplicate();
+    bool IsAlwaysReplicated() const { return mAlwaysReplicate; }
+
+    NetDatum& SetQuantizeRange(float minValue, float maxValue, uint32_t numBits);
+    NetDatum& SetQuantizePrecision(float precision);
+    NetDatum& SetQuantizeRotation(uint32_t numBits = 10);
+
+    // Bit packed network encoding. The type and count are implied by the receiver's matching NetDatum.
+    uint32_t GetNetSerializationBits() const;
+    void WriteNetStream(Stream& stream) const;
+    void ReadNetStream(Stream& stream);
     
 protected:
     virtual void Destroy() override;
@@ -24,6 +45,11 @@ protected:
     DatumData mPrevData = {};
     uint32_t mPrevCount = 0;
     bool mAlwaysReplicate = false;
+
+    NetQuantize mQuantize = NetQuantize::None;
+    uint8_t mQuantizeBits = 0;
+    float mQuantizeMin = 0.0f;
+    float mQuantizeMax = 0.0f;
 };
 
 class ScriptNetDatum : public NetDatum
@@ -41,4 +67,5 @@ public:
 
     std::string mVarName;
     std::string mOnRepFuncName;
+    bool mDirty = true; // Script assigned the variable since it was last downloaded
 };
@@ -305,49 +305,92 @@ void NetMsgDestroy::Execute(NetHost sender)
 void NetMsgReplicate::Read(Stream& stream)
 {
     NetMsg::Read(stream);
-    mNodeNetId = stream.ReadUint32();
-    mNumVariables = stream.ReadUint16();
-
-    // Limiting max variables per message to 64.
-    OCT_ASSERT(mNumVariables <= 64);
-
-    mIndices.clear();
-    mData.clear();
-
-    mIndices.resize(mNumVariables);
-    mData.resize(mNumVariables);
+    mNodeNetId = stream.ReadVarUint32();
+    mNumSchemaVariables = (uint16_t)stream.ReadVarUint32();
+    mPayloadSize = stream.ReadVarUint32();
 
-    for (uint32_t i = 0; i < mNumVariables; ++i)
+    if (stream.GetPos() + mPayloadSize <= stream.GetSize())
     {
-        mIndices[i] = stream.ReadUint16();
-
-        // We are assuming the stream data will persist for the duration
-        // of this message's life cycle (until Execute() is called).
-        // This avoids allocation and copying data.
-        mData[i].ReadStream(stream, false);
+        // Avoid copying, the payload is decoded straight out of the packet in Execute().
+        mPayload = stream.GetData() + stream.GetPos();
+        stream.SetPos(stream.GetPos() + mPayloadSize);
+    }
+    else
+    {
+        LogError("Replicate message payload exceeds packet size.");
+        mPayload = nullptr;
+        mPayloadSize = 0;
+        stream.SetPos(stream.GetSize());
     }
 }
 
 void NetMsgReplicate::Write(Stream& stream) const
 {
     NetMsg::Write(stream);
-    stream.WriteUint32(mNodeNetId);
-    stream.WriteUint16(mNumVariables);
 
     OCT_ASSERT(mIndices.size() == mNumVariables);
-    OCT_ASSERT(mData.size() == mNumVariables);
+    OCT_ASSERT(mDatums.size() == mNumVariables);
 
+    // One changed bit per schema variable, each set bit directly followed by the datum value.
+    uint32_t payloadBits = mNumSchemaVariables;
     for (uint32_t i = 0; i < mNumVariables; ++i)
     {
-        stream.WriteUint16(mIndices[i]);
-        mData[i].WriteStream(stream);
+        payloadBits += mDatums[i]->GetNetSerializationBits();
+    }
+
+    stream.WriteVarUint32(mNodeNetId);
+    stream.WriteVarUint32(mNumSchemaVariables);
+    stream.WriteVarUint32((payloadBits + 7) / 8);
+
+    uint32_t changedIdx = 0;
+    for (uint32_t i = 0; i < mNumSchemaVariables; ++i)
+    {
+        bool changed = (changedIdx < mNumVariables && mIndices[changedIdx] == i);
+        stream.WriteBits(changed ? 1 : 0, 1);
+
+        if (changed)
+        {
+            mDatums[changedIdx]->WriteNetStream(stream);
+            changedIdx++;
+        }
     }
 
+    stream.AlignBits();
+    OCT_ASSERT(changedIdx == mNumVariables);
+
     // Multiple replicate messages will need to be send for an actor
     // if it exceeds the message size limit.
     OCT_ASSERT(stream.GetPos() < OCT_MAX_MSG_BODY_SIZE);
 }
 
+template<typename T>
+static void ReadReplicatedPayload(const NetMsgReplicate& msg, std::vector<T>& repData, Node* node)
+{
+    if (msg.mNumSchemaVariables != repData.size())
+    {
+        LogWarning("Replicated data schema mismatch on %s (%u vs %u).",
+            node->GetName().c_str(),
+            (uint32_t)msg.mNumSchemaVariables,
+            (uint32_t)repData.size());
+        return;
+    }
+
+    if (msg.mPayload == nullptr)
+    {
+        return;
+    }
+
+    Stream stream(msg.mPayload, msg.mPayloadSize);
+
+    for (uint32_t i = 0; i < msg.mNumSchemaVariables; ++i)
+    {
+        if (stream.ReadBits(1))
+        {
+            repData[i].ReadNetStream(stream);
+        }
+    }
+}
+
 void NetMsgReplicate::Execute(NetHost sender)
 {
     NetMsg::Execute(sender);
@@ -356,30 +399,7 @@ void NetMsgReplicate::Execute(NetHost sender)
 
     if (node != nullptr)
     {
-        std::vector<NetDatum>& repData = node->GetReplicatedData();
-
-        for (uint32_t i = 0; i < mNumVariables; ++i)
-        {
-            uint16_t dstIndex = mIndices[i];
-            OCT_ASSERT(dstIndex < repData.size());
-
-            if (dstIndex < repData.size())
-            {
-                // Native net datum
-                OCT_ASSERT(repData[dstIndex].mType == mData[i].mType);
-                OCT_ASSERT(repData[dstIndex].mCount == mData[i].mCount);
-
-                if (repData[dstIndex] != mData[i])
-                {
-                    repData[dstIndex].SetValue(mData[i].mData.vp, 0, repData[dstIndex].mCount);
-                }
-            }
-            else
-            {
-                OCT_ASSERT(0);
-                LogError("Replicated index out of range.");
-            }
-        }
+        ReadReplicatedPayload(*this, node->GetReplicatedData(), node);
     }
     else
     {
@@ -416,29 +436,7 @@ void NetMsgReplicateScript::Execute(NetHost sender)
 
         if (script != nullptr)
         {
-            std::vector<ScriptNetDatum>& repData = script->GetReplicatedData();
-
-            for (uint32_t i = 0; i < mNumVariables; ++i)
-            {
-                uint16_t dstIndex = mIndices[i];
-                OCT_ASSERT(dstIndex < repData.size());
-
-                if (dstIndex < repData.size())
-                {
-                    OCT_ASSERT(repData[dstIndex].mType == mData[i].mType);
-                    OCT_ASSERT(repData[dstIndex].mCount == mData[i].mCount);
-
-                    if (repData[dstIndex] != mData[i])
-                    {
-                        repData[dstIndex].SetValue(mData[i].mData.vp, 0, repData[dstIndex].mCount);
-                    }
-                }
-                else
-                {
-                    OCT_ASSERT(0);
-                    LogError("Replicated index out of range.");
-                }
-            }
+            ReadReplicatedPayload(*this, script->GetReplicatedData(), node);
         }
         else
         {
@@ -451,6 +449,44 @@ void NetMsgReplicateScript::Execute(NetHost sender)
     }
 }
 
+static void ReadInvokeParam(Stream& stream, Datum& datum, NetFuncParamStorage& storage)
+{
+    // Same layout as Datum::WriteStream(): type, count, then the elements.
+    uint32_t startPos = stream.GetPos();
+    DatumType type = (DatumType)stream.ReadUint8();
+    uint8_t count = stream.ReadUint8();
+
+    datum.Destroy();
+
+    if (count == 1)
+    {
+        switch (type)
+        {
+        case DatumType::Integer: storage.mInteger = stream.ReadInt32(); datum.SetExternal(&storage.mInteger); return;
+        case DatumType::Float: storage.mFloat = stream.ReadFloat(); datum.SetExternal(&storage.mFloat); return;
+        case DatumType::Bool: storage.mBool = stream.ReadBool(); datum.SetExternal(&storage.mBool); return;
+        case DatumType::String: stream.ReadString(storage.mString); datum.SetExternal(&storage.mString); return;
+        case DatumType::Vector2D: storage.mVector2D = stream.ReadVec2(); datum.SetExternal(&storage.mVector2D); return;
+        case DatumType::Vector: storage.mVector = stream.ReadVec3(); datum.SetExternal(&storage.mVector); return;
+        case DatumType::Color: storage.mColor = stream.ReadVec4(); datum.SetExternal(&storage.mColor); return;
+        case DatumType::Asset: stream.ReadAsset(storage.mAsset); datum.SetExternal(&storage.mAsset); return;
+        case DatumType::Byte: storage.mByte = stream.ReadUint8(); datum.SetExternal(&storage.mByte); return;
+        case DatumType::Short: storage.mShort = stream.ReadInt16(); datum.SetExternal(&storage.mShort); return;
+        case DatumType::Pointer:
+        {
+            NetId netId = (NetId)stream.ReadUint32();
+            storage.mPointer = NetworkManager::Get()->GetNetNode(netId);
+            datum.SetExternal(&storage.mPointer);
+            return;
+        }
+        default: break;
+        }
+    }
+
+    stream.SetPos(startPos);
+    datum.ReadStream(stream, false);
+}
+
 void NetMsgInvoke::Read(Stream& stream)
 {
     NetMsg::Read(stream);
@@ -458,13 +494,27 @@ void NetMsgInvoke::Read(Stream& stream)
     mNodeNetId = stream.ReadUint32();
     mIndex = stream.ReadUint16();
     mNumParams = stream.ReadUint8();
+    mRejected = false;
 
-    mParams.clear();
-    mParams.resize(mNumParams);
+    if (mNumParams > OCT_NET_FUNC_MAX_PARAMS)
+    {
+        // Still consume every param so the rest of the packet is read from the right position.
+        LogWarning("Invoke message has too many params (%u)", (uint32_t)mNumParams);
+        Datum skipped;
+
+        for (uint32_t i = 0; i < mNumParams; ++i)
+        {
+            skipped.ReadStream(stream, false);
+        }
+
+        mNumParams = 0;
+        mRejected = true;
+        return;
+    }
 
     for (uint32_t i = 0; i < mNumParams; ++i)
     {
-        mParams[i].ReadStream(stream, false);
+        ReadInvokeParam(stream, mParams[i], mParamStorage[i]);
     }
 }
 
@@ -475,11 +525,11 @@ void NetMsgInvoke::Write(Stream& stream) const
     stream.WriteUint16(mIndex);
     stream.WriteUint8(mNumParams);
 
-    OCT_ASSERT(mParams.size() == mNumParams);
+    OCT_ASSERT(mNumParams == 0 || mSendParams != nullptr);
 
     for (uint32_t i = 0; i < mNumParams; ++i)
     {
-        mParams[i].WriteStream(stream);
+        mSendParams[i]->WriteStream(stream);
     }
 
     OCT_ASSERT(stream.GetPos() < OCT_MAX_MSG_BODY_SIZE);
@@ -489,6 +539,9 @@ void NetMsgInvoke::Execute(NetHost sender)
 {
     NetMsg::Execute(sender);
 
+    if (mRejected)
+        return;
+
     Node* node = NetworkManager::Get()->GetNetNode(mNodeNetId);
 
     if (node != nullptr)
@@ -544,6 +597,9 @@ void NetMsgInvokeScript::Execute(NetHost sender)
     
     // Override NetMsgInvoke
 
+    if (mRejected)
+        return;
+
     Node* node = NetworkManager::Get()->GetNetNode(mNodeNetId);
 
     if (node != nullptr)
@@ -634,16 +690,56 @@ void NetMsgAck::Read(Stream& stream)
 {
     NetMsg::Read(stream);
     mSequenceNumber = stream.ReadUint16();
+    mAckBits = stream.ReadUint32();
 }
 
 void NetMsgAck::Write(Stream& stream) const
 {
     NetMsg::Write(stream);
     stream.WriteUint16(mSequenceNumber);
+    stream.WriteUint32(mAckBits);
 }
 
 void NetMsgAck::Execute(NetHost sender)
 {
     NetMsg::Execute(sender);
-    NetworkManager::Get()->HandleAck(sender, mSequenceNumber);
+    NetworkManager::Get()->HandleAck(sender, mSequenceNumber, mAckBits);
+}
+
+void NetMsgReplicateAck::Read(Stream& stream)
+{
+    NetMsg::Read(stream);
+    mSequenceNumber = stream.ReadUint16();
+    mAckBits = stream.ReadUint32();
+}
+
+void NetMsgReplicateAck::Write(Stream& stream) const
+{
+    NetMsg::Write(stream);
+    stream.WriteUint16(mSequenceNumber);
+    stream.WriteUint32(mAckBits);
+}
+
+void NetMsgReplicateAck::Execute(NetHost sender)
+{
+    NetMsg::Execute(sender);
+    NetworkManager::Get()->HandleReplicateAck(sender, mSequenceNumber, mAckBits);
+}
+
+void NetMsgServerTime::Read(Stream& stream)
+{
+    NetMsg::Read(stream);
+    mTimeMs = stream.ReadUint32();
+}
+
+void NetMsgServerTime::Write(Stream& stream) const
+{
+    NetMsg::Write(stream);
+    stream.WriteUint32(mTimeMs);
+}
+
+void NetMsgServerTime::Execute(NetHost sender)
+{
+    NetMsg::Execute(sender);
+    NetworkManager::Get()->HandleServerTime(mTimeMs);
 }
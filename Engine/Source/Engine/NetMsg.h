@@ -4,6 +4,10 @@
 #include "EngineTypes.h"
 #include "Stream.h"
 #include "Datum.h"
+#include "AssetRef.h"
+#include "NetFunc.h"
+
+class NetDatum;
 
 #define NET_MESSAGE_MAGIC_STR "OCTM"
 
@@ -34,6 +38,8 @@ enum class NetMsgType : uint8_t
     InvokeScript,
     Broadcast,
     Ack,
+    ReplicateAck,
+    ServerTime,
 
     Count
 };
@@ -135,9 +141,17 @@ struct NetMsgReplicate : public NetMsg
 
     NetId mNodeNetId = INVALID_TYPE_ID;
     uint16_t mNumVariables = 0;
-    std::vector<uint16_t> mIndices;
-    std::vector<Datum> mData;
+    uint16_t mNumSchemaVariables = 0;
     bool mReliable = false;
+
+    // Write: the changed datums and their indices into the node's replicated data (ascending).
+    std::vector<uint16_t> mIndices;
+    std::vector<const NetDatum*> mDatums;
+
+    // Read: the bit packed payload is decoded against the local NetDatums in Execute().
+    // We are assuming the stream data will persist until Execute() is called.
+    const char* mPayload = nullptr;
+    uint32_t mPayloadSize = 0;
 };
 
 struct NetMsgReplicateScript : public NetMsgReplicate
@@ -145,6 +159,23 @@ struct NetMsgReplicateScript : public NetMsgReplicate
     NET_MSG_INTERFACE(ReplicateScript);
 };
 
+// Backing storage for one received NetFunc param. Single values are decoded in here and
+// referenced by an external Datum, so receiving an invoke doesn't allocate.
+struct NetFuncParamStorage
+{
+    int32_t mInteger = 0;
+    float mFloat = 0.0f;
+    bool mBool = false;
+    uint8_t mByte = 0;
+    int16_t mShort = 0;
+    glm::vec2 mVector2D = {};
+    glm::vec3 mVector = {};
+    glm::vec4 mColor = {};
+    RTTI* mPointer = nullptr;
+    std::string mString;
+    AssetRef mAsset;
+};
+
 struct NetMsgInvoke : public NetMsg
 {
     NET_MSG_INTERFACE(Invoke);
@@ -155,7 +186,14 @@ struct NetMsgInvoke : public NetMsg
     uint16_t mIndex = 0;
     uint8_t mNumParams = 0;
     bool mReliable = false;
-    std::vector<Datum> mParams;
+    bool mRejected = false; // Malformed message that was read but must not be executed
+
+    // Outgoing params are written straight from the caller's Datums. Only valid during Write().
+    const Datum** mSendParams = nullptr;
+
+    // Incoming params. Arrays and tables fall back to internal Datum storage.
+    Datum mParams[OCT_NET_FUNC_MAX_PARAMS];
+    NetFuncParamStorage mParamStorage[OCT_NET_FUNC_MAX_PARAMS];
 };
 
 // Creating a separate message for script invoke so we don't need
@@ -180,9 +218,31 @@ struct NetMsgBroadcast : public NetMsg
     uint8_t mNumPlayers = 0;
 };
 
+// Acknowledges reliable packets. Every packet before mSequenceNumber has been received.
+// Bit N of mAckBits means packet (mSequenceNumber + 1 + N) was received out of order.
 struct NetMsgAck : public NetMsg
 {
     NET_MSG_INTERFACE(Ack);
 
     uint16_t mSequenceNumber = 0;
+    uint32_t mAckBits = 0;
+};
+
+// Acknowledges unreliable packets so the server can advance its replication baselines.
+// Bit N of mAckBits means packet (mSequenceNumber - N) was received.
+struct NetMsgReplicateAck : public NetMsg
+{
+    NET_MSG_INTERFACE(ReplicateAck);
+
+    uint16_t mSequenceNumber = 0;
+    uint32_t mAckBits = 0;
+};
+
+// Written by the server at the start of each unreliable packet.
+// Replicated transforms in the same packet are timestamped with it for interpolation.
+struct NetMsgServerTime : public NetMsg
+{
+    NET_MSG_INTERFACE(ServerTime);
+
+    uint32_t mTimeMs = 0;
 };
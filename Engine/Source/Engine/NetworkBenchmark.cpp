@@ -0,0 +1,315 @@
+#include "NetworkBenchmark.h"
+#include "NetworkManager.h"
+#include "NetMsg.h"
+#include "Engine.h"
+#include "World.h"
+#include "Stream.h"
+#include "Log.h"
+#include "Maths.h"
+#include "Nodes/3D/Node3d.h"
+
+#include "System/System.h"
+#include "Network/Network.h"
+#include "Network/NetworkConstants.h"
+
+#define BENCH_MAX_HANDSHAKE_TICKS 600
+#define BENCH_WORLD_EXTENT 200.0f
+
+// A minimal client that speaks the wire protocol directly so many of them can run next to the
+// server in one process. It acks everything it receives but doesn't execute any messages.
+struct BenchClient
+{
+    SocketHandle mSocket = NET_INVALID_SOCKET;
+    uint16_t mOutgoingUnreliableSeq = 0;
+    uint16_t mOutgoingReliableSeq = 0;
+    uint16_t mIncomingReliableSeq = 0;
+    uint16_t mRepAckSeq = 0;
+    uint32_t mRepAckBits = 0;
+    uint64_t mBytesReceived = 0;
+    bool mReliableAckDirty = false;
+    bool mRepAckDirty = false;
+    bool mSentReady = false;
+};
+
+static uint32_t sBenchRandState = 1;
+
+static float BenchRandFloat(float minValue, float maxValue)
+{
+    sBenchRandState ^= sBenchRandState << 13;
+    sBenchRandState ^= sBenchRandState >> 17;
+    sBenchRandState ^= sBenchRandState << 5;
+    float alpha = (sBenchRandState >> 8) * (1.0f / 16777216.0f);
+    return minValue + (maxValue - minValue) * alpha;
+}
+
+static void SendBenchPacket(BenchClient& client, uint32_t ip, uint16_t port, const NetMsg* msg0, const NetMsg* msg1, bool reliable)
+{
+    char data[OCT_SEND_BUFFER_SIZE];
+    Stream stream(data, OCT_SEND_BUFFER_SIZE);
+
+    uint16_t& seq = reliable ? client.mOutgoingReliableSeq : client.mOutgoingUnreliableSeq;
+    stream.WriteUint16(seq);
+    stream.WriteBool(reliable);
+    seq++;
+
+    msg0->Write(stream);
+
+    if (msg1 != nullptr)
+    {
+        msg1->Write(stream);
+    }
+
+    NET_SocketSendTo(client.mSocket, stream.GetData(), stream.GetPos(), ip, port);
+}
+
+static void UpdateBenchClient(BenchClient& client, uint32_t serverIp, uint16_t serverPort)
+{
+    char data[OCT_RECV_BUFFER_SIZE];
+    uint32_t fromIp = 0;
+    uint16_t fromPort = 0;
+    int32_t bytes = 0;
+
+    while ((bytes = NET_SocketRecvFrom(client.mSocket, data, OCT_RECV_BUFFER_SIZE, fromIp, fromPort)) > 0)
+    {
+        if (fromPort != serverPort || bytes <= int32_t(OCT_PACKET_HEADER_SIZE))
+        {
+            continue;
+        }
+
+        Stream stream(data, bytes);
+        uint16_t seq = stream.ReadUint16();
+        bool reliable = stream.ReadBool();
+        client.mBytesReceived += bytes;
+
+        if (reliable)
+        {
+            // Only in order packets are accepted, the server resends anything else.
+            if (seq == client.mIncomingReliableSeq)
+            {
+                client.mIncomingReliableSeq++;
+            }
+
+            client.mReliableAckDirty = true;
+
+            // The server asks for a Ready response in its first reliable packets.
+            if (!client.mSentReady)
+            {
+                NetMsgReady readyMsg;
+                SendBenchPacket(client, serverIp, serverPort, &readyMsg, nullptr, true);
+                client.mSentReady = true;
+            }
+        }
+        else
+        {
+            uint16_t shift = uint16_t(seq - client.mRepAckSeq);
+            client.mRepAckBits = (shift >= 32) ? 1u : ((client.mRepAckBits << shift) | 1u);
+            client.mRepAckSeq = seq;
+            client.mRepAckDirty = true;
+        }
+    }
+
+    if (client.mReliableAckDirty || client.mRepAckDirty)
+    {
+        NetMsgAck ackMsg;
+        ackMsg.mSequenceNumber = client.mIncomingReliableSeq;
+
+        NetMsgReplicateAck repAckMsg;
+        repAckMsg.mSequenceNumber = client.mRepAckSeq;
+        repAckMsg.mAckBits = client.mRepAckBits;
+
+        SendBenchPacket(
+            client,
+            serverIp,
+            serverPort,
+            client.mReliableAckDirty ? (const NetMsg*)&ackMsg : (const NetMsg*)&repAckMsg,
+            (client.mReliableAckDirty && client.mRepAckDirty) ? &repAckMsg : nullptr,
+            false);
+
+        client.mReliableAckDirty = false;
+        client.mRepAckDirty = false;
+    }
+}
+
+static bool AreBenchClientsReady(uint32_t numClients)
+{
+    const std::vector<NetClient>& clients = NetworkManager::Get()->GetClients();
+    bool ready = (clients.size() == numClients);
+
+    for (uint32_t i = 0; ready && i < clients.size(); ++i)
+    {
+        ready = clients[i].mReady;
+    }
+
+    return ready;
+}
+
+void RunReplicationBenchmark(const NetBenchmarkOptions& options)
+{
+    NetworkManager* netMan = NetworkManager::Get();
+    World* world = GetWorld(0);
+
+    if (!NET_IsActive() || world == nullptr || !netMan->IsLocal())
+    {
+        LogError("[NetBenchmark] Network must be active and not already in a session.");
+        return;
+    }
+
+    uint32_t numClients = glm::clamp<uint32_t>(options.mNumClients, 1, 255);
+    uint32_t numNodes = glm::max<uint32_t>(options.mNumNodes, 1);
+    uint32_t numTicks = glm::max<uint32_t>(options.mNumTicks, 1);
+    float deltaTime = 1.0f / glm::max(options.mTickRate, 1.0f);
+    sBenchRandState = 1;
+
+    bool broadcast = netMan->IsSessionBroadcastEnabled();
+
+    NetSessionOpenOptions sessionOptions;
+    sessionOptions.mName = "NetBenchmark";
+    sessionOptions.mMaxPlayers = int32_t(numClients + 1);
+    sessionOptions.mLan = true;
+    netMan->EnableSessionBroadcast(false);
+    netMan->OpenSession(sessionOptions);
+
+    if (!netMan->IsServer())
+    {
+        LogError("[NetBenchmark] Failed to open session.");
+        netMan->EnableSessionBroadcast(broadcast);
+        return;
+    }
+
+    const uint32_t loopback = NET_IpStringToUint32("127.0.0.1");
+    const uint16_t serverPort = sessionOptions.mPort;
+
+    std::vector<BenchClient> clients(numClients);
+
+    for (uint32_t i = 0; i < numClients; ++i)
+    {
+        clients[i].mSocket = NET_SocketCreate();
+        NET_SocketBind(clients[i].mSocket, loopback, 0);
+        NET_SocketSetBlocking(clients[i].mSocket, false);
+
+        NetMsgConnect connectMsg;
+        connectMsg.mGameCode = GetEngineState()->mGameCode;
+        connectMsg.mVersion = GetEngineState()->mVersion;
+        SendBenchPacket(clients[i], loopback, serverPort, &connectMsg, nullptr, false);
+
+        // Connect is handled outside of the sequenced stream.
+        clients[i].mOutgoingUnreliableSeq = 0;
+    }
+
+    // Connect and ready up all clients before measuring.
+    uint32_t handshakeTicks = 0;
+    while (!AreBenchClientsReady(numClients) && handshakeTicks < BENCH_MAX_HANDSHAKE_TICKS)
+    {
+        netMan->PreTickUpdate(deltaTime);
+        netMan->PostTickUpdate(deltaTime);
+
+        for (uint32_t i = 0; i < numClients; ++i)
+        {
+            UpdateBenchClient(clients[i], loopback, serverPort);
+        }
+
+        handshakeTicks++;
+    }
+
+    if (!AreBenchClientsReady(numClients))
+    {
+        LogWarning("[NetBenchmark] Only %u of %u clients connected.", (uint32_t)netMan->GetClients().size(), numClients);
+    }
+
+    // Spawn the replicated nodes under one parent so they are easy to clean up.
+    Node3D* benchRoot = Node::Construct<Node3D>();
+    benchRoot->SetName("NetBenchmark");
+    benchRoot->SetReplicate(true);
+
+    std::vector<Node3D*> nodes;
+    nodes.reserve(numNodes);
+
+    for (uint32_t i = 0; i < numNodes; ++i)
+    {
+        Node3D* node = benchRoot->CreateChild<Node3D>();
+        node->SetReplicate(true);
+        node->SetReplicateTransform(true);
+        node->SetPosition(glm::vec3(
+            BenchRandFloat(-BENCH_WORLD_EXTENT, BENCH_WORLD_EXTENT),
+            0.0f,
+            BenchRandFloat(-BENCH_WORLD_EXTENT, BENCH_WORLD_EXTENT)));
+        nodes.push_back(node);
+    }
+
+    if (world->GetRootNode() != nullptr)
+    {
+        world->GetRootNode()->AddChild(benchRoot);
+    }
+    else
+    {
+        world->SetRootNode(benchRoot);
+    }
+
+    if (!benchRoot->HasStarted())
+    {
+        benchRoot->Start();
+    }
+
+    uint64_t totalTime = 0;
+    uint64_t maxTime = 0;
+    uint64_t totalBytes = 0;
+    uint64_t totalMessages = 0;
+
+    for (uint32_t tick = 0; tick < numTicks; ++tick)
+    {
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+
+        netMan->PreTickUpdate(deltaTime);
+
+        for (uint32_t i = 0; i < nodes.size(); ++i)
+        {
+            glm::vec3 pos = nodes[i]->GetPosition();
+            pos.x += BenchRandFloat(-1.0f, 1.0f);
+            pos.z += BenchRandFloat(-1.0f, 1.0f);
+            nodes[i]->SetPosition(pos);
+        }
+
+        netMan->PostTickUpdate(deltaTime);
+
+        uint64_t tickTime = SYS_GetTimeMicroseconds() - startTime;
+        totalTime += tickTime;
+        maxTime = glm::max(maxTime, tickTime);
+        totalBytes += uint64_t(glm::max(netMan->GetBytesSent(), 0));
+        totalMessages += netMan->GetMessagesSent();
+
+        for (uint32_t i = 0; i < numClients; ++i)
+        {
+            UpdateBenchClient(clients[i], loopback, serverPort);
+        }
+    }
+
+    uint64_t totalReceived = 0;
+    for (uint32_t i = 0; i < numClients; ++i)
+    {
+        totalReceived += clients[i].mBytesReceived;
+    }
+
+    float simSeconds = numTicks * deltaTime;
+
+    LogDebug("[NetBenchmark] %u clients, %u nodes, %u ticks at %.0f Hz (%u handshake ticks)",
+        numClients, numNodes, numTicks, options.mTickRate, handshakeTicks);
+    LogDebug("[NetBenchmark] Sent %.1f KB/s (%.1f KB/s per client), %.1f messages/tick, clients received %.1f KB/s",
+        (totalBytes / 1024.0f) / simSeconds,
+        (totalBytes / 1024.0f) / simSeconds / numClients,
+        float(totalMessages) / numTicks,
+        (totalReceived / 1024.0f) / simSeconds);
+    LogDebug("[NetBenchmark] Server CPU %.3f ms/tick avg, %.3f ms/tick max",
+        (totalTime / 1000.0) / numTicks,
+        maxTime / 1000.0);
+
+    Node::Destruct(benchRoot);
+    benchRoot = nullptr;
+
+    netMan->CloseSession();
+    netMan->EnableSessionBroadcast(broadcast);
+
+    for (uint32_t i = 0; i < numClients; ++i)
+    {
+        NET_SocketClose(clients[i].mSocket);
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "EngineTypes.h"
+
+// Opens a server session and connects simulated clients to it over loopback, all in this process.
+// A set of replicated nodes is moved every tick and the server's replication cost is logged:
+// bytes per second, messages per tick and CPU time per tick. Use it to regression test replication changes.
+// Can be run from the command line with -netbench <clients> <nodes> <ticks>.
+void RunReplicationBenchmark(const NetBenchmarkOptions& options);
@@ -2,6 +2,7 @@
 #include "Engine.h"
 #include "Log.h"
 #include "Nodes/Node.h"
+#include "Nodes/3D/Node3d.h"
 #include "Assets/Scene.h"
 #include "World.h"
 #include "Profiler.h"
@@ -13,90 +14,149 @@
 #include "Network/NetPlatformEpic.h"
 #include "Network/NetPlatformSteam.h"
 
+#include <algorithm>
+
 #ifdef SendMessage
 #undef SendMessage
 #endif
 
 #define DEBUG_MSG_STATS 0
-#define DEBUG_NETWORK_CONDITIONS 0
 
 // Do we even need sRecvBuffer? We could probably just use stack space for reading/writing packet data.
 static char sRecvBuffer[OCT_RECV_BUFFER_SIZE] = {};
 static char sSendBuffer[OCT_SEND_BUFFER_SIZE] = {};
 
+// Datagrams are received and sent in batches to cut down on syscalls when serving many clients.
+#define OCT_NET_BATCH_SIZE 64
+static NetDatagram sRecvBatch[OCT_NET_BATCH_SIZE] = {};
+static char sRecvBatchData[OCT_NET_BATCH_SIZE][OCT_RECV_BUFFER_SIZE] = {};
+static NetDatagram sSendQueue[OCT_NET_BATCH_SIZE] = {};
+static char sSendQueueData[OCT_NET_BATCH_SIZE][OCT_SEND_BUFFER_SIZE] = {};
+static uint32_t sNumQueuedSends = 0;
+
+static uint64_t GetNetAddressKey(uint32_t ipAddress, uint16_t port)
+{
+    return (uint64_t(ipAddress) << 16) | port;
+}
+
 #if DEBUG_MSG_STATS
 static uint32_t sNumPacketsSent = 0;
 static uint32_t sNumPacketsReceived = 0;
 #endif
 
-#if DEBUG_NETWORK_CONDITIONS
-static float sPacketLossFrac = 0.5f;
-static float sLatencyMs = 80.0f;
-static float sJitterMs = 10.0f;
+// Server time estimation. Offsets that jump more than this are taken as is instead of smoothed.
+#define OCT_SERVER_TIME_SNAP 0.5
+#define OCT_SERVER_TIME_SMOOTHING 0.05
+
+static double GetLocalTime()
+{
+    return SYS_GetTimeMicroseconds() / 1000000.0;
+}
+
+// Network condition simulator state. See SetSimulatedConditions().
+#define OCT_NET_SIM_REORDER_DELAY_MS 50.0f
 
-struct DelayedPacket
+struct SimulatedPacket
 {
-    SocketHandle mSocket = {};
     float mTime = 0.0f;
     uint32_t mSize = 0;
-    char mData[OCT_MAX_MSG_BODY_SIZE] = {};
+    char mData[OCT_MAX_MSG_SIZE] = {};
     NetHost mHost;
 };
 
-static std::vector<DelayedPacket> sDelayedPackets;
+static std::vector<SimulatedPacket> sSimPackets;
+static uint32_t sSimRandState = 1;
 
-void DebugSendTo(const NetHost& host, uint32_t size, const char* data)
+static float SimRandFloat()
 {
-    float dropRoll = Maths::RandRange(0.0f, 1.0f);
+    // xorshift32, so results only depend on the seed and not on other users of rand().
+    sSimRandState ^= sSimRandState << 13;
+    sSimRandState ^= sSimRandState >> 17;
+    sSimRandState ^= sSimRandState << 5;
+    return (sSimRandState >> 8) * (1.0f / 16777216.0f);
+}
 
-    if (dropRoll >= sPacketLossFrac)
-    {
-        sDelayedPackets.emplace_back();
-        DelayedPacket& packet = sDelayedPackets.back();
+// Avoid dynamic allocations when appropriate. Reuse static messages.
+static NetMsgReplicate sMsgReplicate;
+static NetMsgReplicateScript sMsgReplicateScript;
+static NetMsgInvoke sMsgInvoke;
+static NetMsgInvokeScript sMsgInvokeScript;
 
-        packet.mTime = (1/1000.0f) * (sLatencyMs + Maths::RandRange(-sJitterMs, sJitterMs));
-        packet.mHost = host;
-        packet.mSize = size;
-        memcpy(packet.mData, data, size);
+// Scratch stream for encoding replication snapshots
+static Stream sRepEncodeStream;
+
+// Replicate messages still waiting on an ack are dropped beyond this, which just causes a resend.
+#define OCT_MAX_REP_PENDING 512
+
+// Pending entries are recycled through a per client free list so their buffers keep their capacity.
+static NetRepPending& AllocRepPending(NetClient* client)
+{
+    if (client->mRepPendingFree.empty())
+    {
+        client->mRepPending.emplace_back();
     }
     else
     {
-        //LogWarning("Dropping packet");
+        client->mRepPending.push_back(std::move(client->mRepPendingFree.back()));
+        client->mRepPendingFree.pop_back();
     }
+
+    NetRepPending& pending = client->mRepPending.back();
+    pending.mIndices.clear();
+    pending.mOffsets.clear();
+    pending.mData.clear();
+    return pending;
 }
 
-void UpdateDebugPackets(float deltaTime)
+// Leaves the entry empty, callers are still responsible for removing it from mRepPending.
+static void RecycleRepPending(NetClient* client, NetRepPending& pending)
 {
-    for (int32_t i = 0; i < int32_t(sDelayedPackets.size()); ++i)
-    {
-        sDelayedPackets[i].mTime -= deltaTime;
-
-        if (sDelayedPackets[i].mTime <= 0.0f)
-        {
-            NetworkManager::Get()->SendTo(
-                sDelayedPackets[i].mHost,
-                sDelayedPackets[i].mData,
-                sDelayedPackets[i].mSize);
+    client->mRepPendingFree.push_back(std::move(pending));
+}
 
-            sDelayedPackets.erase(sDelayedPackets.begin() + i);
-            --i;
-        }
-    }
+static void RemoveRepPending(NetClient* client, uint32_t index)
+{
+    RecycleRepPending(client, client->mRepPending[index]);
+    client->mRepPending.erase(client->mRepPending.begin() + index);
 }
 
-#endif
+// Interest management
+#define OCT_RELEVANCY_INTERVAL 0.2f
+#define OCT_RELEVANCY_CELL_SIZE 64.0f
+#define OCT_RELEVANCY_MIN_SCALE 0.25f
 
-// Avoid dynamic allocations when appropriate. Reuse static messages.
-static NetMsgReplicate sMsgReplicate;
-static NetMsgReplicateScript sMsgReplicateScript;
-static NetMsgInvoke sMsgInvoke;
-static NetMsgInvokeScript sMsgInvokeScript;
+enum class RelevancyState : uint8_t
+{
+    Pending,
+    Accepted,
+    Rejected
+};
+
+struct RelevancyEntry
+{
+    float mScale = 1.0f;
+    RelevancyState mState = RelevancyState::Pending;
+};
+
+static std::unordered_map<uint64_t, std::vector<Node*>> sRelevancyGrid;
+static std::vector<Node*> sRelevancyGridNodes;      // Every node in the grid, for clients without a view
+static std::vector<Node*> sRelevancyOtherNodes;     // Always, OwnerOnly, non-3D and unlimited distance nodes
+static std::unordered_map<NetHostId, std::vector<Node*>> sRelevancyOwnedNodes; // Grid nodes by owner
+static std::unordered_map<Node*, RelevancyEntry> sRelevancyDesired;
+static std::vector<Node*> sRelevancyRemoved;
+static std::vector<NetRelevantNode*> sRepCandidates;
 
 // Reliable messaging
-static float sReliableResendTime = 0.1f;
+static float sMinReliableResendTime = 0.05f;
+static float sMaxReliableResendTime = 1.0f;
 static uint32_t sMaxReliableResends = 20;
 static uint32_t sMaxOutgoingPackets = 100;
-static uint32_t sMaxIncomingPackets = 100;
+
+static uint32_t GetNumOutgoingReliablePackets(const NetHostProfile& profile)
+{
+    uint16_t numInFlight = profile.mOutgoingReliableEnd - profile.mOutgoingReliableBase;
+    return uint32_t(numInFlight) + profile.mOutgoingQueue.GetSize();
+}
 
 #define NET_MSG_CASE(Type) \
     case NetMsgType::Type: \
@@ -230,6 +290,7 @@ void NetworkManager::PreTickUpdate(float deltaTime)
     mDownloadRate = Maths::Damp(mDownloadRate, (float)frameDownloadRate, 0.05f, deltaTime);
     mBytesSent = 0;
     mBytesReceived = 0;
+    mMessagesSent = 0;
 
     if (mNetStatus == NetStatus::Connecting)
     {
@@ -257,6 +318,12 @@ void NetworkManager::PreTickUpdate(float deltaTime)
         // Handle incoming messages from the server or clients
         ProcessIncomingPackets(deltaTime);
 
+        if (mNetStatus == NetStatus::Client &&
+            !mInterpolatedNodes.empty())
+        {
+            UpdateInterpolation();
+        }
+
         // Handle upkeep of unreliable messages that still need ACKs from recipients
         UpdateReliablePackets(deltaTime);
 
@@ -301,13 +368,16 @@ void NetworkManager::PostTickUpdate(float deltaTime)
             SendMessage(&pingMsg, &mServer);
             mPingTimer = 0.0f;
         }
+
+        SendReplicateAck();
     }
 
-    FlushSendBuffers();
+    if (!sSimPackets.empty())
+    {
+        UpdateSimulatedPackets(deltaTime);
+    }
 
-#if DEBUG_NETWORK_CONDITIONS
-    UpdateDebugPackets(deltaTime);
-#endif
+    FlushSendBuffers();
 }
 
 void NetworkManager::Login()
@@ -684,6 +754,7 @@ void NetworkManager::Kick(NetHostId hostId, NetMsgKick::Reason reason)
 
             LogDebug("Kicking client %08x:%u", mClients[i].mHost.mIpAddress, mClients[i].mHost.mPort);
             mClients.erase(mClients.begin() + i);
+            RebuildClientLookup();
             break;
         }
     }
@@ -743,9 +814,29 @@ void NetworkManager::SendMessage(const NetMsg* netMsg, NetHostProfile* hostProfi
             FlushSendBuffer(hostProfile, reliable);
         }
 
+        if (sendBuffer.empty() &&
+            !reliable &&
+            mNetStatus == NetStatus::Server)
+        {
+            // Stamp each unreliable packet with the server time so clients can place the
+            // snapshots it carries on a timeline for interpolation.
+            NetMsgServerTime timeMsg;
+            timeMsg.mTimeMs = uint32_t(uint64_t(GetLocalTime() * 1000.0));
+
+            char timeData[16] = {};
+            Stream timeStream(timeData, sizeof(timeData));
+            timeMsg.Write(timeStream);
+
+            if (timeStream.GetPos() + stream.GetPos() <= OCT_MAX_MSG_BODY_SIZE)
+            {
+                sendBuffer.insert(sendBuffer.end(), timeData, timeData + timeStream.GetPos());
+            }
+        }
+
         uint32_t startByte = (uint32_t)sendBuffer.size();
         sendBuffer.resize(sendBuffer.size() + stream.GetPos());
         memcpy(sendBuffer.data() + startByte, stream.GetData(), stream.GetPos());
+        mMessagesSent++;
     }
 }
 
@@ -772,14 +863,10 @@ void NetworkManager::SendMessageImmediate(const NetHost& host, const NetMsg* net
 
     if (stream.GetPos() <= OCT_MAX_MSG_BODY_SIZE)
     {
-
-#if DEBUG_NETWORK_CONDITIONS
-        DebugSendTo(host, stream.GetPos(), stream.GetData());
-#else
         SendTo(host,
                stream.GetData(),
                stream.GetPos());
-#endif
+        mMessagesSent++;
 
 #if DEBUG_MSG_STATS
         sNumPacketsSent++;
@@ -795,19 +882,46 @@ void NetworkManager::SendMessageImmediate(const NetHost& host, const NetMsg* net
 NetClient* NetworkManager::FindNetClient(NetHostId id)
 {
     NetClient* retClient = nullptr;
+    int16_t index = mClientIndexById[id];
 
-    for (uint32_t i = 0; i < mClients.size(); ++i)
+    if (index >= 0 && index < int16_t(mClients.size()))
     {
-        if (mClients[i].mHost.mId == id)
-        {
-            retClient = &mClients[i];
-            break;
-        }
+        OCT_ASSERT(mClients[index].mHost.mId == id);
+        retClient = &mClients[index];
     }
 
     return retClient;
 }
 
+void NetworkManager::SetSimulatedConditions(const NetSimConditions& conditions)
+{
+    mSimConditions = conditions;
+    mSimEnabled =
+        conditions.mLatencyMs > 0.0f ||
+        conditions.mJitterMs > 0.0f ||
+        conditions.mPacketLoss > 0.0f ||
+        conditions.mDuplicate > 0.0f ||
+        conditions.mReorder > 0.0f;
+
+    sSimRandState = (conditions.mSeed != 0) ? conditions.mSeed : 1;
+
+    if (mSimEnabled)
+    {
+        LogDebug("Simulating network conditions: latency %.1f ms, jitter %.1f ms, loss %.3f, duplicate %.3f, reorder %.3f, seed %u",
+            conditions.mLatencyMs,
+            conditions.mJitterMs,
+            conditions.mPacketLoss,
+            conditions.mDuplicate,
+            conditions.mReorder,
+            conditions.mSeed);
+    }
+}
+
+const NetSimConditions& NetworkManager::GetSimulatedConditions() const
+{
+    return mSimConditions;
+}
+
 NetStatus NetworkManager::GetNetStatus() const
 {
     return mNetStatus;
@@ -823,6 +937,106 @@ bool NetworkManager::IsIncrementalReplicationEnabled() const
     return mIncrementalReplication;
 }
 
+void NetworkManager::SetClientViewNode(NetHostId hostId, Node* node)
+{
+    NetClient* client = FindNetClient(hostId);
+
+    if (client != nullptr)
+    {
+        client->mViewNetId = node ? node->GetNetId() : INVALID_NET_ID;
+    }
+}
+
+void NetworkManager::SetClientViewPosition(NetHostId hostId, glm::vec3 position)
+{
+    NetClient* client = FindNetClient(hostId);
+
+    if (client != nullptr)
+    {
+        client->mViewPosition = position;
+        client->mHasViewPosition = true;
+    }
+}
+
+void NetworkManager::SetRelevancyDistance(float distance)
+{
+    mRelevancyDistance = glm::max(distance, 0.0f);
+}
+
+float NetworkManager::GetRelevancyDistance() const
+{
+    return mRelevancyDistance;
+}
+
+void NetworkManager::SetReplicationBandwidth(uint32_t bytesPerSecond)
+{
+    mReplicationBandwidth = bytesPerSecond;
+}
+
+uint32_t NetworkManager::GetReplicationBandwidth() const
+{
+    return mReplicationBandwidth;
+}
+
+void NetworkManager::SetInterpolationDelay(float delay)
+{
+    mInterpolationDelay = glm::max(delay, 0.0f);
+}
+
+float NetworkManager::GetInterpolationDelay() const
+{
+    return mInterpolationDelay;
+}
+
+void NetworkManager::SetMaxExtrapolation(float maxTime)
+{
+    mMaxExtrapolation = glm::max(maxTime, 0.0f);
+}
+
+float NetworkManager::GetMaxExtrapolation() const
+{
+    return mMaxExtrapolation;
+}
+
+double NetworkManager::GetServerTime() const
+{
+    return (mNetStatus == NetStatus::Client) ? (GetLocalTime() + mServerTimeOffset) : GetLocalTime();
+}
+
+double NetworkManager::GetPacketServerTime() const
+{
+    return mPacketServerTime;
+}
+
+void NetworkManager::AddInterpolatedNode(Node3D* node)
+{
+    if (std::find(mInterpolatedNodes.begin(), mInterpolatedNodes.end(), node) == mInterpolatedNodes.end())
+    {
+        mInterpolatedNodes.push_back(node);
+    }
+}
+
+void NetworkManager::RemoveInterpolatedNode(Node3D* node)
+{
+    auto it = std::find(mInterpolatedNodes.begin(), mInterpolatedNodes.end(), node);
+
+    if (it != mInterpolatedNodes.end())
+    {
+        *it = mInterpolatedNodes.back();
+        mInterpolatedNodes.pop_back();
+    }
+}
+
+void NetworkManager::UpdateInterpolation()
+{
+    double renderTime = GetServerTime() - mInterpolationDelay;
+
+    for (uint32_t i = 0; i < mInterpolatedNodes.size(); ++i)
+    {
+        mInterpolatedNodes[i]->UpdateNetInterpolation(renderTime, mMaxExtrapolation);
+    }
+}
+
 int32_t NetworkManager::GetBytesSent() const
 {
     return mBytesSent;
@@ -832,6 +1046,11 @@ int32_t NetworkManager::GetBytesReceived() const
 {
     return mBytesReceived;
 }
+
+uint32_t NetworkManager::GetMessagesSent() const
+{
+    return mMessagesSent;
+}
     
 float NetworkManager::GetUploadRate() const
 {
@@ -904,10 +1123,33 @@ void NetworkManager::AddNetNode(Node* node, NetId netId)
                     repNodeVector.push_back(node);
                 }
 
-                // The server needs to send Spawn messages for newly added network actors.
+                // The server needs to send Spawn messages for newly added network actors,
+                // but only to the clients it is relevant to. The relevancy pass picks up the rest later.
                 if (NetIsServer())
                 {
-                    NetworkManager::Get()->SendSpawnMessage(node, nullptr);
+                    for (uint32_t i = 0; i < mClients.size(); ++i)
+                    {
+                        NetClient* client = &mClients[i];
+                        Node* parent = node->GetParent();
+
+                        // The client can't spawn this node if its replicated parent isn't spawned there.
+                        if (parent != nullptr &&
+                            parent->GetNetId() != INVALID_NET_ID &&
+                            client->mRelevantNodes.find(parent->GetNetId()) == client->mRelevantNodes.end())
+                        {
+                            continue;
+                        }
+
+                        glm::vec3 viewPos;
+                        bool hasView = GetClientViewPosition(client, viewPos);
+                        float scale = 1.0f;
+
+                        if (IsNodeRelevant(node, client, hasView ? &viewPos : nullptr, scale))
+                        {
+                            SendSpawnMessage(node, client);
+                            AddRelevantNode(client, node, true);
+                        }
+                    }
                 }
             }
         }
@@ -924,15 +1166,30 @@ void NetworkManager::RemoveNetNode(Node* node)
 
     if (netId != INVALID_NET_ID)
     {
-        // Send destroy message
+        // Send destroy message to the clients that have this node spawned
         if (NetIsServer())
         {
-            NetworkManager::Get()->SendDestroyMessage(node, nullptr);
+            for (uint32_t i = 0; i < mClients.size(); ++i)
+            {
+                auto it = mClients[i].mRelevantNodes.find(netId);
+
+                if (it != mClients[i].mRelevantNodes.end())
+                {
+                    SendDestroyMessage(node, &mClients[i]);
+                    RemoveRelevantNode(&mClients[i], node);
+                }
+            }
         }
 
         // This node was assigned a net id, so it should exist in our net actor map.
         OCT_ASSERT(mNetNodeMap.find(netId) != mNetNodeMap.end());
         mNetNodeMap.erase(netId);
+
+        mRepSnapshots.erase(netId);
+        for (uint32_t i = 0; i < mClients.size(); ++i)
+        {
+            mClients[i].mRepBaselines.erase(netId);
+        }
     }
 }
 
@@ -989,6 +1246,7 @@ void NetworkManager::HandleConnect(NetHost host, uint32_t gameCode, uint32_t ver
             newClient->mHost.mPort = host.mPort;
             newClient->mHost.mId = FindAvailableNetHostId();
             newClient->mHost.mOnlineId = host.mOnlineId;
+            RebuildClientLookup();
 
             NetMsgAccept acceptMsg;
             acceptMsg.mAssignedHostId = newClient->mHost.mId;
@@ -999,7 +1257,10 @@ void NetworkManager::HandleConnect(NetHost host, uint32_t gameCode, uint32_t ver
             {
                 if (node->IsReplicated())
                 {
+                    // The client has no view yet, so everything is relevant until the next relevancy pass.
+                    // Initial state is sent once the client is ready.
                     SendSpawnMessage(node, newClient);
+                    AddRelevantNode(newClient, node, false);
                     return true;
                 }
 
@@ -1113,6 +1374,7 @@ void NetworkManager::HandleDisconnect(NetHost host)
                     }
 
                     mClients.erase(mClients.begin() + i);
+                    RebuildClientLookup();
                     removed = true;
                     break;
                 }
@@ -1143,24 +1405,154 @@ void NetworkManager::HandleKick(NetMsgKick::Reason reason)
     }
 }
 
-void NetworkManager::HandleAck(NetHost host, uint16_t sequenceNumber)
+void NetworkManager::HandleAck(NetHost host, uint16_t sequenceNumber, uint32_t ackBits)
 {
     NetHostProfile* profile = NetIsServer() ? FindNetClient(host.mId) : &mServer;
 
     if (profile != nullptr)
     {
-        // Remove the reliable packet with matching sequence number from our outgoing list
-        std::vector<ReliablePacket>& packets = profile->mOutgoingPackets;
+        auto isAcked = [&](uint16_t seq) -> bool
+        {
+            uint16_t bit = uint16_t(seq - sequenceNumber - 1);
+            return SeqNumLess(seq, sequenceNumber) || (bit < 32 && (ackBits & (1u << bit)));
+        };
 
-        for (uint32_t i = 0; i < packets.size(); ++i)
+        // Free every acked packet in the send window.
+        uint64_t now = SYS_GetTimeMicroseconds();
+
+        for (uint32_t i = 0; i < OCT_RELIABLE_WINDOW_SIZE; ++i)
         {
-            if (packets[i].mSeq == sequenceNumber)
+            ReliablePacket& packet = profile->mOutgoingWindow[i];
+
+            if (packet.mActive && isAcked(packet.mSeq))
             {
-                //LogDebug("ACK: %d", sequenceNumber);
-                packets.erase(packets.begin() + i);
-                break;
+                // Only sample packets that were sent once, otherwise we can't tell which send was acked.
+                if (packet.mNumSends == 1)
+                {
+                    UpdateReliableRtt(profile, (now - packet.mSendTime) / 1000000.0f);
+                }
+
+                packet.mActive = false;
+                packet.mSize = 0;
+            }
+        }
+
+        while (profile->mOutgoingReliableBase != profile->mOutgoingReliableEnd &&
+            !profile->mOutgoingWindow[profile->mOutgoingReliableBase % OCT_RELIABLE_WINDOW_SIZE].mActive)
+        {
+            profile->mOutgoingReliableBase++;
+        }
+
+        // Later packets arrived but the oldest one didn't, so it was most likely lost.
+        // Resend it now instead of waiting for the timeout so the receiver isn't stalled.
+        ReliablePacket& oldest = profile->mOutgoingWindow[profile->mOutgoingReliableBase % OCT_RELIABLE_WINDOW_SIZE];
+
+        if (ackBits != 0 &&
+            oldest.mActive &&
+            oldest.mSeq == sequenceNumber &&
+            (now - oldest.mSendTime) / 1000000.0f >= profile->mSmoothedRtt)
+        {
+            ResendPacket(profile, oldest);
+        }
+
+        // Reliable replicate messages (initial state, forced replication) are now in the client's baseline.
+        std::vector<NetRepPending>& pending = profile->mRepPending;
+
+        for (uint32_t i = 0; i < pending.size(); ++i)
+        {
+            if (pending[i].mReliable && isAcked(pending[i].mSeq))
+            {
+                CommitRepPending(profile, pending[i]);
+                RemoveRepPending(profile, i);
+                --i;
+            }
+        }
+
+        // Acks free up room in the window for queued packets.
+        SendReliablePackets(profile);
+    }
+}
+
+void NetworkManager::HandleReplicateAck(NetHost host, uint16_t sequenceNumber, uint32_t ackBits)
+{
+    NetClient* client = NetIsServer() ? FindNetClient(host.mId) : nullptr;
+
+    if (client != nullptr)
+    {
+        std::vector<NetRepPending>& pending = client->mRepPending;
+        uint32_t numKept = 0;
+
+        for (uint32_t i = 0; i < pending.size(); ++i)
+        {
+            bool keep = true;
+
+            if (!pending[i].mReliable &&
+                !SeqNumLess(sequenceNumber, pending[i].mSeq))
+            {
+                // Clients drop unreliable packets that arrive out of order, so anything at or before the
+                // acked seq either made it (bit set) or never will. Lost values are simply resent because
+                // the baseline no longer matches the current state.
+                uint16_t age = uint16_t(sequenceNumber - pending[i].mSeq);
+
+                if (age < 32 && (ackBits & (1u << age)))
+                {
+                    CommitRepPending(client, pending[i]);
+                }
+
+                keep = false;
+            }
+
+            if (!keep)
+            {
+                RecycleRepPending(client, pending[i]);
+            }
+            else
+            {
+                if (numKept != i)
+                {
+                    pending[numKept] = std::move(pending[i]);
+                }
+
+                numKept++;
             }
         }
+
+        pending.resize(numKept);
+    }
+}
+
+void NetworkManager::HandleServerTime(uint32_t timeMs)
+{
+    if (mNetStatus != NetStatus::Client)
+        return;
+
+    double serverTime = timeMs / 1000.0;
+    double offset = serverTime - GetLocalTime();
+
+    // Smooth out network jitter, but take large jumps (first packet, clock wrap) right away.
+    if (!mHasServerTime ||
+        glm::abs(offset - mServerTimeOffset) > OCT_SERVER_TIME_SNAP)
+    {
+        mServerTimeOffset = offset;
+    }
+    else
+    {
+        mServerTimeOffset += (offset - mServerTimeOffset) * OCT_SERVER_TIME_SMOOTHING;
+    }
+
+    mHasServerTime = true;
+    mPacketServerTime = serverTime;
+}
+
+void NetworkManager::SendReplicateAck()
+{
+    if (mServer.mRepAckDirty)
+    {
+        NetMsgReplicateAck ackMsg;
+        ackMsg.mSequenceNumber = mServer.mRepAckSeq;
+        ackMsg.mAckBits = mServer.mRepAckBits;
+        SendMessage(&ackMsg, &mServer);
+        mServer.mRepAckDirty = false;
     }
 }
 
@@ -1186,12 +1578,19 @@ void NetworkManager::HandleReady(NetHost host)
             ResendOutgoingReliablePackets(client);
 
             // Now that client has loaded the level(s) and spawned actors,
-            // Forcefully replicate the initial state of all actors
+            // Forcefully replicate the initial state of all actors.
+            // Bump the frame so snapshots are encoded with the current values.
+            ++mRepFrame;
+
             auto repNode = [&](Node* node) -> bool
             {
                 if (node->IsReplicated())
                 {
-                    ReplicateNode(node, client->mHost.mId, true, true);
+                    if (client->mRelevantNodes.find(node->GetNetId()) != client->mRelevantNodes.end())
+                    {
+                        UpdateRepSnapshot(node);
+                        ReplicateNode(node, client, true, true);
+                    }
                     return true;
                 }
 
@@ -1257,36 +1656,75 @@ void NetworkManager::HandleBroadcast(
     }
 }
 
-static const uint32_t RepMsgHeaderSize = 
-    sizeof(NetMsgReplicate::mNodeNetId) +
-    sizeof(NetMsgReplicate::mNumVariables);
+// Worst case header: type byte + varuint net id + varuint schema count + varuint payload size.
+static const uint32_t RepMsgHeaderSize = 1 + 5 + 3 + 3;
 
-static const uint32_t MaxDatumNetSerializeSize = 
-    OCT_MAX_MSG_BODY_SIZE - 
-    RepMsgHeaderSize -
-    sizeof(uint16_t); // 1 index
+static const uint32_t MaxRepMsgBits = 
+    (OCT_MAX_MSG_BODY_SIZE - 1) * 8;
 
-void NetworkManager::SendReplicateMsg(NetMsgReplicate& repMsg, uint32_t& numVars, NetHostId hostId)
+void NetworkManager::SendReplicateMsg(NetMsgReplicate& repMsg, uint32_t& numVars, NetClient* client, uint8_t channel, const std::vector<NetRepVarState>& snapshot)
 {
     OCT_ASSERT(numVars > 0);
+    OCT_ASSERT(client != nullptr);
 
     repMsg.mNumVariables = numVars;
+    SendMessage(&repMsg, client);
 
-    if (hostId == INVALID_HOST_ID)
+    // Remember what was sent so the client's baseline can advance once the packet is acked.
+    // SendMessage() flushes first if needed, so the current seq is the packet this message went into.
+    if (client->mRepPending.size() >= OCT_MAX_REP_PENDING)
     {
-        SendMessageToAllClients(&repMsg);
+        RemoveRepPending(client, 0);
     }
-    else
+
+    NetRepPending& pending = AllocRepPending(client);
+    pending.mNetId = repMsg.mNodeNetId;
+    pending.mSerial = client->mNextRepSerial++;
+    pending.mReliable = repMsg.mReliable;
+    pending.mSeq = repMsg.mReliable ? client->mOutgoingReliableSeq : client->mOutgoingUnreliableSeq;
+    pending.mChannel = channel;
+    pending.mIndices = repMsg.mIndices;
+    pending.mOffsets.reserve(numVars + 1);
+    pending.mOffsets.push_back(0);
+
+    for (uint32_t i = 0; i < numVars; ++i)
     {
-        SendMessage(&repMsg, hostId);
+        const std::vector<uint8_t>& varData = snapshot[repMsg.mIndices[i]].mData;
+        pending.mData.insert(pending.mData.end(), varData.begin(), varData.end());
+        pending.mOffsets.push_back((uint32_t)pending.mData.size());
     }
 
     repMsg.mIndices.clear();
-    repMsg.mData. clear();
+    repMsg.mDatums.clear();
     repMsg.mNumVariables = 0;
     numVars = 0;
 }
 
+void NetworkManager::CommitRepPending(NetClient* client, const NetRepPending& pending)
+{
+    // Don't recreate baselines for nodes that were destroyed while the message was in flight.
+    auto it = client->mRepBaselines.find(pending.mNetId);
+    if (it == client->mRepBaselines.end())
+        return;
+
+    std::vector<NetRepVarState>& vars = it->second.mVars[pending.mChannel];
+
+    for (uint32_t i = 0; i < pending.mIndices.size(); ++i)
+    {
+        uint16_t index = pending.mIndices[i];
+
+        // Acks can arrive out of order, only move the baseline forward.
+        if (index < vars.size() &&
+            pending.mSerial > vars[index].mSerial)
+        {
+            vars[index].mData.assign(
+                pending.mData.begin() + pending.mOffsets[i],
+                pending.mData.begin() + pending.mOffsets[i + 1]);
+            vars[index].mSerial = pending.mSerial;
+        }
+    }
+}
+
 void NetworkManager::SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func, uint32_t numParams, const Datum** params)
 {
     NetFuncType type = func->mType;
@@ -1298,12 +1736,9 @@ void NetworkManager::SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func,
     msg.mNumParams = numParams;
     msg.mReliable = func->mReliable;
 
-    msg.mParams.clear();
-
-    for (uint32_t i = 0; i < numParams; ++i)
-    {
-        msg.mParams.push_back(Datum(*params[i]));
-    }
+    // Messages are serialized immediately in SendMessage(), so the params can be written
+    // straight from the caller's Datums instead of copying them into the message.
+    msg.mSendParams = params;
 
     switch (type)
     {
@@ -1329,6 +1764,8 @@ void NetworkManager::SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func,
 
     case NetFuncType::Count: OCT_ASSERT(0); break;
     }
+
+    msg.mSendParams = nullptr;
 }
 
 void NetworkManager::SendInvokeMsg(Node* actor, NetFunc* func, uint32_t numParams, const Datum** params)
@@ -1392,10 +1829,14 @@ void NetworkManager::ResendPacket(NetHostProfile* hostProfile, ReliablePacket& p
 {
     // Resend the packet
     SendTo(hostProfile->mHost,
-        packet.mData.data(),
-        (uint32_t)packet.mData.size());
+        packet.mData,
+        packet.mSize);
+
+#if DEBUG_MSG_STATS
+    sNumPacketsSent++;
+#endif
 
-    packet.mTimeSinceSend = 0.0f;
+    packet.mSendTime = SYS_GetTimeMicroseconds();
     packet.mNumSends++;
 }
 
@@ -1404,31 +1845,101 @@ void NetworkManager::ResendOutgoingReliablePackets(NetHostProfile* hostProfile)
     if (hostProfile != nullptr &&
         hostProfile->mReady)
     {
-        std::vector<ReliablePacket>& packets = hostProfile->mOutgoingPackets;
-
-        for (uint32_t i = 0; i < packets.size(); ++i)
+        for (uint32_t i = 0; i < OCT_RELIABLE_WINDOW_SIZE; ++i)
         {
-            // TODO: UHHH WHAT? This was empty? NEED to implement this??? I would think so?
-            // Or maybe we don't need it because we hold on to all reliable messages until the client is ready
-            // and then they get sent after. See FlushSendBuffer() and UpdateReliablePackets(NetHostProfile*, float))
+            if (hostProfile->mOutgoingWindow[i].mActive)
+            {
+                ResendPacket(hostProfile, hostProfile->mOutgoingWindow[i]);
+            }
         }
+
+        // Reliable messages are held back until the host is ready, so send everything that was queued up.
+        SendReliablePackets(hostProfile);
     }
 }
 
-void NetworkManager::FlushSendBuffers()
+void NetworkManager::SendReliablePackets(NetHostProfile* profile)
 {
-    if (mNetStatus == NetStatus::Server)
+    // Move queued packets into the send window while there is room.
+    while (profile->mReady &&
+        !profile->mOutgoingQueue.IsEmpty() &&
+        uint16_t(profile->mOutgoingReliableEnd - profile->mOutgoingReliableBase) < OCT_RELIABLE_WINDOW_SIZE)
     {
-        for (uint32_t i = 0; i < mClients.size(); ++i)
-        {
-            FlushSendBuffers(&mClients[i]);
-        }
+        const ReliablePacket& queued = profile->mOutgoingQueue.Front();
+        OCT_ASSERT(queued.mSeq == profile->mOutgoingReliableEnd);
+        ReliablePacket& packet = profile->mOutgoingWindow[profile->mOutgoingReliableEnd % OCT_RELIABLE_WINDOW_SIZE];
+        OCT_ASSERT(!packet.mActive);
+
+        packet.SetData(queued.mSeq, queued.mData, queued.mSize);
+        packet.mActive = true;
+        packet.mNumSends = 0;
+        profile->mOutgoingQueue.Pop();
+        profile->mOutgoingReliableEnd++;
+
+        ResendPacket(profile, packet);
     }
-    else if (mNetStatus == NetStatus::Client ||
-            mNetStatus == NetStatus::Connecting)
+}
+
+void NetworkManager::SendReliableAck(NetHostProfile* profile)
+{
+    if (profile->mReliableAckDirty &&
+        profile->mReady)
+    {
+        NetMsgAck ackMsg;
+        ackMsg.mSequenceNumber = profile->mIncomingReliableSeq;
+
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            uint16_t seq = uint16_t(profile->mIncomingReliableSeq + 1 + i);
+            const ReliablePacket& packet = profile->mIncomingWindow[seq % OCT_RELIABLE_WINDOW_SIZE];
+
+            if (packet.mActive && packet.mSeq == seq)
+            {
+                ackMsg.mAckBits |= (1u << i);
+            }
+        }
+
+        SendMessage(&ackMsg, profile);
+        profile->mReliableAckDirty = false;
+    }
+}
+
+void NetworkManager::UpdateReliableRtt(NetHostProfile* profile, float rtt)
+{
+    // Smoothed RTT and variance as in RFC 6298.
+    if (profile->mSmoothedRtt <= 0.0f)
+    {
+        profile->mSmoothedRtt = rtt;
+        profile->mRttVariance = rtt * 0.5f;
+    }
+    else
+    {
+        profile->mRttVariance = 0.75f * profile->mRttVariance + 0.25f * fabsf(profile->mSmoothedRtt - rtt);
+        profile->mSmoothedRtt = 0.875f * profile->mSmoothedRtt + 0.125f * rtt;
+    }
+
+    profile->mResendTimeout = glm::clamp(
+        profile->mSmoothedRtt + 4.0f * profile->mRttVariance,
+        sMinReliableResendTime,
+        sMaxReliableResendTime);
+}
+
+void NetworkManager::FlushSendBuffers()
+{
+    if (mNetStatus == NetStatus::Server)
+    {
+        for (uint32_t i = 0; i < mClients.size(); ++i)
+        {
+            FlushSendBuffers(&mClients[i]);
+        }
+    }
+    else if (mNetStatus == NetStatus::Client ||
+            mNetStatus == NetStatus::Connecting)
     {
         FlushSendBuffers(&mServer);
     }
+
+    FlushSendQueue();
 }
 
 void NetworkManager::UpdateReplication(float deltaTime)
@@ -1440,6 +1951,15 @@ void NetworkManager::UpdateReplication(float deltaTime)
     Node* incRepNode = nullptr;
     World* world = GetWorld(0);
 
+    ++mRepFrame;
+
+    mRelevancyTimer -= deltaTime;
+    if (mRelevancyTimer <= 0.0f)
+    {
+        UpdateRelevancy();
+        mRelevancyTimer = OCT_RELEVANCY_INTERVAL;
+    }
+
     if (mIncrementalReplication)
     {
         uint32_t& incTier = world->GetIncrementalRepTier();
@@ -1465,129 +1985,571 @@ void NetworkManager::UpdateReplication(float deltaTime)
         }
     }
 
-    uint32_t numNodesReplicated = 0;
+    // Forced replication goes out reliably to every client that has the node, right away.
+    for (uint32_t t = 0; t < (uint32_t)ReplicationRate::Count; ++t)
+    {
+        const std::vector<Node*>& repVector = world->GetReplicatedNodeVector((ReplicationRate)t);
+
+        for (uint32_t i = 0; i < repVector.size(); ++i)
+        {
+            Node* node = repVector[i];
+
+            if (node->NeedsForcedReplication())
+            {
+                UpdateRepSnapshot(node);
+
+                for (uint32_t c = 0; c < mClients.size(); ++c)
+                {
+                    auto it = mClients[c].mRelevantNodes.find(node->GetNetId());
+
+                    if (mClients[c].mReady &&
+                        it != mClients[c].mRelevantNodes.end())
+                    {
+                        ReplicateNode(node, &mClients[c], true, true);
+                        it->second.mPriority = 0.0f;
+                    }
+                }
+
+                node->ClearForcedReplication();
+            }
+        }
+    }
+
+    // Priority is accumulated per client, scaled by the replication rate tier and distance to the client's view.
+    // High/Medium/Low tiers at full scale go out every 1/2/4 updates, like the old fixed rates.
+    static const float sRateWeights[(uint32_t)ReplicationRate::Count] = { 0.25f, 0.5f, 1.0f };
 
-    auto replicateTier = [this, incRepNode, &numNodesReplicated](const std::vector<Node*>& repVector, uint32_t& repIndex, uint32_t count)
+    for (uint32_t c = 0; c < mClients.size(); ++c)
     {
-        // Loop back around if the index is somehow past the vector size already
-        if (repIndex >= repVector.size())
+        NetClient* client = &mClients[c];
+
+        // Packets aren't sent until the client is ready, so there's nothing that could be acked.
+        if (!client->mReady)
+            continue;
+
+        sRepCandidates.clear();
+
+        for (auto& relIt : client->mRelevantNodes)
+        {
+            NetRelevantNode& rel = relIt.second;
+            Node* node = rel.mNode;
+
+            if (rel.mNeedsInitialRep)
+            {
+                // Newly spawned, send the full state reliably so it can't arrive before the spawn.
+                UpdateRepSnapshot(node);
+                ReplicateNode(node, client, true, true);
+                rel.mNeedsInitialRep = false;
+                rel.mPriority = 0.0f;
+                continue;
+            }
+
+            rel.mPriority += sRateWeights[(uint32_t)node->GetReplicationRate()] * rel.mScale;
+
+            if (node == incRepNode)
+            {
+                rel.mPriority = glm::max(rel.mPriority, 1.0f);
+            }
+
+            if (rel.mPriority >= 1.0f)
+            {
+                sRepCandidates.push_back(&rel);
+            }
+        }
+
+        // Spend the bandwidth budget on the highest priority nodes first. Nodes that don't make it
+        // keep accumulating priority so they will win out eventually. Unchanged nodes cost nothing.
+        std::sort(sRepCandidates.begin(), sRepCandidates.end(),
+            [](const NetRelevantNode* a, const NetRelevantNode* b) { return a->mPriority > b->mPriority; });
+
+        uint32_t budget = (mReplicationBandwidth > 0) ? uint32_t(mReplicationBandwidth * deltaTime) : UINT32_MAX;
+        uint32_t bytesSent = 0;
+
+        for (uint32_t i = 0; i < sRepCandidates.size(); ++i)
         {
-            repIndex = 0;
+            if (bytesSent >= budget)
+                break;
+
+            Node* node = sRepCandidates[i]->mNode;
+            UpdateRepSnapshot(node);
+            bytesSent += ReplicateNode(node, client, (node == incRepNode), false);
+            sRepCandidates[i]->mPriority = 0.0f;
         }
+    }
+}
+
+bool NetworkManager::GetClientViewPosition(NetClient* client, glm::vec3& outPosition)
+{
+    bool hasView = false;
+
+    if (client->mViewNetId != INVALID_NET_ID)
+    {
+        Node* viewNode = GetNetNode(client->mViewNetId);
 
-        for (uint32_t i = 0; i < count; ++i)
+        if (viewNode != nullptr && viewNode->IsNode3D())
         {
-            Node* node = repVector[repIndex];
-            bool forceRep = (node == incRepNode);
-            bool nodeReplicated = ReplicateNode(node, INVALID_HOST_ID, forceRep, false);
+            outPosition = static_cast<Node3D*>(viewNode)->GetWorldPosition();
+            hasView = true;
+        }
+    }
+
+    if (!hasView && client->mHasViewPosition)
+    {
+        outPosition = client->mViewPosition;
+        hasView = true;
+    }
+
+    return hasView;
+}
+
+float NetworkManager::GetNodeRelevancyDistance(Node* node) const
+{
+    float distance = node->GetNetRelevancyDistance();
+    return (distance > 0.0f) ? distance : mRelevancyDistance;
+}
+
+bool NetworkManager::IsNodeRelevant(Node* node, NetClient* client, const glm::vec3* viewPos, float& outScale)
+{
+    outScale = 1.0f;
+
+    NetRelevancy relevancy = node->GetNetRelevancy();
+    bool owner = (node->GetOwningHost() == client->mHost.mId);
+
+    // Nodes are always relevant to their owner.
+    if (relevancy == NetRelevancy::Always || owner)
+        return true;
+
+    if (relevancy == NetRelevancy::OwnerOnly)
+        return false;
+
+    float distance = GetNodeRelevancyDistance(node);
+
+    if (viewPos == nullptr ||
+        distance <= 0.0f ||
+        !node->IsNode3D())
+    {
+        return true;
+    }
+
+    glm::vec3 delta = static_cast<Node3D*>(node)->GetWorldPosition() - *viewPos;
+    float dist2 = glm::dot(delta, delta);
+
+    if (dist2 > distance * distance)
+        return false;
+
+    outScale = glm::mix(1.0f, OCT_RELEVANCY_MIN_SCALE, glm::sqrt(dist2) / distance);
+    return true;
+}
+
+void NetworkManager::AddRelevantNode(NetClient* client, Node* node, bool needsInitialRep)
+{
+    NetRelevantNode& rel = client->mRelevantNodes[node->GetNetId()];
+    rel.mNode = node;
+    rel.mPriority = 0.0f;
+    rel.mScale = 1.0f;
+    rel.mNeedsInitialRep = needsInitialRep;
+
+    // Start from an empty baseline. The client has a fresh copy of the node.
+    client->mRepBaselines.erase(node->GetNetId());
+}
 
-            if (nodeReplicated)
+void NetworkManager::RemoveRelevantNode(NetClient* client, Node* node)
+{
+    NetId netId = node->GetNetId();
+    client->mRelevantNodes.erase(netId);
+    client->mRepBaselines.erase(netId);
+
+    // Acks for a previous incarnation must not leak into the baseline if it is spawned again.
+    std::vector<NetRepPending>& pending = client->mRepPending;
+    for (uint32_t i = 0; i < pending.size(); ++i)
+    {
+        if (pending[i].mNetId == netId)
+        {
+            RemoveRepPending(client, i);
+            --i;
+        }
+    }
+}
+
+static uint64_t GetRelevancyCellKey(int32_t x, int32_t y, int32_t z)
+{
+    // 21 bits per axis
+    const uint64_t mask = (1 << 21) - 1;
+    return (uint64_t(x) & mask) | ((uint64_t(y) & mask) << 21) | ((uint64_t(z) & mask) << 42);
+}
+
+static int32_t GetRelevancyCellCoord(float value)
+{
+    return int32_t(glm::floor(value / OCT_RELEVANCY_CELL_SIZE));
+}
+
+bool NetworkManager::AcceptRelevantNode(NetClient* client, Node* node)
+{
+    auto it = sRelevancyDesired.find(node);
+
+    if (it == sRelevancyDesired.end())
+        return false;
+
+    if (it->second.mState != RelevancyState::Pending)
+        return (it->second.mState == RelevancyState::Accepted);
+
+    // A node is only relevant if its replicated parent is, since the client needs the parent to spawn it.
+    // Accepting the parent first also keeps spawn messages in parent first order.
+    Node* parent = node->GetParent();
+    bool accepted = true;
+
+    if (parent != nullptr &&
+        parent->GetNetId() != INVALID_NET_ID)
+    {
+        accepted = AcceptRelevantNode(client, parent);
+    }
+
+    RelevancyEntry& entry = it->second;
+    entry.mState = accepted ? RelevancyState::Accepted : RelevancyState::Rejected;
+
+    if (accepted)
+    {
+        auto relIt = client->mRelevantNodes.find(node->GetNetId());
+
+        if (relIt == client->mRelevantNodes.end())
+        {
+            SendSpawnMessage(node, client);
+            AddRelevantNode(client, node, true);
+            relIt = client->mRelevantNodes.find(node->GetNetId());
+        }
+
+        relIt->second.mScale = entry.mScale;
+    }
+
+    return accepted;
+}
+
+void NetworkManager::UpdateRelevancy()
+{
+    SCOPED_FRAME_STAT("Relevancy");
+
+    World* world = GetWorld(0);
+
+    if (world == nullptr)
+        return;
+
+    // Bucket distance-culled nodes into a grid so each client only has to look at the cells around its view.
+    // Everything else is kept in a separate list that every client checks.
+    for (auto& cell : sRelevancyGrid)
+    {
+        cell.second.clear();
+    }
+
+    for (auto& owned : sRelevancyOwnedNodes)
+    {
+        owned.second.clear();
+    }
+
+    sRelevancyGridNodes.clear();
+    sRelevancyOtherNodes.clear();
+
+    float maxDistance = 0.0f;
+
+    for (uint32_t t = 0; t < (uint32_t)ReplicationRate::Count; ++t)
+    {
+        const std::vector<Node*>& repVector = world->GetReplicatedNodeVector((ReplicationRate)t);
+
+        for (uint32_t i = 0; i < repVector.size(); ++i)
+        {
+            Node* node = repVector[i];
+            float distance = GetNodeRelevancyDistance(node);
+
+            if (node->GetNetRelevancy() == NetRelevancy::Default &&
+                node->IsNode3D() &&
+                distance > 0.0f)
+            {
+                glm::vec3 pos = static_cast<Node3D*>(node)->GetWorldPosition();
+                uint64_t key = GetRelevancyCellKey(
+                    GetRelevancyCellCoord(pos.x),
+                    GetRelevancyCellCoord(pos.y),
+                    GetRelevancyCellCoord(pos.z));
+
+                sRelevancyGrid[key].push_back(node);
+                sRelevancyGridNodes.push_back(node);
+                maxDistance = glm::max(maxDistance, distance);
+
+                // Owned nodes are relevant to their owner no matter how far away they are.
+                if (node->GetOwningHost() != INVALID_HOST_ID)
+                {
+                    sRelevancyOwnedNodes[node->GetOwningHost()].push_back(node);
+                }
+            }
+            else
             {
-                numNodesReplicated++;
+                sRelevancyOtherNodes.push_back(node);
             }
+        }
+    }
+
+    uint32_t numGridNodes = uint32_t(sRelevancyGridNodes.size());
+
+    for (uint32_t c = 0; c < mClients.size(); ++c)
+    {
+        NetClient* client = &mClients[c];
+
+        if (!client->mReady)
+            continue;
+
+        glm::vec3 viewPos;
+        bool hasView = GetClientViewPosition(client, viewPos);
+        const glm::vec3* viewPosPtr = hasView ? &viewPos : nullptr;
 
-            ++repIndex;
+        sRelevancyDesired.clear();
 
-            if (repIndex >= repVector.size())
+        auto addCandidates = [&](const std::vector<Node*>& nodes)
+        {
+            for (uint32_t i = 0; i < nodes.size(); ++i)
             {
-                repIndex = 0;
+                Node* node = nodes[i];
+                float scale = 1.0f;
+
+                if (sRelevancyDesired.find(node) == sRelevancyDesired.end() &&
+                    IsNodeRelevant(node, client, viewPosPtr, scale))
+                {
+                    sRelevancyDesired[node].mScale = scale;
+                }
             }
+        };
+
+        addCandidates(sRelevancyOtherNodes);
+
+        auto ownedIt = sRelevancyOwnedNodes.find(client->mHost.mId);
+        if (ownedIt != sRelevancyOwnedNodes.end())
+        {
+            addCandidates(ownedIt->second);
         }
-    };
 
-    // High Priority
+        if (numGridNodes > 0)
+        {
+            int32_t minCell[3] = {};
+            int32_t maxCell[3] = {};
+            uint64_t numCells = 1;
+
+            if (hasView)
+            {
+                for (uint32_t a = 0; a < 3; ++a)
+                {
+                    minCell[a] = GetRelevancyCellCoord(viewPos[a] - maxDistance);
+                    maxCell[a] = GetRelevancyCellCoord(viewPos[a] + maxDistance);
+                    numCells *= uint64_t(maxCell[a] - minCell[a] + 1);
+                }
+            }
+
+            if (!hasView || numCells > numGridNodes)
+            {
+                // Without a view everything is relevant. Otherwise the query would touch more cells
+                // than there are nodes, so just test every node.
+                addCandidates(sRelevancyGridNodes);
+            }
+            else
+            {
+                for (int32_t x = minCell[0]; x <= maxCell[0]; ++x)
+                {
+                    for (int32_t y = minCell[1]; y <= maxCell[1]; ++y)
+                    {
+                        for (int32_t z = minCell[2]; z <= maxCell[2]; ++z)
+                        {
+                            auto cellIt = sRelevancyGrid.find(GetRelevancyCellKey(x, y, z));
+                            if (cellIt != sRelevancyGrid.end())
+                            {
+                                addCandidates(cellIt->second);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Spawn newly relevant nodes. Nodes whose replicated parent isn't relevant are rejected.
+        for (auto& it : sRelevancyDesired)
+        {
+            AcceptRelevantNode(client, it.first);
+        }
+
+        // Destroy whatever this client had that is no longer relevant.
+        sRelevancyRemoved.clear();
+
+        for (auto& relIt : client->mRelevantNodes)
+        {
+            auto desiredIt = sRelevancyDesired.find(relIt.second.mNode);
+
+            if (desiredIt == sRelevancyDesired.end() ||
+                desiredIt->second.mState != RelevancyState::Accepted)
+            {
+                sRelevancyRemoved.push_back(relIt.second.mNode);
+            }
+        }
+
+        for (uint32_t i = 0; i < sRelevancyRemoved.size(); ++i)
+        {
+            Node* node = sRelevancyRemoved[i];
+
+            // Already removed along with a parent. Destroying a node on the client also destroys its children.
+            if (client->mRelevantNodes.find(node->GetNetId()) == client->mRelevantNodes.end())
+                continue;
+
+            SendDestroyMessage(node, client);
+
+            auto despawn = [&](Node* child) -> bool
+            {
+                if (child->GetNetId() != INVALID_NET_ID)
+                {
+                    RemoveRelevantNode(client, child);
+                }
+                return true;
+            };
+
+            node->Traverse(despawn, false);
+        }
+    }
+}
+
+template<typename T>
+static void UpdateRepSnapshotVars(std::vector<T>& repData, std::vector<NetRepVarState>& vars)
+{
+    bool reset = (vars.size() != repData.size());
+
+    if (reset)
     {
-        const std::vector<Node*>& repVector = world->GetReplicatedNodeVector(ReplicationRate::High);
-        uint32_t& repIndex = world->GetReplicatedNodeIndex(ReplicationRate::High);
-        uint32_t vectorSize = (uint32_t) repVector.size();
-        uint32_t count = vectorSize / 1;
-        replicateTier(repVector, repIndex, count);
+        vars.clear();
+        vars.resize(repData.size());
     }
 
-    // Medium Priority
+    for (uint32_t i = 0; i < repData.size(); ++i)
     {
-        const std::vector<Node*>& repVector = world->GetReplicatedNodeVector(ReplicationRate::Medium);
-        uint32_t& repIndex = world->GetReplicatedNodeIndex(ReplicationRate::Medium);
-        uint32_t vectorSize = (uint32_t) repVector.size();
-        uint32_t count = (vectorSize + 1) / 2;
-        replicateTier(repVector, repIndex, count);
+        // Only re-encode variables that changed since the last snapshot.
+        if (reset || repData[i].ShouldReplicate())
+        {
+            sRepEncodeStream.SetPos(0);
+            repData[i].WriteNetStream(sRepEncodeStream);
+            sRepEncodeStream.AlignBits();
+
+            const uint8_t* data = (const uint8_t*)sRepEncodeStream.GetData();
+            vars[i].mData.assign(data, data + sRepEncodeStream.GetPos());
+            vars[i].mNumBits = repData[i].GetNetSerializationBits();
+            vars[i].mSerial = 1;
+
+            repData[i].PostReplicate();
+        }
     }
-    // Low Priority
+}
+
+void NetworkManager::UpdateRepSnapshot(Node* node)
+{
+    // Only encode once per replication update, no matter how many clients the node is sent to.
+    NetRepSnapshot& snapshot = mRepSnapshots[node->GetNetId()];
+    if (snapshot.mFrame == mRepFrame)
+        return;
+
+    snapshot.mFrame = mRepFrame;
+
+    UpdateRepSnapshotVars(node->GetReplicatedData(), snapshot.mVars[0]);
+
+    Script* script = node->GetScript();
+    if (script != nullptr && script->IsActive())
     {
-        const std::vector<Node*>& repVector = world->GetReplicatedNodeVector(ReplicationRate::Low);
-        uint32_t& repIndex = world->GetReplicatedNodeIndex(ReplicationRate::Low);
-        uint32_t vectorSize = (uint32_t) repVector.size();
-        uint32_t count = (vectorSize + 3) / 4;
-        replicateTier(repVector, repIndex, count);
+        UpdateRepSnapshotVars(script->GetReplicatedData(), snapshot.mVars[1]);
     }
 }
 
 template<typename T>
-bool ReplicateData(std::vector<T>& repData, NetMsgReplicate& msg, NetId hostId, bool force, bool reliable)
+uint32_t ReplicateData(
+    std::vector<T>& repData,
+    NetMsgReplicate& msg,
+    NetClient* client,
+    uint8_t channel,
+    const std::vector<NetRepVarState>& snapshot,
+    bool force,
+    bool reliable)
 {
     // msg.mNetId should already be set by caller.
     msg.mIndices.clear();
-    msg.mData.clear();
+    msg.mDatums.clear();
+    msg.mNumSchemaVariables = (uint16_t)repData.size();
     msg.mReliable = reliable;
 
-    bool replicated = false;
+    OCT_ASSERT(snapshot.size() == repData.size());
+    if (snapshot.size() != repData.size())
+        return 0;
+
+    // The baseline is whatever this client has acknowledged. A schema change (e.g. script reload) resets it.
+    std::vector<NetRepVarState>& acked = client->mRepBaselines[msg.mNodeNetId].mVars[channel];
+    if (acked.size() != repData.size())
+    {
+        acked.clear();
+        acked.resize(repData.size());
+    }
+
+    uint32_t bytesSent = 0;
     uint32_t numVars = 0;
 
-    uint32_t msgSerializedSize = RepMsgHeaderSize;
+    // Messages are bit packed, so budget in bits. Each schema variable costs one changed bit.
+    const uint32_t msgHeaderBits = RepMsgHeaderSize * 8 + (uint32_t)repData.size();
+    uint32_t msgSerializedBits = msgHeaderBits;
 
     for (uint32_t i = 0; i < repData.size(); ++i)
     {
-        if (force || repData[i].ShouldReplicate())
+        // Send anything that differs from the acked baseline. Values in lost packets never get
+        // acked, so they keep being sent until the client confirms it has them.
+        bool changed =
+            force ||
+            repData[i].IsAlwaysReplicated() ||
+            acked[i].mSerial == 0 ||
+            acked[i].mData != snapshot[i].mData;
+
+        if (changed)
         {
             // First check if the replicated variable will fit into the message.
             // If not, we will need to send a message for all of the replicated vars
             // that have been processed to this point, and then begin a new message.
-            uint32_t datumSerializeSize = repData[i].GetSerializationSize();
+            uint32_t datumSerializeBits = snapshot[i].mNumBits;
 
             // If the replicated variable is too large, then skip it.
-            if (datumSerializeSize > MaxDatumNetSerializeSize)
+            if (msgHeaderBits + datumSerializeBits > MaxRepMsgBits)
             {
                 LogWarning("Replicated variable too large to replicate. Most likely a big string.");
                 continue;
             }
-            else if (msgSerializedSize + datumSerializeSize > OCT_MAX_MSG_BODY_SIZE)
+            else if (msgSerializedBits + datumSerializeBits > MaxRepMsgBits)
             {
                 // Send what we have until now
-                NetworkManager::Get()->SendReplicateMsg(msg, numVars, hostId);
-                msgSerializedSize = RepMsgHeaderSize;
-                replicated = true;
+                NetworkManager::Get()->SendReplicateMsg(msg, numVars, client, channel, snapshot);
+                bytesSent += (msgSerializedBits + 7) / 8;
+                msgSerializedBits = msgHeaderBits;
             }
 
             msg.mIndices.push_back((uint16_t)i);
-            msg.mData.push_back(Datum(repData[i]));
+            msg.mDatums.push_back(&repData[i]);
 
             numVars++;
-            msgSerializedSize += datumSerializeSize;
-            repData[i].PostReplicate();
+            msgSerializedBits += datumSerializeBits;
         }
     }
 
     if (numVars > 0)
     {
-        NetworkManager::Get()->SendReplicateMsg(msg, numVars, hostId);
-        msgSerializedSize = RepMsgHeaderSize;
-        replicated = true;
+        NetworkManager::Get()->SendReplicateMsg(msg, numVars, client, channel, snapshot);
+        bytesSent += (msgSerializedBits + 7) / 8;
     }
 
-    return replicated;
+    return bytesSent;
 }
 
-bool NetworkManager::ReplicateNode(Node* node, NetId hostId, bool force, bool reliable)
+uint32_t NetworkManager::ReplicateNode(Node* node, NetClient* client, bool force, bool reliable)
 {
-    bool nodeReplicated = false;
-    bool needsForcedRep = node->NeedsForcedReplication();
-    force = (force || needsForcedRep);
-    reliable = (reliable || needsForcedRep);
+    // UpdateRepSnapshot() must be called for the node before replicating it to clients.
+    uint32_t bytesSent = 0;
+    NetRepSnapshot& snapshot = mRepSnapshots[node->GetNetId()];
     sMsgReplicate.mNodeNetId = node->GetNetId();
 
     std::vector<NetDatum>& repData = node->GetReplicatedData();
 
-    nodeReplicated = ReplicateData<NetDatum>(repData, sMsgReplicate, hostId, force, reliable);
+    bytesSent += ReplicateData<NetDatum>(repData, sMsgReplicate, client, 0, snapshot.mVars[0], force, reliable);
 
     Script* script = node->GetScript();
     if (script != nullptr && script->IsActive())
@@ -1595,12 +2557,10 @@ bool NetworkManager::ReplicateNode(Node* node, NetId hostId, bool force, bool re
         sMsgReplicateScript.mNodeNetId = node->GetNetId();
 
         std::vector<ScriptNetDatum>& scriptRepData = script->GetReplicatedData();
-        nodeReplicated = ReplicateData<ScriptNetDatum>(scriptRepData, sMsgReplicateScript, hostId, force, reliable);
+        bytesSent += ReplicateData<ScriptNetDatum>(scriptRepData, sMsgReplicateScript, client, 1, snapshot.mVars[1], force, reliable);
     }
 
-    node->ClearForcedReplication();
-
-    return nodeReplicated;
+    return bytesSent;
 }
 
 void NetworkManager::UpdateHostConnections(float deltaTime)
@@ -1612,7 +2572,7 @@ void NetworkManager::UpdateHostConnections(float deltaTime)
             mClients[i].mTimeSinceLastMsg += deltaTime;
 
             if (mClients[i].mTimeSinceLastMsg >= mInactiveTimeout ||
-                mClients[i].mOutgoingPackets.size() > sMaxOutgoingPackets)
+                GetNumOutgoingReliablePackets(mClients[i]) > sMaxOutgoingPackets)
             {
                 Kick(mClients[i].mHost.mId, NetMsgKick::Reason::Timeout);
             }
@@ -1622,7 +2582,7 @@ void NetworkManager::UpdateHostConnections(float deltaTime)
     {
         mServer.mTimeSinceLastMsg += deltaTime;
         if (mServer.mTimeSinceLastMsg >= mInactiveTimeout ||
-            mServer.mOutgoingPackets.size() > sMaxOutgoingPackets)
+            GetNumOutgoingReliablePackets(mServer) > sMaxOutgoingPackets)
         {
             Disconnect();
 
@@ -1639,6 +2599,29 @@ void NetworkManager::UpdateHostConnections(float deltaTime)
     }
 }
 
+void NetworkManager::RebuildClientLookup()
+{
+    mClientAddressMap.clear();
+    mClientOnlineIdMap.clear();
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        mClientIndexById[i] = -1;
+    }
+
+    for (uint32_t i = 0; i < mClients.size(); ++i)
+    {
+        const NetHost& host = mClients[i].mHost;
+        mClientAddressMap[GetNetAddressKey(host.mIpAddress, host.mPort)] = i;
+        mClientIndexById[host.mId] = int16_t(i);
+
+        if (mInOnlineSession)
+        {
+            mClientOnlineIdMap[host.mOnlineId] = i;
+        }
+    }
+}
+
 int32_t NetworkManager::RecvFrom(char* buffer, uint32_t size, NetHost& outHost)
 {
     int32_t bytes = 0;
@@ -1656,12 +2639,100 @@ int32_t NetworkManager::RecvFrom(char* buffer, uint32_t size, NetHost& outHost)
 }
 
 void NetworkManager::SendTo(const NetHost& host, const char* buffer, uint32_t size)
+{
+    if (mSimEnabled)
+    {
+        SimulateSendTo(host, buffer, size);
+    }
+    else
+    {
+        TransmitTo(host, buffer, size);
+    }
+}
+
+void NetworkManager::SimulateSendTo(const NetHost& host, const char* buffer, uint32_t size)
+{
+    if (size > OCT_MAX_MSG_SIZE)
+    {
+        TransmitTo(host, buffer, size);
+        return;
+    }
+
+    if (SimRandFloat() < mSimConditions.mPacketLoss)
+    {
+        return;
+    }
+
+    uint32_t numCopies = (SimRandFloat() < mSimConditions.mDuplicate) ? 2 : 1;
+
+    for (uint32_t i = 0; i < numCopies; ++i)
+    {
+        float delayMs = mSimConditions.mLatencyMs + (SimRandFloat() * 2.0f - 1.0f) * mSimConditions.mJitterMs;
+
+        if (SimRandFloat() < mSimConditions.mReorder)
+        {
+            delayMs += OCT_NET_SIM_REORDER_DELAY_MS;
+        }
+
+        sSimPackets.emplace_back();
+        SimulatedPacket& packet = sSimPackets.back();
+        packet.mTime = glm::max(delayMs, 0.0f) / 1000.0f;
+        packet.mHost = host;
+        packet.mSize = size;
+        memcpy(packet.mData, buffer, size);
+    }
+}
+
+void NetworkManager::UpdateSimulatedPackets(float deltaTime)
+{
+    // Release packets whose delay has elapsed and keep the rest in send order.
+    uint32_t numRemaining = 0;
+
+    for (uint32_t i = 0; i < sSimPackets.size(); ++i)
+    {
+        sSimPackets[i].mTime -= deltaTime;
+
+        if (sSimPackets[i].mTime <= 0.0f)
+        {
+            TransmitTo(sSimPackets[i].mHost, sSimPackets[i].mData, sSimPackets[i].mSize);
+        }
+        else
+        {
+            if (numRemaining != i)
+            {
+                sSimPackets[numRemaining] = sSimPackets[i];
+            }
+
+            numRemaining++;
+        }
+    }
+
+    sSimPackets.resize(numRemaining);
+}
+
+void NetworkManager::TransmitTo(const NetHost& host, const char* buffer, uint32_t size)
 {
     if (mInOnlineSession && mOnlinePlatform)
     {
         mOnlinePlatform->SendMessage(host, buffer, size);
         mBytesSent += size;
     }
+    else if (size <= OCT_SEND_BUFFER_SIZE)
+    {
+        // Queue the datagram up so that all packets sent this frame go out in as few syscalls as possible.
+        if (sNumQueuedSends >= OCT_NET_BATCH_SIZE)
+        {
+            FlushSendQueue();
+        }
+
+        NetDatagram& datagram = sSendQueue[sNumQueuedSends];
+        datagram.mData = sSendQueueData[sNumQueuedSends];
+        datagram.mSize = size;
+        datagram.mAddr = host.mIpAddress;
+        datagram.mPort = host.mPort;
+        memcpy(datagram.mData, buffer, size);
+        sNumQueuedSends++;
+    }
     else
     {
         mBytesSent += NET_SocketSendTo(
@@ -1673,156 +2744,218 @@ void NetworkManager::SendTo(const NetHost& host, const char* buffer, uint32_t si
     }
 }
 
-void NetworkManager::ProcessIncomingPackets(float deltaTime)
+void NetworkManager::FlushSendQueue()
 {
-    int32_t bytes = 0;
-    NetHost sender;
+    if (sNumQueuedSends > 0)
+    {
+        if (mSocket != NET_INVALID_SOCKET)
+        {
+            int32_t numSent = NET_SocketSendBatch(mSocket, sSendQueue, sNumQueuedSends);
 
-    while ((bytes = RecvFrom(sRecvBuffer, OCT_RECV_BUFFER_SIZE, sender)) > 0)
-    {   
-        Stream stream(sRecvBuffer, bytes);
-        NetMsgType msgType = (NetMsgType) sRecvBuffer[OCT_PACKET_HEADER_SIZE];
+            for (int32_t i = 0; i < numSent; ++i)
+            {
+                mBytesSent += sSendQueue[i].mSize;
+            }
+        }
 
-        // Find which NetHost the message was from.
-        // if there is no matching NetHost then ignore this message (unless it is a "Connect" message)
-        sender.mId = INVALID_HOST_ID;
+        sNumQueuedSends = 0;
+    }
+}
 
-        NetHostProfile* senderProfile = nullptr;
+void NetworkManager::ProcessIncomingPackets(float deltaTime)
+{
+    if (mInOnlineSession && mOnlinePlatform)
+    {
+        int32_t bytes = 0;
+        NetHost sender;
 
-        // Connect messages are only executed on the Server
-        bool connectMsg = mNetStatus == NetStatus::Server && 
-                          msgType == NetMsgType::Connect;
+        while ((bytes = RecvFrom(sRecvBuffer, OCT_RECV_BUFFER_SIZE, sender)) > 0)
+        {
+            ProcessIncomingPacket(sRecvBuffer, bytes, sender);
+        }
+    }
+    else
+    {
+        int32_t count = OCT_NET_BATCH_SIZE;
 
-        if (mNetStatus == NetStatus::Server)
+        // Keep draining the socket while full batches are being returned.
+        while (count == OCT_NET_BATCH_SIZE &&
+            mNetStatus != NetStatus::Local)
         {
-            for (uint32_t i = 0; i < mClients.size(); ++i)
+            for (uint32_t i = 0; i < OCT_NET_BATCH_SIZE; ++i)
             {
-                if ((mInOnlineSession && mClients[i].mHost.mOnlineId == sender.mOnlineId) || 
-                    (mClients[i].mHost.mIpAddress == sender.mIpAddress &&
-                    mClients[i].mHost.mPort == sender.mPort))
-                {
-                    OCT_ASSERT(mClients[i].mHost.mId != INVALID_HOST_ID);
-                    sender.mId = mClients[i].mHost.mId;
-                    mClients[i].mTimeSinceLastMsg = 0.0f;
+                sRecvBatch[i].mData = sRecvBatchData[i];
+                sRecvBatch[i].mSize = OCT_RECV_BUFFER_SIZE;
+            }
 
-                    senderProfile = &mClients[i];
+            count = NET_SocketRecvBatch(mSocket, sRecvBatch, OCT_NET_BATCH_SIZE);
+
+            for (int32_t i = 0; i < count; ++i)
+            {
+                NetHost sender;
+                sender.mIpAddress = sRecvBatch[i].mAddr;
+                sender.mPort = sRecvBatch[i].mPort;
+                ProcessIncomingPacket(sRecvBatch[i].mData, int32_t(sRecvBatch[i].mSize), sender);
 
+                // A packet may have caused us to disconnect and close the socket.
+                if (mNetStatus == NetStatus::Local)
+                {
                     break;
                 }
             }
         }
-        else
+    }
+}
+
+void NetworkManager::ProcessIncomingPacket(char* data, int32_t bytes, NetHost sender)
+{
+    if (bytes <= int32_t(OCT_PACKET_HEADER_SIZE))
+    {
+        return;
+    }
+
+    Stream stream(data, bytes);
+    NetMsgType msgType = (NetMsgType) data[OCT_PACKET_HEADER_SIZE];
+
+    // Find which NetHost the message was from.
+    // if there is no matching NetHost then ignore this message (unless it is a "Connect" message)
+    sender.mId = INVALID_HOST_ID;
+
+    NetHostProfile* senderProfile = nullptr;
+
+    // Connect messages are only executed on the Server
+    bool connectMsg = mNetStatus == NetStatus::Server && 
+                      msgType == NetMsgType::Connect;
+
+    if (mNetStatus == NetStatus::Server)
+    {
+        auto it = mInOnlineSession ?
+            mClientOnlineIdMap.find(sender.mOnlineId) :
+            mClientAddressMap.find(GetNetAddressKey(sender.mIpAddress, sender.mPort));
+        auto itEnd = mInOnlineSession ? mClientOnlineIdMap.end() : mClientAddressMap.end();
+
+        if (it != itEnd)
         {
-            if ((mInOnlineSession && mServer.mHost.mOnlineId == sender.mOnlineId) ||
-                (mServer.mHost.mIpAddress == sender.mIpAddress &&
-                mServer.mHost.mPort == sender.mPort))
-            {
-                OCT_ASSERT(mServer.mHost.mId == SERVER_HOST_ID);
-                sender.mId = mServer.mHost.mId;
-                mServer.mTimeSinceLastMsg = 0.0f;
+            NetClient& client = mClients[it->second];
+            OCT_ASSERT(client.mHost.mId != INVALID_HOST_ID);
+            sender.mId = client.mHost.mId;
+            client.mTimeSinceLastMsg = 0.0f;
 
-                senderProfile = &mServer;
-            }
+            senderProfile = &client;
         }
-
-        if (!connectMsg &&
-            (sender.mId == INVALID_HOST_ID || senderProfile == nullptr))
+    }
+    else
+    {
+        if ((mInOnlineSession && mServer.mHost.mOnlineId == sender.mOnlineId) ||
+            (mServer.mHost.mIpAddress == sender.mIpAddress &&
+            mServer.mHost.mPort == sender.mPort))
         {
-            LogDebug("Unrecognized host: %08x:%u", sender.mIpAddress, sender.mPort);
-            continue;
+            OCT_ASSERT(mServer.mHost.mId == SERVER_HOST_ID);
+            sender.mId = mServer.mHost.mId;
+            mServer.mTimeSinceLastMsg = 0.0f;
+
+            senderProfile = &mServer;
         }
+    }
+
+    if (!connectMsg &&
+        (sender.mId == INVALID_HOST_ID || senderProfile == nullptr))
+    {
+        LogDebug("Unrecognized host: %08x:%u", sender.mIpAddress, sender.mPort);
+        return;
+    }
+
+    uint16_t seq = stream.ReadUint16();
+    bool reliable = stream.ReadBool();
+
+    bool processMsg = false;
 
-        uint16_t seq = stream.ReadUint16();
-        bool reliable = stream.ReadBool();
+    if (connectMsg)
+    {
+        processMsg = true;
+    }
+    else if (reliable)
+    {
+        uint16_t& curSeq = senderProfile->mIncomingReliableSeq;
 
-        bool processMsg = false;
+        // Acks are batched into one message per frame (see SendReliableAck()).
+        // Duplicates are acked again too, since the previous ack may have been lost.
+        senderProfile->mReliableAckDirty = true;
 
-        if (connectMsg)
+        if (seq == curSeq)
         {
+            // We received the next expected packet, so process it.
             processMsg = true;
+            curSeq++;
         }
-        else if (reliable)
+        else if (SeqNumLess(seq, curSeq))
         {
-            uint16_t& curSeq = senderProfile->mIncomingReliableSeq;
-            bool ack = false;
+            // If the received seq is less than the current seq, don't process the packet, as it should
+            // have already been processed previously.
+            processMsg = false;
+        }
+        else if (uint16_t(seq - curSeq) < OCT_RELIABLE_WINDOW_SIZE)
+        {
+            // The received seq number is ahead of our current expected seq num, so we need to buffer it
+            // until the missing packets arrive.
+            ReliablePacket& packet = senderProfile->mIncomingWindow[seq % OCT_RELIABLE_WINDOW_SIZE];
 
-            if (seq == curSeq)
-            {
-                // We received the next expected packet, so process it.
-                processMsg = true;
-                ack = true;
-                curSeq++;
-            }
-            else if (SeqNumLess(seq, curSeq))
+            if (!packet.mActive)
             {
-                // If the received seq is less than the current seq, don't process the packet, as it should
-                // have already been processed previously. Send an Ack back saying that the message has been acknowledged.
-                processMsg = false;
-                ack = true;
-            }
-            else
-            {
-                if (senderProfile->mIncomingPackets.size() < sMaxIncomingPackets &&
-                    !HostProfileHasIncomingPacket(senderProfile, seq))
-                {
-                    //LogError("Queuing reliable packet %d - Waiting on %d", seq, curSeq);
-                    // The received seq number is ahead of our current expected seq num, so we need to queue it up.
-                    const char* data = &(stream.GetData()[stream.GetPos()]);
-                    uint32_t size = bytes - stream.GetPos();
-                    OCT_ASSERT(size > 0);
-                    senderProfile->mIncomingPackets.emplace_back(seq, data, size);
-                    ack = true;
-                }
-
-                processMsg = false;
+                const char* data = &(stream.GetData()[stream.GetPos()]);
+                uint32_t size = bytes - stream.GetPos();
+                OCT_ASSERT(size > 0);
+                packet.SetData(seq, data, size);
+                packet.mActive = true;
             }
 
-            if (ack)
-            {
-                NetMsgAck ackMsg;
-                ackMsg.mSequenceNumber = seq;
-                SendMessage(&ackMsg, senderProfile);
-            }
+            processMsg = false;
         }
         else
         {
-            uint16_t& curSeq = senderProfile->mIncomingUnreliableSeq;
-
-            // If the received seq is less than the current seq, ignore the packet.
-            if (SeqNumLess(seq, curSeq))
-            {
-                //LogDebug("Ignoring out of sequence unreliable packet");
-                processMsg = false;
-            }
-            else
-            {
-                processMsg = true;
-                curSeq = seq + 1;
-            }
+            // Outside of the receive window. The sender will resend it once the window has moved.
+            processMsg = false;
         }
+    }
+    else
+    {
+        uint16_t& curSeq = senderProfile->mIncomingUnreliableSeq;
 
-        if (processMsg)
+        // If the received seq is less than the current seq, ignore the packet.
+        if (SeqNumLess(seq, curSeq))
+        {
+            //LogDebug("Ignoring out of sequence unreliable packet");
+            processMsg = false;
+        }
+        else
         {
-            ProcessMessages(sender, stream);
+            processMsg = true;
+            curSeq = seq + 1;
 
-            if (reliable)
-            {
-                // Send back the Ack
-                NetMsgAck ackMsg;
-                ackMsg.mSequenceNumber = seq;
-                SendMessage(&ackMsg, senderProfile);
+            // Track received packets for the replication ack. Bit 0 is the newest seq.
+            uint16_t shift = uint16_t(seq - senderProfile->mRepAckSeq);
+            senderProfile->mRepAckBits = (shift >= 32) ? 1u : ((senderProfile->mRepAckBits << shift) | 1u);
+            senderProfile->mRepAckSeq = seq;
+            senderProfile->mRepAckDirty = true;
+        }
+    }
 
-                // Process pending reliable packets first before processing any more messages.
-                ProcessPendingReliablePackets(senderProfile);
-            }
+    if (processMsg)
+    {
+        ProcessMessages(sender, stream);
+
+        if (reliable)
+        {
+            // Process pending reliable packets first before processing any more messages.
+            ProcessPendingReliablePackets(senderProfile);
         }
+    }
 
-        mBytesReceived += bytes;
+    mBytesReceived += bytes;
 
 #if DEBUG_MSG_STATS
-        sNumPacketsReceived++;
+    sNumPacketsReceived++;
 #endif
-    }
 }
 
 void NetworkManager::ProcessMessages(NetHost sender, Stream& stream)
@@ -1850,6 +2983,8 @@ void NetworkManager::ProcessMessages(NetHost sender, Stream& stream)
             NET_MSG_STATIC_CASE(InvokeScript)
             //NET_MSG_CASE(Broadcast)
             NET_MSG_CASE(Ack)
+            NET_MSG_CASE(ReplicateAck)
+            NET_MSG_CASE(ServerTime)
 
         default: break;
         }
@@ -1863,25 +2998,18 @@ void NetworkManager::ProcessMessages(NetHost sender, Stream& stream)
 
 void NetworkManager::ProcessPendingReliablePackets(NetHostProfile* profile)
 {
-    std::vector<ReliablePacket>& packets = profile->mIncomingPackets;
-    bool processedPacket = true;
-    while (processedPacket)
-    {
-        processedPacket = false;
+    ReliablePacket* packet = &profile->mIncomingWindow[profile->mIncomingReliableSeq % OCT_RELIABLE_WINDOW_SIZE];
 
-        for (uint32_t i = 0; i < packets.size(); ++i)
-        {
-            if (packets[i].mSeq == profile->mIncomingReliableSeq)
-            {
-                Stream stream(packets[i].mData.data(), (uint32_t)packets[i].mData.size());
-                ProcessMessages(profile->mHost, stream);
+    while (packet->mActive &&
+        packet->mSeq == profile->mIncomingReliableSeq)
+    {
+        Stream stream(packet->mData, packet->mSize);
+        ProcessMessages(profile->mHost, stream);
 
-                profile->mIncomingReliableSeq++;
-                packets.erase(packets.begin() + i);
-                processedPacket = true;
-                break;
-            }
-        }
+        packet->mActive = false;
+        packet->mSize = 0;
+        profile->mIncomingReliableSeq++;
+        packet = &profile->mIncomingWindow[profile->mIncomingReliableSeq % OCT_RELIABLE_WINDOW_SIZE];
     }
 }
 
@@ -1916,6 +3044,9 @@ void NetworkManager::ResetToLocalStatus()
 {
     if (mNetStatus != NetStatus::Local)
     {
+        FlushSendQueue();
+        sSimPackets.clear();
+
         if (mSocket != NET_INVALID_SOCKET)
         {
             NET_SocketClose(mSocket);
@@ -1930,7 +3061,11 @@ void NetworkManager::ResetToLocalStatus()
         mNetStatus = NetStatus::Local;
         mHostId = INVALID_HOST_ID;
         mServer = NetServer();
+        mRepSnapshots.clear();
         mInOnlineSession = false;
+        mHasServerTime = false;
+        mServerTimeOffset = 0.0;
+        RebuildClientLookup();
     }
 }
 
@@ -1959,6 +3094,7 @@ void NetworkManager::BroadcastSession()
 
 void NetworkManager::FlushSendBuffers(NetHostProfile* hostProfile)
 {
+    SendReliableAck(hostProfile);
     FlushSendBuffer(hostProfile, false);
     FlushSendBuffer(hostProfile, true);
 }
@@ -1984,28 +3120,22 @@ void NetworkManager::FlushSendBuffer(NetHostProfile* hostProfile, bool reliable)
             uint32_t packetSize = stream.GetPos();
             OCT_ASSERT(packetSize == OCT_PACKET_HEADER_SIZE + uint32_t(sendBuffer.size()));
 
-            // If the client isn't ready yet, then don't send the message.
-            // Reliable messages will still be queued and sent once the client is ready.
-            if (hostProfile->mReady)
+            if (reliable)
             {
-#if DEBUG_NETWORK_CONDITIONS
-                DebugSendTo(hostProfile->mHost,
-                    packetSize,
-                    sSendBuffer);
-#else
+                // Reliable messages are queued and sent once there is room in the window and the client is ready.
+                hostProfile->mOutgoingQueue.Push().SetData(outgoingSeq, sSendBuffer, packetSize);
+                SendReliablePackets(hostProfile);
+            }
+            else if (hostProfile->mReady)
+            {
+                // If the client isn't ready yet, then don't send the message.
                 SendTo(hostProfile->mHost, sSendBuffer, packetSize);
-#endif
 
 #if DEBUG_MSG_STATS
                 sNumPacketsSent++;
 #endif
             }
 
-            if (reliable)
-            {
-                hostProfile->mOutgoingPackets.emplace_back(outgoingSeq, sSendBuffer, packetSize);
-            }
-
             outgoingSeq++;
         }
         else
@@ -2050,20 +3180,27 @@ bool NetworkManager::UpdateReliablePackets(NetHostProfile* profile, float deltaT
     if (profile != nullptr &&
         profile->mReady)
     {
-        std::vector<ReliablePacket>& packets = profile->mOutgoingPackets;
+        uint64_t now = SYS_GetTimeMicroseconds();
 
-        for (uint32_t i = 0; i < packets.size(); ++i)
+        for (uint32_t i = 0; i < OCT_RELIABLE_WINDOW_SIZE; ++i)
         {
-            packets[i].mTimeSinceSend += deltaTime;
+            ReliablePacket& packet = profile->mOutgoingWindow[i];
 
-            if (packets[i].mTimeSinceSend >= sReliableResendTime)
+            if (packet.mActive)
             {
-                ResendPacket(profile, packets[i]);
+                // Back off exponentially on repeated losses.
+                uint32_t backoff = 1u << glm::min<uint32_t>(packet.mNumSends - 1, 3);
+                float timeout = glm::min(profile->mResendTimeout * backoff, sMaxReliableResendTime);
 
-                if (packets[i].mNumSends > sMaxReliableResends)
+                if ((now - packet.mSendTime) / 1000000.0f >= timeout)
                 {
-                    retSuccess = false;
-                    break;
+                    ResendPacket(profile, packet);
+
+                    if (packet.mNumSends > sMaxReliableResends)
+                    {
+                        retSuccess = false;
+                        break;
+                    }
                 }
             }
         }
@@ -2077,23 +3214,6 @@ void NetworkManager::ResetHostProfile(NetHostProfile* profile)
     *profile = NetHostProfile();
 }
 
-bool NetworkManager::HostProfileHasIncomingPacket(NetHostProfile* profile, uint16_t seq)
-{
-    bool hasPacket = false;
-    std::vector<ReliablePacket>& packets = profile->mIncomingPackets;
-
-    for (uint32_t i = 0; i < packets.size(); ++i)
-    {
-        if (packets[i].mSeq == seq)
-        {
-            hasPacket = true;
-            break;
-        }
-    }
-
-    return hasPacket;
-}
-
 bool NetworkManager::SeqNumLess(uint16_t s1, uint16_t s2)
 {
     // https://datatracker.ietf.org/doc/html/rfc1982
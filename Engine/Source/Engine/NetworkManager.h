@@ -19,6 +19,7 @@
 #endif
 
 class Node;
+class Node3D;
 class Script;
 
 bool NetIsClient();
@@ -81,7 +82,7 @@ public:
     int32_t RecvFrom(char* buffer, uint32_t size, NetHost& outHost);
     void SendTo(const NetHost& host, const char* buffer, uint32_t size);
 
-    void SendReplicateMsg(NetMsgReplicate& repMsg, uint32_t& numVars, NetHostId hostId);
+    void SendReplicateMsg(NetMsgReplicate& repMsg, uint32_t& numVars, NetClient* client, uint8_t channel, const std::vector<NetRepVarState>& snapshot);
     void SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func, uint32_t numParams, const Datum** params);
     void SendInvokeMsg(Node* node, NetFunc* func, uint32_t numParams, const Datum** params);
     void SendInvokeScriptMsg(Script* script, ScriptNetFunc* func, uint32_t numParams, const Datum** params);
@@ -95,13 +96,37 @@ public:
 
     NetClient* FindNetClient(NetHostId id);
 
+    void SetSimulatedConditions(const NetSimConditions& conditions);
+    const NetSimConditions& GetSimulatedConditions() const;
+
     NetStatus GetNetStatus() const;
 
     void EnableIncrementalReplication(bool enable);
     bool IsIncrementalReplicationEnabled() const;
 
+    // Interest management. A client's view is used to decide which nodes are relevant to it.
+    // Without a view (or with a relevancy distance of 0) every node is relevant.
+    void SetClientViewNode(NetHostId hostId, Node* node);
+    void SetClientViewPosition(NetHostId hostId, glm::vec3 position);
+    void SetRelevancyDistance(float distance);
+    float GetRelevancyDistance() const;
+    void SetReplicationBandwidth(uint32_t bytesPerSecond);
+    uint32_t GetReplicationBandwidth() const;
+
+    // Snapshot interpolation. Clients show interpolated nodes a fixed delay behind the estimated
+    // server time, and extrapolate for a limited time when snapshots arrive late.
+    void SetInterpolationDelay(float delay);
+    float GetInterpolationDelay() const;
+    void SetMaxExtrapolation(float maxTime);
+    float GetMaxExtrapolation() const;
+    double GetServerTime() const;
+    double GetPacketServerTime() const;
+    void AddInterpolatedNode(Node3D* node);
+    void RemoveInterpolatedNode(Node3D* node);
+
     int32_t GetBytesSent() const;
     int32_t GetBytesReceived() const;
+    uint32_t GetMessagesSent() const;
     float GetUploadRate() const;
     float GetDownloadRate() const;
 
@@ -122,7 +147,9 @@ public:
     void HandleReject(NetMsgReject::Reason reason);
     void HandleDisconnect(NetHost host);
     void HandleKick(NetMsgKick::Reason reason);
-    void HandleAck(NetHost host, uint16_t sequenceNumber);
+    void HandleAck(NetHost host, uint16_t sequenceNumber, uint32_t ackBits);
+    void HandleReplicateAck(NetHost host, uint16_t sequenceNumber, uint32_t ackBits);
+    void HandleServerTime(uint32_t timeMs);
     void HandleReady(NetHost host);
     void HandleBroadcast(
         NetHost host,
@@ -151,9 +178,21 @@ private:
     NetworkManager();
 
     void UpdateReplication(float deltaTime);
-    bool ReplicateNode(Node* node, NetId hostId, bool force, bool reliable);
+    void UpdateRelevancy();
+    bool AcceptRelevantNode(NetClient* client, Node* node);
+    bool GetClientViewPosition(NetClient* client, glm::vec3& outPosition);
+    float GetNodeRelevancyDistance(Node* node) const;
+    bool IsNodeRelevant(Node* node, NetClient* client, const glm::vec3* viewPos, float& outScale);
+    void AddRelevantNode(NetClient* client, Node* node, bool needsInitialRep);
+    void RemoveRelevantNode(NetClient* client, Node* node);
+    void UpdateRepSnapshot(Node* node);
+    uint32_t ReplicateNode(Node* node, NetClient* client, bool force, bool reliable);
+    void CommitRepPending(NetClient* client, const NetRepPending& pending);
+    void SendReplicateAck();
+    void UpdateInterpolation();
     void UpdateHostConnections(float deltaTime);
     void ProcessIncomingPackets(float deltaTime);
+    void ProcessIncomingPacket(char* data, int32_t bytes, NetHost sender);
     void ProcessMessages(NetHost sender, Stream& stream);
     void ProcessPendingReliablePackets(NetHostProfile* profile);
     NetHostId FindAvailableNetHostId();
@@ -161,17 +200,28 @@ private:
     void BroadcastSession();
     void FlushSendBuffers(NetHostProfile* hostProfile);
     void FlushSendBuffer(NetHostProfile* hostProfile, bool reliable);
+    void FlushSendQueue();
+    void TransmitTo(const NetHost& host, const char* buffer, uint32_t size);
+    void SimulateSendTo(const NetHost& host, const char* buffer, uint32_t size);
+    void UpdateSimulatedPackets(float deltaTime);
+    void RebuildClientLookup();
     void UpdateReliablePackets(float deltaTime);
     bool UpdateReliablePackets(NetHostProfile* profile, float deltaTime);
     void ResetHostProfile(NetHostProfile* profile);
-    bool HostProfileHasIncomingPacket(NetHostProfile* profile, uint16_t seq);
+    void SendReliablePackets(NetHostProfile* profile);
+    void SendReliableAck(NetHostProfile* profile);
+    void UpdateReliableRtt(NetHostProfile* profile, float rtt);
     bool SeqNumLess(uint16_t s1, uint16_t s2);
 
 
     NetStatus mNetStatus = NetStatus::Local;
     std::vector<NetClient> mClients;
+    std::unordered_map<uint64_t, uint32_t> mClientAddressMap;
+    std::unordered_map<uint64_t, uint32_t> mClientOnlineIdMap;
+    int16_t mClientIndexById[256] = {};
     std::vector<NetSession> mSessions;
     std::unordered_map<NetId, Node*> mNetNodeMap;
+    std::unordered_map<NetId, NetRepSnapshot> mRepSnapshots;
     NetServer mServer;
     uint32_t mBroadcastIp = 0;
     uint32_t mMaxClients = 15;
@@ -181,10 +231,23 @@ private:
     float mPingTimer = 0.0f;
     float mConnectTimeout = 5.0f;
     float mInactiveTimeout = 15.0f;
+    float mRelevancyTimer = 0.0f;
+    float mRelevancyDistance = 0.0f;
+    uint32_t mReplicationBandwidth = 0;
+    uint32_t mRepFrame = 0;
     float mUploadRate = 0;
     float mDownloadRate = 0;
     int32_t mBytesSent = 0;
     int32_t mBytesReceived = 0;
+    uint32_t mMessagesSent = 0;
+    std::vector<Node3D*> mInterpolatedNodes;
+    double mServerTimeOffset = 0.0;
+    double mPacketServerTime = 0.0;
+    float mInterpolationDelay = 0.1f;
+    float mMaxExtrapolation = 0.25f;
+    bool mHasServerTime = false;
+    NetSimConditions mSimConditions;
+    bool mSimEnabled = false;
     NetHostId mHostId = INVALID_HOST_ID;
     SocketHandle mSocket = NET_INVALID_SOCKET;
     SocketHandle mSearchSocket = NET_INVALID_SOCKET;
@@ -192,7 +255,7 @@ private:
     std::string mSessionName;
     bool mSearching = false;
     bool mEnableSessionBroadcast = true;
-    bool mIncrementalReplication = true;
+    bool mIncrementalReplication = false;
     bool mInOnlineSession = false;
 
     ScriptableFP<NetCallbackConnectFP> mConnectCallback;
@@ -6,6 +6,7 @@
 #include "Renderer.h"
 #include "Maths.h"
 #include "Assets/SkeletalMesh.h"
+#include "NetworkManager.h"
 
 #include "Nodes/3D/SkeletalMesh3d.h"
 
@@ -46,7 +47,15 @@ bool Node3D::OnRep_RootPosition(Datum* datum, uint32_t index, const void* newVal
     OCT_ASSERT(node3d != nullptr);
 
     glm::vec3* newPos = (glm::vec3*) newValue;
-    node3d->SetPosition(*newPos);
+
+    if (node3d->mNetSnapshots != nullptr)
+    {
+        node3d->PushNetSnapshot(newPos, nullptr);
+    }
+    else
+    {
+        node3d->SetPosition(*newPos);
+    }
 
     return true;
 }
@@ -57,7 +66,15 @@ bool Node3D::OnRep_RootRotation(Datum* datum, uint32_t index, const void* newVal
     OCT_ASSERT(node3d != nullptr);
 
     glm::vec3* newRot = (glm::vec3*) newValue;
-    node3d->SetRotation(*newRot);
+
+    if (node3d->mNetSnapshots != nullptr)
+    {
+        node3d->PushNetSnapshot(nullptr, newRot);
+    }
+    else
+    {
+        node3d->SetRotation(*newRot);
+    }
 
     return true;
 }
@@ -73,6 +90,13 @@ bool Node3D::OnRep_RootScale(Datum* datum, uint32_t index, const void* newValue)
     return true;
 }
 
+NetTransformSnapshot& NetSnapshotBuffer::Get(uint32_t index)
+{
+    OCT_ASSERT(index < mCount);
+    uint32_t oldest = mNewest + OCT_NET_SNAPSHOT_BUFFER_SIZE + 1 - mCount;
+    return mSnapshots[(oldest + index) % OCT_NET_SNAPSHOT_BUFFER_SIZE];
+}
+
 Node3D::Node3D() :
     mPosition(0,0,0),
     mRotationEuler(0,0,0),
@@ -87,7 +111,8 @@ Node3D::Node3D() :
 
 Node3D::~Node3D()
 {
-
+    delete mNetSnapshots;
+    mNetSnapshots = nullptr;
 }
 
 void Node3D::SaveStream(Stream& stream)
@@ -115,6 +140,8 @@ void Node3D::Destroy()
 {
     Node::Destroy();
 
+    EnableNetInterpolation(false);
+
 #if DEBUG_DRAW_ENABLED
     Renderer::Get()->RemoveDebugDrawsForNode(this);
 #endif
@@ -147,9 +174,9 @@ void Node3D::GatherReplicatedData(std::vector<NetDatum>& outData)
 
     if (mReplicateTransform)
     {
-        outData.push_back(NetDatum(DatumType::Vector, this, &mPosition, 1, OnRep_RootPosition));
-        outData.push_back(NetDatum(DatumType::Vector, this, &mRotationEuler, 1, OnRep_RootRotation));
-        outData.push_back(NetDatum(DatumType::Vector, this, &mScale, 1, OnRep_RootScale));
+        outData.push_back(NetDatum(DatumType::Vector, this, &mPosition, 1, OnRep_RootPosition).SetQuantizePrecision(1.0f / 512.0f));
+        outData.push_back(NetDatum(DatumType::Vector, this, &mRotationEuler, 1, OnRep_RootRotation).SetQuantizeRotation());
+        outData.push_back(NetDatum(DatumType::Vector, this, &mScale, 1, OnRep_RootScale).SetQuantizePrecision(1.0f / 256.0f));
     }
 }
 
@@ -651,3 +678,146 @@ void Node3D::SetParent(Node* parent)
     Node::SetParent(parent);
     MarkTransformDirty();
 }
+
+void Node3D::EnableNetInterpolation(bool enable)
+{
+    if (enable == (mNetSnapshots != nullptr))
+        return;
+
+    if (enable)
+    {
+        mNetSnapshots = new NetSnapshotBuffer();
+        NetworkManager::Get()->AddInterpolatedNode(this);
+    }
+    else
+    {
+        delete mNetSnapshots;
+        mNetSnapshots = nullptr;
+
+        if (NetworkManager::Get() != nullptr)
+        {
+            NetworkManager::Get()->RemoveInterpolatedNode(this);
+        }
+    }
+}
+
+bool Node3D::IsNetInterpolationEnabled() const
+{
+    return (mNetSnapshots != nullptr);
+}
+
+void Node3D::PushNetSnapshot(const glm::vec3* position, const glm::vec3* rotation)
+{
+    NetSnapshotBuffer& buffer = *mNetSnapshots;
+    double time = NetworkManager::Get()->GetPacketServerTime();
+
+    if (buffer.mCount > 0)
+    {
+        double newestTime = buffer.Get(buffer.mCount - 1).mTime;
+
+        if (time < newestTime - 1.0)
+        {
+            // The server clock jumped back, start over.
+            buffer.mCount = 0;
+        }
+        else if (time < newestTime)
+        {
+            // Stale. Only possible for a reliable packet that was resent.
+            return;
+        }
+    }
+
+    // Position and rotation arrive separately, so values from the same packet share one snapshot.
+    bool newSnapshot = (buffer.mCount == 0 || buffer.Get(buffer.mCount - 1).mTime != time);
+
+    if (newSnapshot)
+    {
+        NetTransformSnapshot prev;
+        prev.mPosition = mPosition;
+        prev.mRotation = mRotationQuat;
+
+        if (buffer.mCount > 0)
+        {
+            prev = buffer.Get(buffer.mCount - 1);
+        }
+
+        buffer.mNewest = (buffer.mNewest + 1) % OCT_NET_SNAPSHOT_BUFFER_SIZE;
+        buffer.mCount = glm::min<uint32_t>(buffer.mCount + 1, OCT_NET_SNAPSHOT_BUFFER_SIZE);
+        buffer.mSnapshots[buffer.mNewest] = prev;
+        buffer.mSnapshots[buffer.mNewest].mTime = time;
+    }
+
+    NetTransformSnapshot& snapshot = buffer.mSnapshots[buffer.mNewest];
+
+    if (position != nullptr)
+    {
+        snapshot.mPosition = *position;
+    }
+
+    if (rotation != nullptr)
+    {
+        snapshot.mRotation = glm::quat(*rotation * DEGREES_TO_RADIANS);
+    }
+}
+
+void Node3D::UpdateNetInterpolation(double renderTime, float maxExtrapolation)
+{
+    NetSnapshotBuffer& buffer = *mNetSnapshots;
+
+    if (buffer.mCount == 0)
+        return;
+
+    const NetTransformSnapshot& newest = buffer.Get(buffer.mCount - 1);
+    glm::vec3 position = newest.mPosition;
+    glm::quat rotation = newest.mRotation;
+
+    if (renderTime >= newest.mTime)
+    {
+        // Ran out of snapshots. Keep moving at the last known velocity for a limited time.
+        // Nothing is sent for a node that stopped moving, so once the window expires, ease
+        // back to the newest snapshot over the same amount of time instead of holding the overshoot.
+        if (buffer.mCount >= 2)
+        {
+            const NetTransformSnapshot& prev = buffer.Get(buffer.mCount - 2);
+            float interval = float(newest.mTime - prev.mTime);
+            float elapsed = float(renderTime - newest.mTime);
+            float extrapTime = (elapsed <= maxExtrapolation) ?
+                elapsed :
+                glm::max(2.0f * maxExtrapolation - elapsed, 0.0f);
+
+            if (interval > 0.0f)
+            {
+                position += (newest.mPosition - prev.mPosition) * (extrapTime / interval);
+            }
+        }
+    }
+    else
+    {
+        // Find the two snapshots that straddle the render time.
+        uint32_t next = buffer.mCount - 1;
+
+        while (next > 0 && buffer.Get(next - 1).mTime > renderTime)
+        {
+            --next;
+        }
+
+        if (next == 0)
+        {
+            // Render time is older than anything buffered.
+            position = buffer.Get(0).mPosition;
+            rotation = buffer.Get(0).mRotation;
+        }
+        else
+        {
+            const NetTransformSnapshot& a = buffer.Get(next - 1);
+            const NetTransformSnapshot& b = buffer.Get(next);
+            float alpha = float((renderTime - a.mTime) / (b.mTime - a.mTime));
+
+            position = glm::mix(a.mPosition, b.mPosition, alpha);
+            rotation = glm::slerp(a.mRotation, b.mRotation, alpha);
+        }
+    }
+
+    SetPosition(position);
+    SetRotation(rotation);
+}
@@ -9,6 +9,23 @@
 
 class SkeletalMesh3D;
 
+struct NetTransformSnapshot
+{
+    double mTime = 0.0;
+    glm::vec3 mPosition = {};
+    glm::quat mRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+};
+
+struct NetSnapshotBuffer
+{
+    NetTransformSnapshot mSnapshots[OCT_NET_SNAPSHOT_BUFFER_SIZE];
+    uint32_t mCount = 0;
+    uint32_t mNewest = 0;
+
+    // 0 is the oldest snapshot.
+    NetTransformSnapshot& Get(uint32_t index);
+};
+
 class Node3D : public Node
 {
 public:
@@ -91,8 +108,16 @@ public:
     static bool OnRep_RootRotation(Datum* datum, uint32_t index, const void* newValue);
     static bool OnRep_RootScale(Datum* datum, uint32_t index, const void* newValue);
 
+    // When enabled, replicated position and rotation are buffered on clients and played back
+    // smoothly (see NetworkManager::SetInterpolationDelay()) instead of being applied immediately.
+    void EnableNetInterpolation(bool enable);
+    bool IsNetInterpolationEnabled() const;
+    void UpdateNetInterpolation(double renderTime, float maxExtrapolation);
+
 protected:
 
+    void PushNetSnapshot(const glm::vec3* position, const glm::vec3* rotation);
+
     virtual void SetParent(Node* parent) override;
 
     glm::vec3 mPosition;
@@ -104,5 +129,7 @@ protected:
     glm::mat4 mTransform;
     int32_t mParentBoneIndex;
 
+    NetSnapshotBuffer* mNetSnapshots = nullptr;
+
     bool mTransformDirty;
 };
\ No newline at end of file
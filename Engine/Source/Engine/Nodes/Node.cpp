@@ -8,6 +8,7 @@
 #include "Utilities.h"
 #include "Engine.h"
 #include "Script.h"
+#include "ScriptScheduler.h"
 #include "ObjectRef.h"
 #include "NetworkManager.h"
 #include "Assets/Scene.h"
@@ -55,6 +56,16 @@
         } \
     }
 
+// Params are taken by const reference so that invoking doesn't copy (and allocate) each Datum
+// unless the func also executes locally. NetFunc handlers take Datum& and may modify their params,
+// so they get a copy that lives until the handler returns, rather than the caller's Datum.
+static Datum& NetFuncParamCopy(Datum&& param)
+{
+    return param;
+}
+
+#define NET_FUNC_PARAM(I) NetFuncParamCopy(Datum(param##I))
+
 std::unordered_map<TypeId, NetFuncMap> Node::sTypeNetFuncMap;
 
 #define ENABLE_SCRIPT_FUNCS 1
@@ -182,8 +193,11 @@ void Node::Destroy()
     if (IsPrimitive3D() && GetWorld())
     {
         GetWorld()->PurgeOverlaps(static_cast<Primitive3D*>(this));
+        Script::HandlePrimitiveDestroyed(static_cast<Primitive3D*>(this));
     }
 
+    ScriptScheduler::HandleNodeDestroyed(this);
+
     if (mParent != nullptr)
     {
         Attach(nullptr);
@@ -1045,6 +1059,26 @@ ReplicationRate Node::GetReplicationRate() const
     return mReplicationRate;
 }
 
+void Node::SetNetRelevancy(NetRelevancy relevancy)
+{
+    mNetRelevancy = relevancy;
+}
+
+NetRelevancy Node::GetNetRelevancy() const
+{
+    return mNetRelevancy;
+}
+
+void Node::SetNetRelevancyDistance(float distance)
+{
+    mNetRelevancyDistance = glm::max(distance, 0.0f);
+}
+
+float Node::GetNetRelevancyDistance() const
+{
+    return mNetRelevancyDistance;
+}
+
 bool Node::HasTag(const std::string& tag)
 {
     bool hasTag = false;
@@ -1642,60 +1676,60 @@ void Node::InvokeNetFunc(const char* name)
     if (shouldExecute) { netFunc->mFuncPointer.p0(this); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0)
+void Node::InvokeNetFunc(const char* name, const Datum& param0)
 {
     const Datum* params[] = { &param0 };
     INVOKE_NET_FUNC_BODY(1);
-    if (shouldExecute) { netFunc->mFuncPointer.p1(this, param0); }
+    if (shouldExecute) { netFunc->mFuncPointer.p1(this, NET_FUNC_PARAM(0)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1)
 {
     const Datum* params[] = { &param0, &param1 };
     INVOKE_NET_FUNC_BODY(2);
-    if (shouldExecute) { netFunc->mFuncPointer.p2(this, param0, param1); }
+    if (shouldExecute) { netFunc->mFuncPointer.p2(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2)
 {
     const Datum* params[] = { &param0, &param1, &param2 };
     INVOKE_NET_FUNC_BODY(3);
-    if (shouldExecute) { netFunc->mFuncPointer.p3(this, param0, param1, param2); }
+    if (shouldExecute) { netFunc->mFuncPointer.p3(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1), NET_FUNC_PARAM(2)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3)
 {
     const Datum* params[] = { &param0, &param1, &param2, &param3 };
     INVOKE_NET_FUNC_BODY(4);
-    if (shouldExecute) { netFunc->mFuncPointer.p4(this, param0, param1, param2, param3); }
+    if (shouldExecute) { netFunc->mFuncPointer.p4(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1), NET_FUNC_PARAM(2), NET_FUNC_PARAM(3)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4)
 {
     const Datum* params[] = { &param0, &param1, &param2, &param3, &param4 };
     INVOKE_NET_FUNC_BODY(5);
-    if (shouldExecute) { netFunc->mFuncPointer.p5(this, param0, param1, param2, param3, param4); }
+    if (shouldExecute) { netFunc->mFuncPointer.p5(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1), NET_FUNC_PARAM(2), NET_FUNC_PARAM(3), NET_FUNC_PARAM(4)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4, Datum param5)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5)
 {
     const Datum* params[] = { &param0, &param1, &param2, &param3, &param4, &param5 };
     INVOKE_NET_FUNC_BODY(6);
-    if (shouldExecute) { netFunc->mFuncPointer.p6(this, param0, param1, param2, param3, param4, param5); }
+    if (shouldExecute) { netFunc->mFuncPointer.p6(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1), NET_FUNC_PARAM(2), NET_FUNC_PARAM(3), NET_FUNC_PARAM(4), NET_FUNC_PARAM(5)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4, Datum param5, Datum param6)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5, const Datum& param6)
 {
     const Datum* params[] = { &param0, &param1, &param2, &param3, &param4, &param5, &param6 };
     INVOKE_NET_FUNC_BODY(7);
-    if (shouldExecute) { netFunc->mFuncPointer.p7(this, param0, param1, param2, param3, param4, param5, param6); }
+    if (shouldExecute) { netFunc->mFuncPointer.p7(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1), NET_FUNC_PARAM(2), NET_FUNC_PARAM(3), NET_FUNC_PARAM(4), NET_FUNC_PARAM(5), NET_FUNC_PARAM(6)); }
 }
 
-void Node::InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4, Datum param5, Datum param6, Datum param7)
+void Node::InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5, const Datum& param6, const Datum& param7)
 {
     const Datum* params[] = { &param0, &param1, &param2, &param3, &param4, &param5, &param6, &param7 };
     INVOKE_NET_FUNC_BODY(8);
-    if (shouldExecute) { netFunc->mFuncPointer.p8(this, param0, param1, param2, param3, param4, param5, param6, param7); }
+    if (shouldExecute) { netFunc->mFuncPointer.p8(this, NET_FUNC_PARAM(0), NET_FUNC_PARAM(1), NET_FUNC_PARAM(2), NET_FUNC_PARAM(3), NET_FUNC_PARAM(4), NET_FUNC_PARAM(5), NET_FUNC_PARAM(6), NET_FUNC_PARAM(7)); }
 }
 
 void Node::InvokeNetFunc(const char* name, const std::vector<Datum>& params)
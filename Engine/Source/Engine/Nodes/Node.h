@@ -168,6 +168,11 @@ public:
     ReplicationRate GetReplicationRate() const;
     //void SetReplicationRate(ReplicationRate rate);
 
+    void SetNetRelevancy(NetRelevancy relevancy);
+    NetRelevancy GetNetRelevancy() const;
+    void SetNetRelevancyDistance(float distance);
+    float GetNetRelevancyDistance() const;
+
     bool HasTag(const std::string& tag);
     void AddTag(const std::string& tag);
     void RemoveTag(const std::string& tag);
@@ -238,14 +243,14 @@ public:
     NetFunc* FindNetFunc(uint16_t index);
 
     void InvokeNetFunc(const char* name);
-    void InvokeNetFunc(const char* name, Datum param0);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4, Datum param5);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4, Datum param5, Datum param6);
-    void InvokeNetFunc(const char* name, Datum param0, Datum param1, Datum param2, Datum param3, Datum param4, Datum param5, Datum param6, Datum param7);
+    void InvokeNetFunc(const char* name, const Datum& param0);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5, const Datum& param6);
+    void InvokeNetFunc(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5, const Datum& param6, const Datum& param7);
     void InvokeNetFunc(const char* name, const std::vector<Datum>& params);
 
     static void RegisterNetFuncs(Node* node);
@@ -398,6 +403,8 @@ protected:
     bool mReplicateTransform = false;
     bool mForceReplicate = false;
     ReplicationRate mReplicationRate = ReplicationRate::High;
+    NetRelevancy mNetRelevancy = NetRelevancy::Default;
+    float mNetRelevancyDistance = 0.0f; // 0 = use NetworkManager's relevancy distance
 
     Script* mScript = nullptr;
     int mUserdataRef = LUA_REFNIL;
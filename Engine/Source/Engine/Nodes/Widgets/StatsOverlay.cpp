@@ -5,6 +5,8 @@
 #include "Profiler.h"
 #include "Engine.h"
 #include "NetworkManager.h"
+#include "ScriptUtils.h"
+#include "ScriptProfiler.h"
 
 #include "System/System.h"
 
@@ -12,6 +14,10 @@ FORCE_LINK_DEF(StatsOverlay);
 DEFINE_NODE(StatsOverlay, Canvas);
 
 #define DEFAULT_STAT_COLOR glm::vec4(0.4f, 1.0f, 0.4f, 1.0f)
+#define SCRIPT_SAMPLE_STAT_COLOR glm::vec4(0.4f, 0.8f, 1.0f, 1.0f)
+
+static std::vector<const ScriptClassStat*> sScriptClassStats;
+static std::vector<const ScriptSampleStat*> sScriptSampleStats;
 
 StatsOverlay::StatsOverlay()
 {
@@ -59,11 +65,18 @@ void StatsOverlay::TickCommon(float deltaTime)
         numStats += (uint32_t)GetProfiler()->GetGpuStats().size();
         break;
     case StatDisplayMode::Memory:
-        numStats = 1;
+        numStats = 2;
         break;
     case StatDisplayMode::Network:
         numStats = 2;
         break;
+    case StatDisplayMode::Script:
+        ScriptProfiler::GetClassStats(sScriptClassStats);
+        ScriptProfiler::GetSampleStats(sScriptSampleStats);
+        sScriptClassStats.resize(glm::min<size_t>(sScriptClassStats.size(), mMaxScriptStats));
+        sScriptSampleStats.resize(glm::min<size_t>(sScriptSampleStats.size(), mMaxScriptStats));
+        numStats = uint32_t(sScriptClassStats.size() + sScriptSampleStats.size());
+        break;
     default:
         numStats = 0;
         break;
@@ -107,6 +120,7 @@ void StatsOverlay::TickCommon(float deltaTime)
 #else
         SetStatText(0, "Free Memory", SYS_GetNumBytesFree() / static_cast<float>(1024 * 1024), DEFAULT_STAT_COLOR, statY);
 #endif
+        SetStatText(1, "Lua Memory", ScriptUtils::GetMemoryUsage() / static_cast<float>(1024 * 1024), DEFAULT_STAT_COLOR, statY);
     }
     else if (mDisplayMode == StatDisplayMode::Network)
     {
@@ -114,6 +128,25 @@ void StatsOverlay::TickCommon(float deltaTime)
         SetStatText(0, "Upload", netMan->GetUploadRate() / 1024, DEFAULT_STAT_COLOR, statY);
         SetStatText(1, "Download", netMan->GetDownloadRate() / 1024, DEFAULT_STAT_COLOR, statY);
     }
+    else if (mDisplayMode == StatDisplayMode::Script)
+    {
+        // Tick ms per frame for the most expensive classes, then the hottest sampled lines in percent.
+        uint32_t uStat = 0;
+
+        for (uint32_t i = 0; i < sScriptClassStats.size(); ++i)
+        {
+            SetStatText(uStat, sScriptClassStats[i]->mClassName.c_str(), sScriptClassStats[i]->mSmoothedTime, DEFAULT_STAT_COLOR, statY);
+            ++uStat;
+        }
+
+        float totalSamples = float(glm::max<uint32_t>(ScriptProfiler::GetTotalSamples(), 1));
+
+        for (uint32_t i = 0; i < sScriptSampleStats.size(); ++i)
+        {
+            SetStatText(uStat, sScriptSampleStats[i]->mLocation.c_str(), 100.0f * sScriptSampleStats[i]->mNumSamples / totalSamples, SCRIPT_SAMPLE_STAT_COLOR, statY);
+            ++uStat;
+        }
+    }
     else
     {
         const std::vector<CpuStat>& cpuStats = GetProfiler()->GetCpuFrameStats();
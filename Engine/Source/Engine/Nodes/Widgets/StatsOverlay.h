@@ -14,6 +14,7 @@ enum class StatDisplayMode
     AllStatText,
     Memory,
     Network,
+    Script,
 
     Count
 };
@@ -36,6 +37,7 @@ public:
     void SetStatText(uint32_t index, const char* key, float value, glm::vec4 color, float& y);
 
     float mTextSize = 14.0f;
+    uint32_t mMaxScriptStats = 8;
 
     std::vector<Text*> mStatKeyTexts;
     std::vector<Text*> mStatValueTexts;
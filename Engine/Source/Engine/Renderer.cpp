@@ -1174,6 +1174,12 @@ void Renderer::Render(World* world, int32_t screenIndex)
         return;
     }
 
+    if (IsHeadless())
+    {
+        // Nothing to present, so skip gathering, culling and drawing entirely.
+        return;
+    }
+
     mCurrentWorld = world;
     mScreenIndex = screenIndex;
 
@@ -5,6 +5,7 @@
 #include "Assets/SkeletalMesh.h"
 #include "Engine.h"
 #include "Log.h"
+#include "ScriptProfiler.h"
 
 #include "Nodes/Widgets/Button.h"
 #include "Nodes/Widgets/Selector.h"
@@ -18,7 +19,31 @@
 #include "LuaBindings/Widget_Lua.h"
 #include "LuaBindings/World_Lua.h"
 
+#include <algorithm>
+
 std::unordered_map<std::string, ScriptNetFuncMap> Script::sScriptNetFuncMap;
+std::unordered_map<std::string, ScriptClassCache> Script::sClassCaches;
+std::unordered_map<std::string, std::string> Script::sFileClassNames;
+std::vector<Script*> Script::sPhysicsEventScripts;
+float Script::sCollisionEventInterval = 0.0f;
+bool Script::sDispatchingPhysicsEvents = false;
+
+static const char* sCallbackNames[uint32_t(ScriptCallback::Count)] =
+{
+    "Tick",
+    "EditorTick",
+    "BeginOverlap",
+    "EndOverlap",
+    "OnCollision",
+    "OnPhysicsEvents"
+};
+
+static const char* sPhysicsEventTypeNames[uint32_t(ScriptPhysicsEventType::Count)] =
+{
+    "BeginOverlap",
+    "EndOverlap",
+    "Collision"
+};
 
 bool Script::HandleScriptPropChange(Datum* datum, uint32_t index, const void* newValue)
 {
@@ -77,6 +102,11 @@ bool Script::HandleForeignScriptPropChange(Datum* datum, uint32_t index, const v
 Script::Script(Node* owner)
 {
     mOwner = owner;
+
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        mCallbackRefs[i] = LUA_REFNIL;
+    }
 }
 
 Script::~Script()
@@ -142,6 +172,19 @@ void Script::GatherScriptProperties()
         // we still want to re-gather the properties because some may have been added or deleted.
         mScriptProps.clear();
 
+        if (!GetClassCache().mPropDefsGathered)
+        {
+            // Gathering runs Lua which may load other classes, so only look up the cache entry afterwards.
+            std::vector<Property> propDefs;
+            GatherScriptPropertyDefs(propDefs);
+
+            ScriptClassCache& classCache = GetClassCache();
+            classCache.mPropDefs.swap(propDefs);
+            classCache.mPropDefsGathered = true;
+        }
+
+        const ScriptClassCache& classCache = GetClassCache();
+
         lua_State* L = GetLua();
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
 
@@ -149,277 +192,197 @@ void Script::GatherScriptProperties()
         {
             int udIdx = lua_gettop(L);
 
-            lua_getfield(L, -1, "GatherProperties");
-
-            if (lua_isfunction(L, -1))
+            for (uint32_t p = 0; p < classCache.mPropDefs.size(); ++p)
             {
-                lua_pushvalue(L, -2);   // arg1 - self
-                LuaFuncCall(1, 1);
+                const Property& propDef = classCache.mPropDefs[p];
+                const char* name = propDef.mName.c_str();
+                DatumType type = propDef.GetType();
+                bool isArray = propDef.IsVector();
 
-                if (lua_istable(L, -1))
+                Property newProp = propDef;
+                newProp.mOwner = this;
+                newProp.mExternal = false;
+                newProp.mChangeHandler = HandleScriptPropChange;
+
+                int32_t count = 1;
+                int tableIdx = -1;
+
+                if (isArray)
                 {
-                    // GatherProperties func should return an array
-                    // of tables. Each table in the array contains the
-                    // Property name, data type, count
-                    int arrayIdx = lua_gettop(L);
+                    lua_getfield(L, udIdx, name);
 
-                    // Get number of properties.
-                    lua_len(L, arrayIdx);
-                    int32_t numProps = lua_tointeger(L, -1);
+                    if (!lua_istable(L, -1))
+                    {
+                        lua_pop(L, 1);
+                        lua_newtable(L);
+                        tableIdx = lua_gettop(L);
+
+                        // Push a copy of the arraytable on the stack so it can be used later.
+                        lua_pushvalue(L, -1);
+
+                        lua_setfield(L, udIdx, name);
+                    }
+                    else
+                    {
+                        tableIdx = lua_gettop(L);
+                    }
+
+                    lua_len(L, tableIdx);
+                    count = lua_tointeger(L, -1);
                     lua_pop(L, 1);
+                }
+
+                for (int32_t i = 0; i < count; ++i)
+                {
+                    lua_getfield(L, isArray ? tableIdx : udIdx, name);
 
-                    // Loop through each property
-                    for (int32_t i = 1; i <= numProps; ++i)
+                    if (lua_isnil(L, -1) &&
+                        type != DatumType::Asset)
                     {
-                        lua_geti(L, arrayIdx, i);
+                        // Pop nil
+                        lua_pop(L, 1);
 
-                        if (lua_istable(L, -1))
+                        // Add a defaulted member to the table and leave the it on the stack
+                        // so that we can initialize the Property correctly later.
+                        switch (type)
                         {
-                            int propIdx = lua_gettop(L);
-                            Property newProp;
-                            
-#if EDITOR
-                            newProp.mCategory = "Script";
-#endif
+                        case DatumType::Integer: lua_pushinteger(L, 0); break;
+                        case DatumType::Float: lua_pushnumber(L, 0.0f); break;
+                        case DatumType::Bool: lua_pushboolean(L, false); break;
+                        case DatumType::String: lua_pushstring(L, ""); break;
+                        case DatumType::Vector2D: Vector_Lua::Create(L, glm::vec2(0.0f, 0.0f)); break;
+                        case DatumType::Vector: Vector_Lua::Create(L, glm::vec3(0.0f, 0.0f, 0.0f)); break;
+                        case DatumType::Color: Vector_Lua::Create(L, glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)); break;
+                        case DatumType::Byte: lua_pushinteger(L, 0); break;
+                        case DatumType::Short: lua_pushinteger(L, 0); break;
+
+
+                        default:
+                            lua_pushnil(L);
+                            break;
+                        }
 
-                            lua_getfield(L, propIdx, "name");
-                            const char* name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
-                            newProp.mName = name;
-                            lua_pop(L, 1);
+                        // Put a duplicate of the value on the stack so it will remain after setting the field.
+                        lua_pushvalue(L, -1);
 
-                            lua_getfield(L, propIdx, "type");
-                            DatumType type = lua_isinteger(L, -1) ? (DatumType)lua_tointeger(L, -1) : DatumType::Count;
-                            newProp.mType = type;
-                            lua_pop(L, 1);
+                        if (isArray)
+                        {
+                            lua_seti(L, tableIdx, int(i + 1));
+                        }
+                        else
+                        {
+                            lua_setfield(L, udIdx, name);
+                        }
+                    }
 
-                            // In the future, possibly support "count", "minCount", and "maxCount"
-                            //int32_t count = 1;
-                            //lua_getfield(L, propIdx, "count");
-                            //if (lua_isinteger(L, -1))
-                            //{
-                            //    count = lua_tointeger(L, -1);
-                            //}
-                            //lua_pop(L, 1);
-
-                            bool isArray = false;
-                            lua_getfield(L, propIdx, "array");
-                            isArray = lua_toboolean(L, -1);
-                            lua_pop(L, 1);
+                    switch (type)
+                    {
+                    case DatumType::Integer:
+                    {
+                        int32_t value = CHECK_INTEGER(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::Float:
+                    {
+                        float value = CHECK_NUMBER(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::Bool:
+                    {
+                        bool value = CHECK_BOOLEAN(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::String:
+                    {
+                        const char* value = CHECK_STRING(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::Vector2D:
+                    {
+                        glm::vec2 value = CHECK_VECTOR(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::Vector:
+                    {
+                        glm::vec3 value = CHECK_VECTOR(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::Color:
+                    {
+                        glm::vec4 value = CHECK_VECTOR(L, -1);
+                        newProp.PushBack(value);
+                        break;
+                    }
+                    case DatumType::Asset:
+                    {
+                        Asset* asset = nullptr;
+                        if (!lua_isnil(L, -1))
+                        {
+                            asset = CHECK_ASSET(L, -1);
+                        }
+                        newProp.PushBack(asset);
+                        break;
+                    }
+                    case DatumType::Byte:
+                    {
+                        int32_t value = CHECK_INTEGER(L, -1);
+                        newProp.PushBack((uint8_t)value);
+                        break;
+                    }
 
-                            newProp.mOwner = this;
-                            newProp.mExternal = false;
-                            newProp.mChangeHandler = HandleScriptPropChange;
+                    case DatumType::Table:
+                    {
+                        LogError("Table script properties are not supported.");
+                        OCT_ASSERT(0);
+                        break;
+                    }
 
-                            if (isArray)
-                            {
-                                newProp.MakeVector();
-                            }
+                    case DatumType::Pointer:
+                    {
+                        LogError("Pointer script properties are not supported.");
+                        OCT_ASSERT(0);
+                        break;
+                    }
 
-                            // Setup initial value and push it onto the outProps vector.
-                            // Table and pointer datum types are not supported for script props.
-                            if (newProp.mName != "" &&
-                                type != DatumType::Count &&
-                                type != DatumType::Table &&
-                                type != DatumType::Pointer)
-                            {
-                                int32_t count = 1;
-                                int tableIdx = -1;
-
-                                if (isArray)
-                                {
-                                    lua_getfield(L, udIdx, name);
-
-                                    if (!lua_istable(L, -1))
-                                    {
-                                        lua_pop(L, 1);
-                                        lua_newtable(L);
-                                        tableIdx = lua_gettop(L);
-
-                                        // Push a copy of the arraytable on the stack so it can be used later.
-                                        lua_pushvalue(L, -1);
-
-                                        lua_setfield(L, udIdx, name);
-                                    }
-                                    else
-                                    {
-                                        tableIdx = lua_gettop(L);
-                                    }
-
-                                    lua_len(L, tableIdx);
-                                    count = lua_tointeger(L, -1);
-                                    lua_pop(L, 1);
-                                }
-
-                                for (int32_t i = 0; i < count; ++i)
-                                {
-                                    lua_getfield(L, isArray ? tableIdx : udIdx, name);
-
-                                    if (lua_isnil(L, -1) &&
-                                        type != DatumType::Asset)
-                                    {
-                                        // Pop nil
-                                        lua_pop(L, 1);
-
-                                        // Add a defaulted member to the table and leave the it on the stack
-                                        // so that we can initialize the Property correctly later.
-                                        switch (type)
-                                        {
-                                        case DatumType::Integer: lua_pushinteger(L, 0); break;
-                                        case DatumType::Float: lua_pushnumber(L, 0.0f); break;
-                                        case DatumType::Bool: lua_pushboolean(L, false); break;
-                                        case DatumType::String: lua_pushstring(L, ""); break;
-                                        case DatumType::Vector2D: Vector_Lua::Create(L, glm::vec2(0.0f, 0.0f)); break;
-                                        case DatumType::Vector: Vector_Lua::Create(L, glm::vec3(0.0f, 0.0f, 0.0f)); break;
-                                        case DatumType::Color: Vector_Lua::Create(L, glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)); break;
-                                        case DatumType::Byte: lua_pushinteger(L, 0); break;
-                                        case DatumType::Short: lua_pushinteger(L, 0); break;
-
-
-                                        default:
-                                            lua_pushnil(L);
-                                            break;
-                                        }
-
-                                        // Put a duplicate of the value on the stack so it will remain after setting the field.
-                                        lua_pushvalue(L, -1);
-
-                                        if (isArray)
-                                        {
-                                            lua_seti(L, tableIdx, int(i + 1));
-                                        }
-                                        else
-                                        {
-                                            lua_setfield(L, udIdx, name);
-                                        }
-                                    }
-
-                                    switch (type)
-                                    {
-                                    case DatumType::Integer:
-                                    {
-                                        int32_t value = CHECK_INTEGER(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::Float:
-                                    {
-                                        float value = CHECK_NUMBER(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::Bool:
-                                    {
-                                        bool value = CHECK_BOOLEAN(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::String:
-                                    {
-                                        const char* value = CHECK_STRING(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::Vector2D:
-                                    {
-                                        glm::vec2 value = CHECK_VECTOR(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::Vector:
-                                    {
-                                        glm::vec3 value = CHECK_VECTOR(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::Color:
-                                    {
-                                        glm::vec4 value = CHECK_VECTOR(L, -1);
-                                        newProp.PushBack(value);
-                                        break;
-                                    }
-                                    case DatumType::Asset:
-                                    {
-                                        Asset* asset = nullptr;
-                                        if (!lua_isnil(L, -1))
-                                        {
-                                            asset = CHECK_ASSET(L, -1);
-                                        }
-                                        newProp.PushBack(asset);
-                                        break;
-                                    }
-                                    case DatumType::Byte:
-                                    {
-                                        int32_t value = CHECK_INTEGER(L, -1);
-                                        newProp.PushBack((uint8_t)value);
-                                        break;
-                                    }
-
-                                    case DatumType::Table:
-                                    {
-                                        LogError("Table script properties are not supported.");
-                                        OCT_ASSERT(0);
-                                        break;
-                                    }
-
-                                    case DatumType::Pointer:
-                                    {
-                                        LogError("Pointer script properties are not supported.");
-                                        OCT_ASSERT(0);
-                                        break;
-                                    }
-
-                                    case DatumType::Short:
-                                    {
-                                        int32_t value = CHECK_INTEGER(L, -1);
-                                        newProp.PushBack((int16_t)value);
-                                        break;
-                                    }
-
-                                    case DatumType::Function:
-                                    {
-                                        LogError("Function script properties are not supported.");
-                                        OCT_ASSERT(0);
-                                        break;
-                                    }
-
-                                    case DatumType::Count:
-                                    {
-                                        OCT_ASSERT(0); // Unreachable
-                                        break;
-                                    }
-                                    }
-
-                                    // Pop initial value
-                                    lua_pop(L, 1);
-                                }
-
-
-                                mScriptProps.push_back(newProp);
-
-                                if (tableIdx != -1)
-                                {
-                                    // pop the array table
-                                    lua_pop(L, 1);
-                                }
-                            }
-                            else
-                            {
-                                LogWarning("Invalid script property found.");
-                            }
-                        }
+                    case DatumType::Short:
+                    {
+                        int32_t value = CHECK_INTEGER(L, -1);
+                        newProp.PushBack((int16_t)value);
+                        break;
+                    }
 
-                        // Pop property object
-                        lua_pop(L, 1);
+                    case DatumType::Function:
+                    {
+                        LogError("Function script properties are not supported.");
+                        OCT_ASSERT(0);
+                        break;
                     }
+
+                    case DatumType::Count:
+                    {
+                        OCT_ASSERT(0); // Unreachable
+                        break;
+                    }
+                    }
+
+                    // Pop initial value
+                    lua_pop(L, 1);
                 }
 
-                // Pop GatherProperties() return value (hopefully a table)
-                lua_pop(L, 1);
-            }
-            else
-            {
-                // Pop non-function value
-                lua_pop(L, 1);
+
+                mScriptProps.push_back(newProp);
+
+                if (tableIdx != -1)
+                {
+                    // pop the array table
+                    lua_pop(L, 1);
+                }
             }
         }
 
@@ -429,6 +392,110 @@ void Script::GatherScriptProperties()
 #endif
 }
 
+void Script::GatherScriptPropertyDefs(std::vector<Property>& outDefs)
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+    lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+
+    if (lua_isuserdata(L, -1))
+    {
+        lua_getfield(L, -1, "GatherProperties");
+
+        if (lua_isfunction(L, -1))
+        {
+            lua_pushvalue(L, -2);   // arg1 - self
+            LuaFuncCall(1, 1);
+
+            if (lua_istable(L, -1))
+            {
+                // GatherProperties func should return an array
+                // of tables. Each table in the array contains the
+                // Property name, data type, count
+                int arrayIdx = lua_gettop(L);
+
+                // Get number of properties.
+                lua_len(L, arrayIdx);
+                int32_t numProps = lua_tointeger(L, -1);
+                lua_pop(L, 1);
+
+                // Loop through each property
+                for (int32_t i = 1; i <= numProps; ++i)
+                {
+                    lua_geti(L, arrayIdx, i);
+
+                    if (lua_istable(L, -1))
+                    {
+                        int propIdx = lua_gettop(L);
+                        Property newProp;
+
+#if EDITOR
+                        newProp.mCategory = "Script";
+#endif
+
+                        lua_getfield(L, propIdx, "name");
+                        const char* name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
+                        newProp.mName = name;
+                        lua_pop(L, 1);
+
+                        lua_getfield(L, propIdx, "type");
+                        DatumType type = lua_isinteger(L, -1) ? (DatumType)lua_tointeger(L, -1) : DatumType::Count;
+                        newProp.mType = type;
+                        lua_pop(L, 1);
+
+                        // In the future, possibly support "count", "minCount", and "maxCount"
+                        //int32_t count = 1;
+                        //lua_getfield(L, propIdx, "count");
+                        //if (lua_isinteger(L, -1))
+                        //{
+                        //    count = lua_tointeger(L, -1);
+                        //}
+                        //lua_pop(L, 1);
+
+                        bool isArray = false;
+                        lua_getfield(L, propIdx, "array");
+                        isArray = lua_toboolean(L, -1);
+                        lua_pop(L, 1);
+
+                        if (isArray)
+                        {
+                            newProp.MakeVector();
+                        }
+
+                        // Table and pointer datum types are not supported for script props.
+                        if (newProp.mName != "" &&
+                            type != DatumType::Count &&
+                            type != DatumType::Table &&
+                            type != DatumType::Pointer)
+                        {
+                            outDefs.push_back(newProp);
+                        }
+                        else
+                        {
+                            LogWarning("Invalid script property found.");
+                        }
+                    }
+
+                    // Pop property object
+                    lua_pop(L, 1);
+                }
+            }
+
+            // Pop GatherProperties() return value (hopefully a table)
+            lua_pop(L, 1);
+        }
+        else
+        {
+            // Pop non-function value
+            lua_pop(L, 1);
+        }
+    }
+
+    // Pop node userdata
+    lua_pop(L, 1);
+#endif
+}
+
 const std::vector<Property>& Script::GetScriptProperties() const
 {
     return mScriptProps;
@@ -450,234 +517,358 @@ void Script::GatherReplicatedData()
 
         bool isServer = NetIsServer();
 
+        if (!GetClassCache().mRepDefsGathered)
+        {
+            std::vector<ScriptNetDatum> repDefs;
+            GatherReplicatedDataDefs(repDefs);
+
+            // Table and function types are skipped below, so they don't get an index.
+            std::shared_ptr<ScriptRepIndexMap> repIndices = std::make_shared<ScriptRepIndexMap>();
+            uint32_t repIndex = 0;
+
+            for (uint32_t d = 0; d < repDefs.size(); ++d)
+            {
+                DatumType type = repDefs[d].GetType();
+
+                if (type != DatumType::Table &&
+                    type != DatumType::Function &&
+                    type != DatumType::Count)
+                {
+                    repIndices->insert({ repDefs[d].mVarName, repIndex++ });
+                }
+            }
+
+            ScriptClassCache& classCache = GetClassCache();
+            classCache.mRepDefs.swap(repDefs);
+            classCache.mRepIndices = repIndices;
+            classCache.mRepDefsGathered = true;
+        }
+
+        const ScriptClassCache& classCache = GetClassCache();
+        mRepIndices = classCache.mRepIndices;
+        mReplicatedDataStale = false;
+
         lua_State* L = GetLua();
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
         if (lua_isuserdata(L, -1))
         {
             int udIdx = lua_gettop(L);
 
-            lua_getfield(L, -1, "GatherReplicatedData");
-
-            if (lua_isfunction(L, -1))
+            for (uint32_t d = 0; d < classCache.mRepDefs.size(); ++d)
             {
-                lua_pushvalue(L, -2);   // arg1 - self
-                LuaFuncCall(1, 1);
+                const ScriptNetDatum& datumDef = classCache.mRepDefs[d];
+                const char* name = datumDef.mVarName.c_str();
+                DatumType type = datumDef.GetType();
 
-                if (lua_istable(L, -1))
-                {
-                    // GatherReplicatedData func should return an array
-                    // of tables. Each table in the array contains the
-                    // NetDatum name, data type, count
-                    int arrayIdx = lua_gettop(L);
+                ScriptNetDatum newDatum = datumDef;
+                newDatum.mOwner = this;
+                newDatum.mExternal = false;
+                newDatum.mChangeHandler = isServer ? nullptr : OnRepHandler;
 
-                    // Get number of properties.
-                    lua_len(L, arrayIdx);
-                    int32_t numProps = lua_tointeger(L, -1);
+                lua_getfield(L, udIdx, name);
+
+                if (lua_isnil(L, -1) &&
+                    type != DatumType::Asset)
+                {
+                    // Pop nil
                     lua_pop(L, 1);
 
-                    // Loop through each property
-                    for (int32_t i = 1; i <= numProps; ++i)
+                    // Add a defaulted member to the table and leave the it on the stack
+                    // so that we can initialize the Property correctly later.
+                    switch (type)
                     {
-                        lua_geti(L, arrayIdx, i);
+                    case DatumType::Integer: lua_pushinteger(L, 0); break;
+                    case DatumType::Float: lua_pushnumber(L, 0.0f); break;
+                    case DatumType::Bool: lua_pushboolean(L, false); break;
+                    case DatumType::String: lua_pushstring(L, ""); break;
+                    case DatumType::Vector2D: Vector_Lua::Create(L, glm::vec2(0.0f, 0.0f)); break;
+                    case DatumType::Vector: Vector_Lua::Create(L, glm::vec3(0.0f, 0.0f, 0.0f)); break;
+                    case DatumType::Color: Vector_Lua::Create(L, glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)); break;
+                    case DatumType::Byte: lua_pushinteger(L, 0); break;
+                    case DatumType::Short: lua_pushinteger(L, 0); break;
+
+                    default:
+                        lua_pushnil(L);
+                        break;
+                    }
 
-                        if (lua_istable(L, -1))
-                        {
-                            int propIdx = lua_gettop(L);
-                            ScriptNetDatum newDatum;
+                    // Put a duplicate of the value on the stack so it will remain after setting the field.
+                    lua_pushvalue(L, -1);
 
-                            lua_getfield(L, propIdx, "name");
-                            const char* name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
-                            newDatum.mVarName = name;
-                            lua_pop(L, 1);
+                    lua_setfield(L, udIdx, name);
+                }
 
-                            lua_getfield(L, propIdx, "type");
-                            DatumType type = lua_isinteger(L, -1) ? (DatumType)lua_tointeger(L, -1) : DatumType::Count;
-                            newDatum.mType = type;
-                            lua_pop(L, 1);
+                bool push = true;
 
-                            lua_getfield(L, propIdx, "onRep");
-                            const char* onRep = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
-                            newDatum.mOnRepFuncName = onRep;
-                            lua_pop(L, 1);
+                switch (type)
+                {
+                case DatumType::Integer:
+                {
+                    int32_t value = CHECK_INTEGER(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::Float:
+                {
+                    float value = CHECK_NUMBER(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::Bool:
+                {
+                    bool value = CHECK_BOOLEAN(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::String:
+                {
+                    const char* value = CHECK_STRING(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::Vector2D:
+                {
+                    glm::vec2 value = CHECK_VECTOR(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::Vector:
+                {
+                    glm::vec3 value = CHECK_VECTOR(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::Color:
+                {
+                    glm::vec4 value = CHECK_VECTOR(L, -1);
+                    newDatum.PushBack(value);
+                    break;
+                }
+                case DatumType::Asset:
+                {
+                    Asset* asset = nullptr;
+                    if (!lua_isnil(L, -1))
+                    {
+                        asset = CHECK_ASSET(L, -1);
+                    }
+                    newDatum.PushBack(asset);
+                    break;
+                }
+                case DatumType::Byte:
+                {
+                    int32_t value = CHECK_INTEGER(L, -1);
+                    newDatum.PushBack((uint8_t)value);
+                    break;
+                }
 
-                            // TODO: Handle array data
-                            //lua_getfield(L, propIdx, "count");
-                            //int32_t count= lua_isinteger(L, -1) ? lua_tointeger(L, -1) : 1;
+                case DatumType::Table:
+                {
+                    push = false;
+                    LogError("Table replicated data is not supported.");
+                    break;
+                }
 
-                            newDatum.mOwner = this;
-                            newDatum.mExternal = false;
-                            newDatum.mChangeHandler = isServer ? nullptr : OnRepHandler;
+                case DatumType::Pointer:
+                {
+                    // Only actor pointers are supported right now.
+                    Node* nodePointer = CHECK_NODE(L, -1);
+                    newDatum.PushBack(nodePointer);
+                    break;
+                }
 
-                            // Setup initial value and push it onto the outProps vector.
-                            if (newDatum.mVarName != "" &&
-                                type != DatumType::Count)
-                            {
-                                lua_getfield(L, udIdx, name);
-
-                                if (lua_isnil(L, -1) &&
-                                    type != DatumType::Asset)
-                                {
-                                    // Pop nil
-                                    lua_pop(L, 1);
-
-                                    // Add a defaulted member to the table and leave the it on the stack
-                                    // so that we can initialize the Property correctly later.
-                                    switch (type)
-                                    {
-                                    case DatumType::Integer: lua_pushinteger(L, 0); break;
-                                    case DatumType::Float: lua_pushnumber(L, 0.0f); break;
-                                    case DatumType::Bool: lua_pushboolean(L, false); break;
-                                    case DatumType::String: lua_pushstring(L, ""); break;
-                                    case DatumType::Vector2D: Vector_Lua::Create(L, glm::vec2(0.0f, 0.0f)); break;
-                                    case DatumType::Vector: Vector_Lua::Create(L, glm::vec3(0.0f, 0.0f, 0.0f)); break;
-                                    case DatumType::Color: Vector_Lua::Create(L, glm::vec4(0.0f, 0.0f, 0.0f, 0.0f)); break;
-                                    case DatumType::Byte: lua_pushinteger(L, 0); break;
-                                    case DatumType::Short: lua_pushinteger(L, 0); break;
-
-                                    default:
-                                        lua_pushnil(L);
-                                        break;
-                                    }
-
-                                    // Put a duplicate of the value on the stack so it will remain after setting the field.
-                                    lua_pushvalue(L, -1);
-
-                                    lua_setfield(L, udIdx, name);
-                                }
-
-                                bool push = true;
-
-                                switch (type)
-                                {
-                                case DatumType::Integer:
-                                {
-                                    int32_t value = CHECK_INTEGER(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::Float:
-                                {
-                                    float value = CHECK_NUMBER(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::Bool:
-                                {
-                                    bool value = CHECK_BOOLEAN(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::String:
-                                {
-                                    const char* value = CHECK_STRING(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::Vector2D:
-                                {
-                                    glm::vec2 value = CHECK_VECTOR(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::Vector:
-                                {
-                                    glm::vec3 value = CHECK_VECTOR(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::Color:
-                                {
-                                    glm::vec4 value = CHECK_VECTOR(L, -1);
-                                    newDatum.PushBack(value);
-                                    break;
-                                }
-                                case DatumType::Asset:
-                                {
-                                    Asset* asset = nullptr;
-                                    if (!lua_isnil(L, -1))
-                                    {
-                                        asset = CHECK_ASSET(L, -1);
-                                    }
-                                    newDatum.PushBack(asset);
-                                    break;
-                                }
-                                case DatumType::Byte:
-                                {
-                                    int32_t value = CHECK_INTEGER(L, -1);
-                                    newDatum.PushBack((uint8_t)value);
-                                    break;
-                                }
-
-                                case DatumType::Table:
-                                {
-                                    push = false;
-                                    LogError("Table replicated data is not supported.");
-                                    break;
-                                }
-
-                                case DatumType::Pointer:
-                                {
-                                    // Only actor pointers are supported right now.
-                                    Node* nodePointer = CHECK_NODE(L, -1);
-                                    newDatum.PushBack(nodePointer);
-                                    break;
-                                }
-
-                                case DatumType::Short:
-                                {
-                                    int32_t value = CHECK_INTEGER(L, -1);
-                                    newDatum.PushBack((int16_t)value);
-                                    break;
-                                }
-
-                                case DatumType::Function:
-                                {
-                                    push = false;
-                                    LogError("Function replicated data is not supported.");
-                                    break;
-                                }
-
-                                case DatumType::Count:
-                                {
-                                    push = false;
-                                    OCT_ASSERT(0); // Unreachable
-                                    break;
-                                }
-                                }
-
-                                if (push)
-                                {
-                                    mReplicatedData.push_back(newDatum);
-                                }
-
-                                // Pop initial value
-                                lua_pop(L, 1);
-                            }
-                            else
-                            {
-                                LogWarning("Invalid script net datum found.");
-                            }
-                        }
+                case DatumType::Short:
+                {
+                    int32_t value = CHECK_INTEGER(L, -1);
+                    newDatum.PushBack((int16_t)value);
+                    break;
+                }
 
-                        // Pop property object
-                        lua_pop(L, 1);
-                    }
+                case DatumType::Function:
+                {
+                    push = false;
+                    LogError("Function replicated data is not supported.");
+                    break;
                 }
 
-                // Pop GatherReplicatedData() return value (hopefully a table or nil)
+                case DatumType::Count:
+                {
+                    push = false;
+                    OCT_ASSERT(0); // Unreachable
+                    break;
+                }
+                }
+
+                if (push)
+                {
+                    mReplicatedData.push_back(newDatum);
+                }
+
+                // Pop initial value
                 lua_pop(L, 1);
             }
-            else
+        }
+
+        // Pop userdata
+        lua_pop(L, 1);
+    }
+#endif
+}
+
+void Script::GatherReplicatedDataDefs(std::vector<ScriptNetDatum>& outDefs)
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+    lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+
+    if (lua_isuserdata(L, -1))
+    {
+        lua_getfield(L, -1, "GatherReplicatedData");
+
+        if (lua_isfunction(L, -1))
+        {
+            lua_pushvalue(L, -2);   // arg1 - self
+            LuaFuncCall(1, 1);
+
+            if (lua_istable(L, -1))
             {
-                // Pop non-function value
+                // GatherReplicatedData func should return an array
+                // of tables. Each table in the array contains the
+                // NetDatum name, data type, count
+                int arrayIdx = lua_gettop(L);
+
+                // Get number of properties.
+                lua_len(L, arrayIdx);
+                int32_t numProps = lua_tointeger(L, -1);
                 lua_pop(L, 1);
+
+                // Loop through each property
+                for (int32_t i = 1; i <= numProps; ++i)
+                {
+                    lua_geti(L, arrayIdx, i);
+
+                    if (lua_istable(L, -1))
+                    {
+                        int propIdx = lua_gettop(L);
+                        ScriptNetDatum newDatum;
+
+                        lua_getfield(L, propIdx, "name");
+                        const char* name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
+                        newDatum.mVarName = name;
+                        lua_pop(L, 1);
+
+                        lua_getfield(L, propIdx, "type");
+                        DatumType type = lua_isinteger(L, -1) ? (DatumType)lua_tointeger(L, -1) : DatumType::Count;
+                        newDatum.mType = type;
+                        lua_pop(L, 1);
+
+                        lua_getfield(L, propIdx, "onRep");
+                        const char* onRep = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
+                        newDatum.mOnRepFuncName = onRep;
+                        lua_pop(L, 1);
+
+                        // TODO: Handle array data
+                        //lua_getfield(L, propIdx, "count");
+                        //int32_t count= lua_isinteger(L, -1) ? lua_tointeger(L, -1) : 1;
+
+                        if (newDatum.mVarName != "" &&
+                            type != DatumType::Count)
+                        {
+                            outDefs.push_back(newDatum);
+                        }
+                        else
+                        {
+                            LogWarning("Invalid script net datum found.");
+                        }
+                    }
+
+                    // Pop property object
+                    lua_pop(L, 1);
+                }
             }
+
+            // Pop GatherReplicatedData() return value (hopefully a table or nil)
+            lua_pop(L, 1);
+        }
+        else
+        {
+            // Pop non-function value
+            lua_pop(L, 1);
+        }
+    }
+
+    // Pop userdata
+    lua_pop(L, 1);
+#endif
+}
+
+ScriptClassCache& Script::GetClassCache()
+{
+    return sClassCaches[mClassName];
+}
+
+const std::string& Script::FindClassName(const std::string& fileName)
+{
+    auto it = sFileClassNames.find(fileName);
+
+    if (it == sFileClassNames.end())
+    {
+        it = sFileClassNames.insert({ fileName, ScriptUtils::GetClassNameFromFileName(fileName) }).first;
+    }
+
+    return it->second;
+}
+
+void Script::ClearClassCache(const std::string& className)
+{
+    // Derived classes cache the properties and net funcs they inherit, so clear them too.
+    std::vector<std::string> clearNames;
+    clearNames.push_back(className);
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+    char classFlag[64];
+    snprintf(classFlag, 64, "cf%s", className.c_str());
+
+    auto gatherDerived = [&](const std::string& name)
+    {
+        if (name == className)
+            return;
+
+        lua_getglobal(L, name.c_str());
+
+        if (lua_istable(L, -1))
+        {
+            // Looks through the __index chain of parent classes.
+            if (lua_getfield(L, -1, classFlag) != LUA_TNIL)
+            {
+                clearNames.push_back(name);
+            }
+
+            lua_pop(L, 1);
         }
 
-        // Pop userdata
         lua_pop(L, 1);
+    };
+
+    for (auto& it : sClassCaches)
+    {
+        gatherDerived(it.first);
+    }
+
+    for (auto& it : sScriptNetFuncMap)
+    {
+        if (sClassCaches.find(it.first) == sClassCaches.end())
+        {
+            gatherDerived(it.first);
+        }
     }
 #endif
+
+    for (uint32_t i = 0; i < clearNames.size(); ++i)
+    {
+        sClassCaches.erase(clearNames[i]);
+        sScriptNetFuncMap.erase(clearNames[i]);
+    }
 }
 
 void Script::RegisterNetFuncs()
@@ -786,6 +977,14 @@ void Script::GatherNetFuncs(std::vector<ScriptNetFunc>& outFuncs)
 #endif
 }
 
+// Vectors can be modified in place (self.pos.x = 1) without assigning the field, so they can't be dirty tracked.
+static bool IsDirtyTracked(DatumType type)
+{
+    return type != DatumType::Vector2D &&
+        type != DatumType::Vector &&
+        type != DatumType::Color;
+}
+
 void Script::DownloadReplicatedData()
 {
 #if LUA_ENABLED
@@ -798,9 +997,20 @@ void Script::DownloadReplicatedData()
         OCT_ASSERT(lua_isuserdata(L, -1));
         int udIdx = lua_gettop(L);
 
+        // Only pull variables the script assigned since the last download. See OnFieldAssigned().
+        // Assignments made while this wasn't the server weren't tracked, so pull everything once.
+        bool downloadAll = mReplicatedDataStale;
+        mReplicatedDataStale = false;
+
         for (uint32_t i = 0; i < mReplicatedData.size(); ++i)
         {
-            DownloadDatum(L, mReplicatedData[i], udIdx, mReplicatedData[i].mVarName.c_str());
+            ScriptNetDatum& netDatum = mReplicatedData[i];
+
+            if (netDatum.mDirty || downloadAll)
+            {
+                DownloadDatum(L, netDatum, udIdx, netDatum.mVarName.c_str());
+                netDatum.mDirty = !IsDirtyTracked(netDatum.GetType());
+            }
         }
 
         // Pop script instance table
@@ -861,6 +1071,7 @@ void Script::ExecuteNetFunc(uint16_t index, uint32_t numParams, const Datum** pa
 
         if (netFunc != nullptr)
         {
+            ScopedScriptProfile scriptProfile(mClassName, false);
             lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
 
             if (lua_isuserdata(L, -1))
@@ -1138,22 +1349,63 @@ void Script::SetWorld(World* world)
 
 bool Script::ReloadScriptFile(const std::string& fileName, bool restartScript)
 {
+    // Class caches are cleared when the file is loaded. See ScriptUtils::LoadScriptFile().
     bool success = ScriptUtils::ReloadScriptFile(fileName);
 
-    std::string className = ScriptUtils::GetClassNameFromFileName(fileName);
-
-    auto it = sScriptNetFuncMap.find(className);
-    if (it != sScriptNetFuncMap.end())
+    if (success)
     {
-        sScriptNetFuncMap.erase(it);
+        OnClassReloaded(restartScript);
     }
 
-    if (success && restartScript)
+    return success;
+}
+
+void Script::OnClassReloaded(bool restartScript)
+{
+    if (restartScript)
     {
         RestartScript();
     }
+    else if (IsActive())
+    {
+        CacheCallbacks();
+        GatherScriptProperties();
 
-    return success;
+        // The reload cleared the class's rep defs and net funcs (and those of derived classes).
+        if (GetOwner()->IsReplicated())
+        {
+            GatherReplicatedData();
+            RegisterNetFuncs();
+        }
+    }
+}
+
+bool Script::InheritsFromClass(const std::string& className)
+{
+    bool inherits = false;
+
+#if LUA_ENABLED
+    if (IsActive())
+    {
+        if (className == mClassName)
+        {
+            inherits = true;
+        }
+        else
+        {
+            // Every loaded class table has a cf<ClassName> flag, which derived tables see through __index.
+            lua_State* L = GetLua();
+            std::string classFlag = "cf" + className;
+
+            lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+            lua_getfield(L, -1, classFlag.c_str());
+            inherits = !lua_isnil(L, -1);
+            lua_pop(L, 2);
+        }
+    }
+#endif
+
+    return inherits;
 }
 
 std::vector<ScriptNetDatum>& Script::GetReplicatedData()
@@ -1204,36 +1456,24 @@ bool Script::InvokeNetFunc(const char* name, uint32_t numParams, const Datum** p
 void Script::BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 {
 #if LUA_ENABLED
-    if (mHandleBeginOverlap && IsActive())
+    if (IsBatchingPhysicsEvents())
+    {
+        QueuePhysicsEvent(ScriptPhysicsEventType::BeginOverlap, thisNode, otherNode, {}, {});
+    }
+    else if (IsActive() && PushCallback(ScriptCallback::BeginOverlap))
     {
+        ScopedScriptProfile scriptProfile(mClassName, false);
         lua_State* L = GetLua();
 
-        // Grab the ud
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-
-        OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "BeginOverlap");
-
-        if (lua_isfunction(L, -1))
-        {
-            lua_pushvalue(L, udIdx);
-            Node_Lua::Create(L, thisNode);
-            Node_Lua::Create(L, otherNode);
-
-            // Instance table at -5
-            // Func at -4
-            // Instance table (as arg1) at -3
-            // thisComp (as arg2) at -2
-            // othercomp as (arg3) at -1
-            LuaFuncCall(3);
-        }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
-
-        lua_pop(L, 1); // pop instance table
+        Node_Lua::Create(L, thisNode);
+        Node_Lua::Create(L, otherNode);
+
+        // Func at -4
+        // Instance table (as arg1) at -3
+        // thisComp (as arg2) at -2
+        // othercomp as (arg3) at -1
+        LuaFuncCall(3);
     }
 #endif
 }
@@ -1241,35 +1481,24 @@ void Script::BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 void Script::EndOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 {
 #if LUA_ENABLED
-    if (mHandleEndOverlap && IsActive())
+    if (IsBatchingPhysicsEvents())
     {
-        lua_State* L = GetLua();
-
-        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-
-        OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "EndOverlap");
-
-        if (lua_isfunction(L, -1))
-        {
-            lua_pushvalue(L, udIdx);
-            Node_Lua::Create(L, thisNode);
-            Node_Lua::Create(L, otherNode);
-
-            // Instance table at -5
-            // Func at -4
-            // Instance table (as arg1) at -3
-            // thisNode (as arg2) at -2
-            // otherNode as (arg3) at -1
-            LuaFuncCall(3);
-        }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
+        QueuePhysicsEvent(ScriptPhysicsEventType::EndOverlap, thisNode, otherNode, {}, {});
+    }
+    else if (IsActive() && PushCallback(ScriptCallback::EndOverlap))
+    {
+        ScopedScriptProfile scriptProfile(mClassName, false);
+        lua_State* L = GetLua();
 
-        lua_pop(L, 1); // pop instance table
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+        Node_Lua::Create(L, thisNode);
+        Node_Lua::Create(L, otherNode);
+
+        // Func at -4
+        // Instance table (as arg1) at -3
+        // thisNode (as arg2) at -2
+        // otherNode as (arg3) at -1
+        LuaFuncCall(3);
     }
 #endif
 }
@@ -1282,34 +1511,84 @@ void Script::OnCollision(
     btPersistentManifold* manifold)
 {
 #if LUA_ENABLED
-    if (mHandleOnCollision && IsActive())
+    if (IsBatchingPhysicsEvents())
+    {
+        QueuePhysicsEvent(ScriptPhysicsEventType::Collision, thisNode, otherNode, impactPoint, impactNormal);
+    }
+    else if (IsActive() && PushCallback(ScriptCallback::OnCollision))
     {
+        ScopedScriptProfile scriptProfile(mClassName, false);
         lua_State* L = GetLua();
 
-        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-        OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "OnCollision");
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);        // arg1 - self
+        Node_Lua::Create(L, thisNode);                          // arg2 - thisNode
+        Node_Lua::Create(L, otherNode);                         // arg3 - otherNode
+        Vector_Lua::Create(L, glm::vec4(impactPoint, 0.0f));    // arg4 - impactPoint
+        Vector_Lua::Create(L, glm::vec4(impactNormal, 0.0f));   // arg5 - impactNormal
+        // TODO: Do we want to handle manifold points?
 
-        if (lua_isfunction(L, -1))
-        {
-            lua_pushvalue(L, udIdx);                                // arg1 - self
-            Node_Lua::Create(L, thisNode);                          // arg2 - thisNode
-            Node_Lua::Create(L, otherNode);                         // arg3 - otherNode
-            Vector_Lua::Create(L, glm::vec4(impactPoint, 0.0f));    // arg4 - impactPoint
-            Vector_Lua::Create(L, glm::vec4(impactNormal, 0.0f));   // arg5 - impactNormal
-            // TODO: Do we want to handle manifold points?
+        LuaFuncCall(5);
+    }
+#endif
+}
 
-            LuaFuncCall(5);
-        }
-        else
+void Script::DispatchPhysicsEvents()
+{
+    // A script can destroy nodes while handling its events, which can queue more events (EndOverlap).
+    // Those are picked up by the outer loop instead of re-entering.
+    if (sDispatchingPhysicsEvents)
+        return;
+
+    sDispatchingPhysicsEvents = true;
+
+    while (!sPhysicsEventScripts.empty())
+    {
+        // Scripts remove themselves from the list when destroyed, so always pop before delivering.
+        Script* script = sPhysicsEventScripts.back();
+        sPhysicsEventScripts.pop_back();
+        script->DeliverPhysicsEvents();
+    }
+
+    sDispatchingPhysicsEvents = false;
+}
+
+void Script::HandlePrimitiveDestroyed(Primitive3D* prim)
+{
+    if (!sDispatchingPhysicsEvents)
+    {
+        // Deliver now while the primitive is still alive (e.g. EndOverlaps from World::PurgeOverlaps()).
+        DispatchPhysicsEvents();
+        return;
+    }
+
+    for (int32_t s = int32_t(sPhysicsEventScripts.size()) - 1; s >= 0; --s)
+    {
+        std::vector<ScriptPhysicsEvent>& events = sPhysicsEventScripts[s]->mPhysicsEvents;
+
+        for (int32_t i = int32_t(events.size()) - 1; i >= 0; --i)
         {
-            lua_pop(L, 1); // pop nil function
+            if (events[i].mThisNode == prim ||
+                events[i].mOtherNode == prim)
+            {
+                events.erase(events.begin() + i);
+            }
         }
 
-        lua_pop(L, 1); // pop instance table
+        if (events.empty())
+        {
+            sPhysicsEventScripts.erase(sPhysicsEventScripts.begin() + s);
+        }
     }
-#endif
+}
+
+void Script::SetCollisionEventInterval(float interval)
+{
+    sCollisionEventInterval = glm::max(interval, 0.0f);
+}
+
+float Script::GetCollisionEventInterval()
+{
+    return sCollisionEventInterval;
 }
 
 bool Script::HasFunction(const char* name) const
@@ -1466,10 +1745,66 @@ void Script::CallFunction(const char* name, uint32_t numParams, const Datum** pa
 {
     if (IsActive())
     {
+        // Start, Stop, Create, Destroy and other named calls all come through here.
+        ScopedScriptProfile scriptProfile(mClassName, false);
         ScriptUtils::CallMethod(mUserdataRef, name, numParams, params, ret);
     }
 }
 
+lua_State* Script::BeginTypedCall(const char* name)
+{
+    lua_State* retL = nullptr;
+
+#if LUA_ENABLED
+    if (IsActive())
+    {
+        lua_State* L = GetLua();
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+        OCT_ASSERT(lua_isuserdata(L, -1));
+        lua_getfield(L, -1, name);
+
+        // Only call the function if it has been defined.
+        if (lua_isfunction(L, -1))
+        {
+            lua_pushvalue(L, -2);
+            retL = L;
+        }
+        else
+        {
+            lua_pop(L, 2);
+        }
+    }
+#endif
+
+    return retL;
+}
+
+bool Script::EndTypedCall(lua_State* L, int numArgs, int numResults)
+{
+    bool success = false;
+
+#if LUA_ENABLED
+    ScopedScriptProfile scriptProfile(mClassName, false);
+
+    // Always pass self
+    success = LuaFuncCall(numArgs + 1, numResults);
+
+    if (success)
+    {
+        // Remove the instance from under the results
+        lua_remove(L, -(numResults + 1));
+    }
+    else
+    {
+        // Pop the error message and the instance
+        lua_pop(L, 2);
+    }
+#endif
+
+    return success;
+}
+
 Datum Script::GetField(const char* key)
 {
     Datum ret;
@@ -1530,6 +1865,7 @@ bool Script::OnRepHandler(Datum* datum, uint32_t index, const void* newValue)
 
             netDatum->SetValueRaw(newValue);
 
+            ScopedScriptProfile scriptProfile(script->mClassName, false);
             script->LuaFuncCall(2, 0);
         }
         else
@@ -1562,7 +1898,7 @@ void Script::CreateScriptInstance()
         // Determine the class name the script should use
         // For instance, if the filename is Characters/Monster/Goblin.lua,
         // then the classname should be Goblin.
-        mClassName = ScriptUtils::GetClassNameFromFileName(mFileName);
+        mClassName = FindClassName(mFileName);
 
         classLoaded = ScriptUtils::IsScriptLoaded(mClassName);
         if (!classLoaded)
@@ -1589,46 +1925,57 @@ void Script::CreateScriptInstance()
             OCT_ASSERT(lua_istable(L, -1));
             int classTableIdx = lua_gettop(L);
 
-            if (lua_getmetatable(L, classTableIdx) == 0)
+            // The class table only needs to be checked/parented once per native node class.
+            std::vector<std::string>& nativeClasses = GetClassCache().mNativeClasses;
+
+            if (std::find(nativeClasses.begin(), nativeClasses.end(), mOwner->GetClassName()) == nativeClasses.end())
             {
-                LogDebug("Auto-parenting script Class table to native node's table.");
+                bool verified = true;
 
-                luaL_getmetatable(L, mOwner->GetClassName());
-                if (lua_isnil(L, -1))
+                if (lua_getmetatable(L, classTableIdx) == 0)
                 {
-                    LogError("Bad native metatable in CreateScriptInstance().");
-                    lua_pop(L, 1);
-                    luaL_getmetatable(L, NODE_LUA_NAME);
-                }
+                    LogDebug("Auto-parenting script Class table to native node's table.");
 
-                lua_setmetatable(L, classTableIdx); // Pops native metatable
-            }
-            else
-            {
-                // Ensure that the script class derives from the native node.
-                char classFlag[64];
-                snprintf(classFlag, 64, "cf%s", mOwner->GetClassName());
-                lua_getfield(L, classTableIdx, classFlag);
+                    luaL_getmetatable(L, mOwner->GetClassName());
+                    if (lua_isnil(L, -1))
+                    {
+                        LogError("Bad native metatable in CreateScriptInstance().");
+                        lua_pop(L, 1);
+                        luaL_getmetatable(L, NODE_LUA_NAME);
+                    }
 
-                bool hasFlag = !lua_isnil(L, -1);
-                
-                if (!hasFlag)
+                    lua_setmetatable(L, classTableIdx); // Pops native metatable
+                }
+                else
                 {
-                    LogError("Bad inheritance chain! Make sure the script class table inherits (eventually) from the native node it is being used on.");
-                    OCT_ASSERT(0);
+                    // Ensure that the script class derives from the native node.
+                    char classFlag[64];
+                    snprintf(classFlag, 64, "cf%s", mOwner->GetClassName());
+                    lua_getfield(L, classTableIdx, classFlag);
+
+                    bool hasFlag = !lua_isnil(L, -1);
+                
+                    if (!hasFlag)
+                    {
+                        LogError("Bad inheritance chain! Make sure the script class table inherits (eventually) from the native node it is being used on.");
+                        OCT_ASSERT(0);
+                        verified = false;
+                    }
+
+                    lua_pop(L, 2); // Pop class flag + metatable
                 }
 
-                lua_pop(L, 2); // Pop class flag + metatable
+                if (verified)
+                {
+                    nativeClasses.push_back(mOwner->GetClassName());
+                }
             }
 
             // Assign the new script class table to the Node Uservalue's class key
             OCT_ASSERT(lua_gettop(L) == classTableIdx);
             lua_setfield(L, uvIdx, OCT_CLASS_TABLE_KEY); // Pops script class metatable
 
-            mTickEnabled = CheckIfFunctionExists("Tick");
-            mHandleBeginOverlap = CheckIfFunctionExists("BeginOverlap");
-            mHandleEndOverlap = CheckIfFunctionExists("EndOverlap");
-            mHandleOnCollision = CheckIfFunctionExists("OnCollision");
+            CacheCallbacks();
 
             SetWorld(mOwner->GetWorld());
 
@@ -1699,10 +2046,8 @@ void Script::DestroyScriptInstance()
         mReplicatedData.clear();
     }
 
-    mTickEnabled = false;
-    mHandleBeginOverlap = false;
-    mHandleEndOverlap = false;
-    mHandleOnCollision = false;
+    ClearPhysicsEvents();
+    ReleaseCallbacks();
 #endif
 }
 
@@ -1718,75 +2063,335 @@ void Script::CallTick(float deltaTime)
 #if LUA_ENABLED
 
 #if EDITOR
-    if (IsActive())
+    ScriptCallback tickCallback = IsGameTickEnabled() ? ScriptCallback::Tick : ScriptCallback::EditorTick;
+#else
+    ScriptCallback tickCallback = ScriptCallback::Tick;
+#endif
+
+    if (IsActive() && PushCallback(tickCallback))
+    {
+        ScopedScriptProfile scriptProfile(mClassName, true);
+        lua_State* L = GetLua();
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+        lua_pushnumber(L, deltaTime);
+
+        // Func at -3
+        // Instance table (as arg0) at -2
+        // deltaTime as (arg1) at -1
+        LuaFuncCall(2);
+    }
+
+#endif // LUA_ENABLED
+
+}
+
+void Script::OnFieldAssigned(const char* name)
+{
+    RefreshCallback(name);
+
+    if (mReplicatedData.empty())
+        return;
+
+    // Only the server downloads replicated data. If this becomes the server later,
+    // the next download pulls every variable.
+    if (!NetIsServer())
     {
-        if (IsGameTickEnabled())
+        mReplicatedDataStale = true;
+        return;
+    }
+
+    if (mRepIndices != nullptr)
+    {
+        auto it = mRepIndices->find(name);
+
+        if (it != mRepIndices->end() &&
+            it->second < mReplicatedData.size())
         {
-            CallFunction("Tick", deltaTime);
+            mReplicatedData[it->second].mDirty = true;
         }
-        else
+    }
+}
+
+void Script::RefreshCallback(const char* name)
+{
+    static std::unordered_map<std::string, ScriptCallback> sCallbackMap;
+
+    if (sCallbackMap.empty())
+    {
+        for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
         {
-            CallFunction("EditorTick", deltaTime);
+            sCallbackMap.insert({ sCallbackNames[i], ScriptCallback(i) });
         }
     }
-#else
-    if (IsActive() && mTickEnabled)
+
+    auto it = sCallbackMap.find(name);
+
+    if (it != sCallbackMap.end())
     {
-        lua_State* L = GetLua();
+        CacheCallback(it->second);
+    }
+}
+
+void Script::CacheCallback(ScriptCallback callback)
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+    int& ref = mCallbackRefs[uint32_t(callback)];
+
+    if (ref != LUA_REFNIL)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, ref);
+        ref = LUA_REFNIL;
+    }
 
+    if (IsActive())
+    {
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
         OCT_ASSERT(lua_isuserdata(L, -1));
 
-        lua_getfield(L, -1, "Tick");
+        lua_getfield(L, -1, sCallbackNames[uint32_t(callback)]);
 
         if (lua_isfunction(L, -1))
         {
-            lua_pushvalue(L, -2);
-            lua_pushnumber(L, deltaTime);
-
-            // Instance table at -4
-            // Func at -3
-            // Instance table (as arg0) at -2
-            // deltaTime as (arg1) at -1
-            LuaFuncCall(2);
+            // Pops the function
+            ref = luaL_ref(L, LUA_REGISTRYINDEX);
         }
         else
         {
             lua_pop(L, 1);
         }
 
+        // Pop userdata
         lua_pop(L, 1);
     }
-#endif // EDITOR
+#endif
+}
 
-#endif // LUA_ENABLED
+void Script::CacheCallbacks()
+{
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        CacheCallback(ScriptCallback(i));
+    }
+}
+
+void Script::ReleaseCallbacks()
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        if (L != nullptr && mCallbackRefs[i] != LUA_REFNIL)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, mCallbackRefs[i]);
+        }
 
+        mCallbackRefs[i] = LUA_REFNIL;
+    }
+#endif
 }
 
-bool Script::CheckIfFunctionExists(const char* funcName)
+bool Script::PushCallback(ScriptCallback callback)
 {
-    bool exists = false;
+    bool pushed = false;
 
 #if LUA_ENABLED
-    if (IsActive())
+    int ref = mCallbackRefs[uint32_t(callback)];
+
+    if (ref != LUA_REFNIL)
+    {
+        lua_rawgeti(GetLua(), LUA_REGISTRYINDEX, ref);
+        pushed = true;
+    }
+#endif
+
+    return pushed;
+}
+
+bool Script::IsBatchingPhysicsEvents() const
+{
+    return mCallbackRefs[uint32_t(ScriptCallback::OnPhysicsEvents)] != LUA_REFNIL;
+}
+
+void Script::QueuePhysicsEvent(
+    ScriptPhysicsEventType type,
+    Primitive3D* thisNode,
+    Primitive3D* otherNode,
+    glm::vec3 impactPoint,
+    glm::vec3 impactNormal)
+{
+    float time = GetEngineState()->mGameElapsedTime;
+
+    if (mPhysicsEvents.empty())
+    {
+        // First event this frame. Forget pairs whose interval has passed so the map doesn't grow forever.
+        for (auto it = mCollisionEventTimes.begin(); it != mCollisionEventTimes.end();)
+        {
+            if (time - it->second >= sCollisionEventInterval)
+            {
+                it = mCollisionEventTimes.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Overlaps are never throttled since scripts usually track begin/end state.
+    if (type == ScriptPhysicsEventType::Collision &&
+        sCollisionEventInterval > 0.0f)
+    {
+        ScriptPrimitivePair pair = { thisNode, otherNode };
+        auto it = mCollisionEventTimes.find(pair);
+
+        if (it != mCollisionEventTimes.end() &&
+            time - it->second < sCollisionEventInterval)
+        {
+            return;
+        }
+
+        mCollisionEventTimes[pair] = time;
+    }
+
+    if (mPhysicsEvents.empty())
+    {
+        sPhysicsEventScripts.push_back(this);
+    }
+
+    ScriptPhysicsEvent event;
+    event.mThisNode = thisNode;
+    event.mOtherNode = otherNode;
+    event.mImpactPoint = impactPoint;
+    event.mImpactNormal = impactNormal;
+    event.mType = type;
+    mPhysicsEvents.push_back(event);
+}
+
+void Script::DeliverPhysicsEvents()
+{
+#if LUA_ENABLED
+    if (mPhysicsEvents.empty())
+        return;
+
+    if (IsActive() && PushCallback(ScriptCallback::OnPhysicsEvents))
     {
+        ScopedScriptProfile scriptProfile(mClassName, false);
         lua_State* L = GetLua();
 
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-        OCT_ASSERT(lua_isuserdata(L, -1));
 
-        lua_getfield(L, -1, funcName);
+        // The events table and the event tables/vectors inside it are reused every frame.
+        // Entries past count are stale and should be ignored.
+        if (mPhysicsEventsRef == LUA_REFNIL)
+        {
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            mPhysicsEventsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        }
+        else
+        {
+            lua_rawgeti(L, LUA_REGISTRYINDEX, mPhysicsEventsRef);
+        }
+
+        int eventsIdx = lua_gettop(L);
+        uint32_t numEvents = uint32_t(mPhysicsEvents.size());
 
-        if (lua_isfunction(L, -1))
+        for (uint32_t i = 0; i < numEvents; ++i)
         {
-            exists = true;
+            const ScriptPhysicsEvent& event = mPhysicsEvents[i];
+
+            lua_rawgeti(L, eventsIdx, i + 1);
+            if (!lua_istable(L, -1))
+            {
+                lua_pop(L, 1);
+                lua_newtable(L);
+                lua_pushvalue(L, -1);
+                lua_rawseti(L, eventsIdx, i + 1);
+            }
+
+            int eventIdx = lua_gettop(L);
+
+            lua_pushstring(L, sPhysicsEventTypeNames[uint32_t(event.mType)]);
+            lua_setfield(L, eventIdx, "type");
+
+            Node_Lua::Create(L, event.mThisNode);
+            lua_setfield(L, eventIdx, "thisNode");
+
+            Node_Lua::Create(L, event.mOtherNode);
+            lua_setfield(L, eventIdx, "otherNode");
+
+            if (event.mType == ScriptPhysicsEventType::Collision)
+            {
+                const char* vecFields[2] = { "impactPoint", "impactNormal" };
+                glm::vec3 vecValues[2] = { event.mImpactPoint, event.mImpactNormal };
+
+                for (uint32_t v = 0; v < 2; ++v)
+                {
+                    lua_getfield(L, eventIdx, vecFields[v]);
+                    Vector_Lua* vecLua = (Vector_Lua*)luaL_testudata(L, -1, VECTOR_LUA_NAME);
+
+                    if (vecLua != nullptr)
+                    {
+                        vecLua->mVector = glm::vec4(vecValues[v], 0.0f);
+                        lua_pop(L, 1);
+                    }
+                    else
+                    {
+                        lua_pop(L, 1);
+                        Vector_Lua::Create(L, glm::vec4(vecValues[v], 0.0f));
+                        lua_setfield(L, eventIdx, vecFields[v]);
+                    }
+                }
+            }
+
+            lua_pop(L, 1); // Pop event table
         }
 
-        lua_pop(L, 2);
+        lua_pushinteger(L, numEvents);
+
+        // Clear before calling in case the script causes more events to be queued.
+        mPhysicsEvents.clear();
+
+        // Func at -4
+        // Instance table (as arg1) at -3
+        // events (as arg2) at -2
+        // count (as arg3) at -1
+        LuaFuncCall(3);
+    }
+    else
+    {
+        mPhysicsEvents.clear();
     }
 #endif
-
-    return exists;
 }
 
+void Script::ClearPhysicsEvents()
+{
+    if (!mPhysicsEvents.empty())
+    {
+        auto it = std::find(sPhysicsEventScripts.begin(), sPhysicsEventScripts.end(), this);
+
+        if (it != sPhysicsEventScripts.end())
+        {
+            sPhysicsEventScripts.erase(it);
+        }
+
+        mPhysicsEvents.clear();
+    }
+
+    mCollisionEventTimes.clear();
 
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (L != nullptr && mPhysicsEventsRef != LUA_REFNIL)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, mPhysicsEventsRef);
+    }
+
+    mPhysicsEventsRef = LUA_REFNIL;
+#endif
+}
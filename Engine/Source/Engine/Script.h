@@ -3,11 +3,13 @@
 #include "Nodes/Node.h"
 #include "ObjectRef.h"
 #include "ScriptFunc.h"
+#include "ScriptCall.h"
 #include "NetFunc.h"
 
 #include "NetworkManager.h"
 
 #include <set>
+#include <memory>
 #include <unordered_map>
 
 struct AnimEvent;
@@ -17,6 +19,72 @@ class TextField;
 struct Node_Lua;
 
 typedef std::unordered_map<std::string, ScriptNetFunc> ScriptNetFuncMap;
+typedef std::unordered_map<std::string, uint32_t> ScriptRepIndexMap;
+
+// Parsed once per script class and shared by every instance until the class is reloaded.
+// Property and net datum defs hold the name/type/flags but no values.
+struct ScriptClassCache
+{
+    std::vector<Property> mPropDefs;
+    std::vector<ScriptNetDatum> mRepDefs;
+    std::vector<std::string> mNativeClasses; // Native node classes the class table was verified against
+    std::shared_ptr<const ScriptRepIndexMap> mRepIndices; // Var name -> index into an instance's replicated data
+    bool mPropDefsGathered = false;
+    bool mRepDefsGathered = false;
+};
+
+// Engine callbacks whose Lua functions are resolved once per script instance and kept in the registry.
+enum class ScriptCallback : uint8_t
+{
+    Tick,
+    EditorTick,
+    BeginOverlap,
+    EndOverlap,
+    OnCollision,
+    OnPhysicsEvents,
+
+    Count
+};
+
+enum class ScriptPhysicsEventType : uint8_t
+{
+    BeginOverlap,
+    EndOverlap,
+    Collision,
+
+    Count
+};
+
+// Collision/overlap event queued for scripts that handle them in a batch with OnPhysicsEvents().
+struct ScriptPhysicsEvent
+{
+    Primitive3D* mThisNode = nullptr;
+    Primitive3D* mOtherNode = nullptr;
+    glm::vec3 mImpactPoint = {};
+    glm::vec3 mImpactNormal = {};
+    ScriptPhysicsEventType mType = ScriptPhysicsEventType::Collision;
+};
+
+struct ScriptPrimitivePair
+{
+    Primitive3D* mThisNode = nullptr;
+    Primitive3D* mOtherNode = nullptr;
+
+    bool operator==(const ScriptPrimitivePair& other) const
+    {
+        return mThisNode == other.mThisNode && mOtherNode == other.mOtherNode;
+    }
+};
+
+struct ScriptPrimitivePairHash
+{
+    size_t operator()(const ScriptPrimitivePair& pair) const
+    {
+        size_t hashA = std::hash<Primitive3D*>()(pair.mThisNode);
+        size_t hashB = std::hash<Primitive3D*>()(pair.mOtherNode);
+        return hashA ^ (hashB + 0x9e3779b9 + (hashA << 6) + (hashA >> 2));
+    }
+};
 
 class Script
 {
@@ -45,6 +113,11 @@ public:
 
     bool ReloadScriptFile(const std::string& fileName, bool restartScript = true);
 
+    // Called on instances after their class (or a parent class) was reloaded in place.
+    // Unless restarted, the instance keeps its fields and only picks up the new functions/properties.
+    void OnClassReloaded(bool restartScript);
+    bool InheritsFromClass(const std::string& className);
+
     std::vector<ScriptNetDatum>& GetReplicatedData();
 
     bool InvokeNetFunc(const char* name, uint32_t numParams, const Datum** params);
@@ -61,8 +134,20 @@ public:
         glm::vec3 impactNormal,
         btPersistentManifold* manifold);
 
+    // Scripts that define OnPhysicsEvents(self, events, count) receive their collision and overlap
+    // events in one call per frame instead of one call per contact. Called by the World after collisions are processed.
+    static void DispatchPhysicsEvents();
+    static void HandlePrimitiveDestroyed(Primitive3D* prim);
+
+    // Minimum game time between batched collision events for the same pair of nodes. 0 sends one every frame.
+    static void SetCollisionEventInterval(float interval);
+    static float GetCollisionEventInterval();
+
     bool HasFunction(const char* name) const;
 
+    // Called when a field is assigned on the instance. Refreshes cached callbacks and replicated data dirty flags.
+    void OnFieldAssigned(const char* name);
+
     void CallFunction(const char* name);
     void CallFunction(const char* name, const Datum& param0);
     void CallFunction(const char* name, const Datum& param0, const Datum& param1);
@@ -83,6 +168,40 @@ public:
     Datum CallFunctionR(const char* name, const Datum& param0, const Datum& param1, const Datum& param2, const Datum& param3, const Datum& param4, const Datum& param5, const Datum& param6, const Datum& param7);
     void CallFunction(const char* name, uint32_t numParams, const Datum** params, Datum* ret);
 
+    // Typed versions of CallFunction()/CallFunctionR(). Args are pushed straight onto the Lua stack
+    // and the return value is read as Ret, so no Datums are built. Prefer these for frequent calls.
+    template<typename... Args>
+    void CallTyped(const char* name, const Args&... args)
+    {
+#if LUA_ENABLED
+        lua_State* L = BeginTypedCall(name);
+        if (L != nullptr)
+        {
+            LuaPushValues(L, args...);
+            EndTypedCall(L, int(sizeof...(Args)), 0);
+        }
+#endif
+    }
+
+    template<typename Ret, typename... Args>
+    Ret CallTypedR(const char* name, const Args&... args)
+    {
+        Ret ret = Ret();
+#if LUA_ENABLED
+        lua_State* L = BeginTypedCall(name);
+        if (L != nullptr)
+        {
+            LuaPushValues(L, args...);
+            if (EndTypedCall(L, int(sizeof...(Args)), 1))
+            {
+                ret = LuaToValue<Ret>(L, -1);
+                lua_pop(L, 1);
+            }
+        }
+#endif
+        return ret;
+    }
+
     bool LuaFuncCall(int numArgs, int numResults = 0);
 
     Datum GetField(const char* key);
@@ -95,6 +214,9 @@ public:
 
     static bool OnRepHandler(Datum* datum, uint32_t index, const void* newValue);
 
+    // Must be called whenever a script class is (re)loaded so new instances re-gather their defs.
+    static void ClearClassCache(const std::string& className);
+
 protected:
 
     static bool HandleScriptPropChange(Datum* datum, uint32_t index, const void* newValue);
@@ -104,19 +226,47 @@ protected:
     void DestroyScriptInstance();
 
     void GatherScriptProperties();
+    void GatherScriptPropertyDefs(std::vector<Property>& outDefs);
     void GatherReplicatedData();
+    void GatherReplicatedDataDefs(std::vector<ScriptNetDatum>& outDefs);
+    ScriptClassCache& GetClassCache();
+    static const std::string& FindClassName(const std::string& fileName);
     void RegisterNetFuncs();
     void GatherNetFuncs(std::vector<ScriptNetFunc>& outFuncs);
     void DownloadReplicatedData();
 
     bool DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* varName);
+
+    // Pushes the instance, the method and self. Returns nullptr (with nothing pushed) if the method isn't defined.
+    lua_State* BeginTypedCall(const char* name);
+    // Leaves numResults values on the stack only if the call succeeded.
+    bool EndTypedCall(lua_State* L, int numArgs, int numResults);
     void UploadDatum(Datum& datum, const char* varName);
 
     void CallTick(float deltaTime);
 
-    bool CheckIfFunctionExists(const char* funcName);
+    void RefreshCallback(const char* name);
+    void CacheCallback(ScriptCallback callback);
+    void CacheCallbacks();
+    void ReleaseCallbacks();
+    bool PushCallback(ScriptCallback callback);
+
+    bool IsBatchingPhysicsEvents() const;
+    void QueuePhysicsEvent(
+        ScriptPhysicsEventType type,
+        Primitive3D* thisNode,
+        Primitive3D* otherNode,
+        glm::vec3 impactPoint,
+        glm::vec3 impactNormal);
+    void DeliverPhysicsEvents();
+    void ClearPhysicsEvents();
 
     static std::unordered_map<std::string, ScriptNetFuncMap> sScriptNetFuncMap;
+    static std::unordered_map<std::string, ScriptClassCache> sClassCaches;
+    static std::unordered_map<std::string, std::string> sFileClassNames;
+    static std::vector<Script*> sPhysicsEventScripts;
+    static float sCollisionEventInterval;
+    static bool sDispatchingPhysicsEvents;
 
     Node* mOwner = nullptr;
     int mUserdataRef = LUA_REFNIL;
@@ -124,9 +274,11 @@ protected:
     std::string mClassName;
     std::vector<Property> mScriptProps;
     std::vector<ScriptNetDatum> mReplicatedData;
-    bool mTickEnabled = false;
-    bool mHandleBeginOverlap = false;
-    bool mHandleEndOverlap = false;
-    bool mHandleOnCollision = false;
+    std::shared_ptr<const ScriptRepIndexMap> mRepIndices;
+    bool mReplicatedDataStale = false;
+    int mCallbackRefs[uint32_t(ScriptCallback::Count)];
+    int mPhysicsEventsRef = LUA_REFNIL;
+    std::vector<ScriptPhysicsEvent> mPhysicsEvents;
+    std::unordered_map<ScriptPrimitivePair, float, ScriptPrimitivePairHash> mCollisionEventTimes;
 };
 
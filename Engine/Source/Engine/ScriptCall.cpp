@@ -0,0 +1,190 @@
+#include "ScriptCall.h"
+#include "ScriptFunc.h"
+#include "Datum.h"
+#include "Utilities.h"
+#include "Asset.h"
+#include "Nodes/Node.h"
+
+#include "LuaBindings/Node_Lua.h"
+#include "LuaBindings/Asset_Lua.h"
+#include "LuaBindings/Vector_Lua.h"
+#include "LuaBindings/LuaTypeCheck.h"
+
+#if LUA_ENABLED
+
+void LuaPushValue(lua_State* L, bool value)
+{
+    lua_pushboolean(L, value);
+}
+
+void LuaPushValue(lua_State* L, int32_t value)
+{
+    lua_pushinteger(L, value);
+}
+
+void LuaPushValue(lua_State* L, uint32_t value)
+{
+    lua_pushinteger(L, value);
+}
+
+void LuaPushValue(lua_State* L, float value)
+{
+    lua_pushnumber(L, value);
+}
+
+void LuaPushValue(lua_State* L, double value)
+{
+    lua_pushnumber(L, value);
+}
+
+void LuaPushValue(lua_State* L, const char* value)
+{
+    lua_pushstring(L, value);
+}
+
+void LuaPushValue(lua_State* L, const std::string& value)
+{
+    lua_pushlstring(L, value.c_str(), value.size());
+}
+
+void LuaPushValue(lua_State* L, glm::vec2 value)
+{
+    Vector_Lua::Create(L, value);
+}
+
+void LuaPushValue(lua_State* L, glm::vec3 value)
+{
+    Vector_Lua::Create(L, value);
+}
+
+void LuaPushValue(lua_State* L, glm::vec4 value)
+{
+    Vector_Lua::Create(L, value);
+}
+
+void LuaPushValue(lua_State* L, const Node* value)
+{
+    if (value != nullptr)
+    {
+        Node_Lua::Create(L, const_cast<Node*>(value));
+    }
+    else
+    {
+        lua_pushnil(L);
+    }
+}
+
+void LuaPushValue(lua_State* L, const Asset* value)
+{
+    Asset_Lua::Create(L, value);
+}
+
+void LuaPushValue(lua_State* L, const ScriptFunc& value)
+{
+    value.Push(L);
+}
+
+void LuaPushValue(lua_State* L, const Datum& value)
+{
+    LuaPushDatum(L, value);
+}
+
+void LuaPushValue(lua_State* L, std::nullptr_t value)
+{
+    lua_pushnil(L);
+}
+
+template<>
+bool LuaToValue<bool>(lua_State* L, int idx)
+{
+    return lua_toboolean(L, idx);
+}
+
+template<>
+int32_t LuaToValue<int32_t>(lua_State* L, int idx)
+{
+    return (int32_t)lua_tointeger(L, idx);
+}
+
+template<>
+uint32_t LuaToValue<uint32_t>(lua_State* L, int idx)
+{
+    return (uint32_t)lua_tointeger(L, idx);
+}
+
+template<>
+float LuaToValue<float>(lua_State* L, int idx)
+{
+    return (float)lua_tonumber(L, idx);
+}
+
+template<>
+double LuaToValue<double>(lua_State* L, int idx)
+{
+    return (double)lua_tonumber(L, idx);
+}
+
+template<>
+std::string LuaToValue<std::string>(lua_State* L, int idx)
+{
+    size_t len = 0;
+    const char* str = lua_tolstring(L, idx, &len);
+    return (str != nullptr) ? std::string(str, len) : std::string();
+}
+
+template<>
+glm::vec4 LuaToValue<glm::vec4>(lua_State* L, int idx)
+{
+    Vector_Lua* vect = (Vector_Lua*)luaL_testudata(L, idx, VECTOR_LUA_NAME);
+    return (vect != nullptr) ? vect->mVector : glm::vec4(0.0f);
+}
+
+template<>
+glm::vec3 LuaToValue<glm::vec3>(lua_State* L, int idx)
+{
+    return glm::vec3(LuaToValue<glm::vec4>(L, idx));
+}
+
+template<>
+glm::vec2 LuaToValue<glm::vec2>(lua_State* L, int idx)
+{
+    return glm::vec2(LuaToValue<glm::vec4>(L, idx));
+}
+
+template<>
+Node* LuaToValue<Node*>(lua_State* L, int idx)
+{
+    Node_Lua* nodeLua = (Node_Lua*)luaL_testudata(L, idx, NODE_WRAPPER_TABLE_NAME);
+    Node* node = nullptr;
+
+    if (nodeLua != nullptr)
+    {
+        node = nodeLua->mNode;
+    }
+
+    return node;
+}
+
+template<>
+Asset* LuaToValue<Asset*>(lua_State* L, int idx)
+{
+    Asset* asset = nullptr;
+
+    if (CheckClassFlag(L, idx, ASSET_LUA_FLAG))
+    {
+        Asset_Lua* assetLua = (Asset_Lua*)lua_touserdata(L, idx);
+        asset = assetLua->mAsset.Get();
+    }
+
+    return asset;
+}
+
+template<>
+Datum LuaToValue<Datum>(lua_State* L, int idx)
+{
+    Datum ret;
+    LuaObjectToDatum(L, idx, ret);
+    return ret;
+}
+
+#endif
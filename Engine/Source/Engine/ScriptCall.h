@@ -0,0 +1,64 @@
+#pragma once
+
+#include "EngineTypes.h"
+#include "Maths.h"
+
+#include <string>
+
+class Node;
+class Asset;
+class Datum;
+class ScriptFunc;
+
+#if LUA_ENABLED
+
+// Typed counterparts to LuaPushDatum() and LuaObjectToDatum(). Native values are pushed directly
+// onto the Lua stack, without building a Datum or switching on its type, for the typed call paths
+// in Script and ScriptFunc.
+void LuaPushValue(lua_State* L, bool value);
+void LuaPushValue(lua_State* L, int32_t value);
+void LuaPushValue(lua_State* L, uint32_t value);
+void LuaPushValue(lua_State* L, float value);
+void LuaPushValue(lua_State* L, double value);
+void LuaPushValue(lua_State* L, const char* value);
+void LuaPushValue(lua_State* L, const std::string& value);
+void LuaPushValue(lua_State* L, glm::vec2 value);
+void LuaPushValue(lua_State* L, glm::vec3 value);
+void LuaPushValue(lua_State* L, glm::vec4 value);
+void LuaPushValue(lua_State* L, const Node* value);
+void LuaPushValue(lua_State* L, const Asset* value);
+void LuaPushValue(lua_State* L, const ScriptFunc& value);
+void LuaPushValue(lua_State* L, const Datum& value);
+void LuaPushValue(lua_State* L, std::nullptr_t value);
+
+inline void LuaPushValues(lua_State* L)
+{
+
+}
+
+template<typename T, typename... Args>
+void LuaPushValues(lua_State* L, const T& value, const Args&... args)
+{
+    LuaPushValue(L, value);
+    LuaPushValues(L, args...);
+}
+
+// Values of the wrong type read as a default value rather than raising a Lua error,
+// since these are read outside of a protected call.
+template<typename T>
+T LuaToValue(lua_State* L, int idx);
+
+template<> bool LuaToValue<bool>(lua_State* L, int idx);
+template<> int32_t LuaToValue<int32_t>(lua_State* L, int idx);
+template<> uint32_t LuaToValue<uint32_t>(lua_State* L, int idx);
+template<> float LuaToValue<float>(lua_State* L, int idx);
+template<> double LuaToValue<double>(lua_State* L, int idx);
+template<> std::string LuaToValue<std::string>(lua_State* L, int idx);
+template<> glm::vec2 LuaToValue<glm::vec2>(lua_State* L, int idx);
+template<> glm::vec3 LuaToValue<glm::vec3>(lua_State* L, int idx);
+template<> glm::vec4 LuaToValue<glm::vec4>(lua_State* L, int idx);
+template<> Node* LuaToValue<Node*>(lua_State* L, int idx);
+template<> Asset* LuaToValue<Asset*>(lua_State* L, int idx);
+template<> Datum LuaToValue<Datum>(lua_State* L, int idx);
+
+#endif
@@ -131,6 +131,39 @@ Datum ScriptFunc::CallR(uint32_t numParams, Datum* params) const
     return retDatum;
 }
 
+lua_State* ScriptFunc::BeginTypedCall() const
+{
+    lua_State* L = GetLua();
+
+    if (L == nullptr ||
+        mRef == LUA_REFNIL)
+    {
+        return nullptr;
+    }
+
+    lua_getfield(L, LUA_REGISTRYINDEX, REF_TABLE_NAME);
+    OCT_ASSERT(lua_istable(L, -1));
+
+    // Push the function and remove the ref table from under it.
+    lua_geti(L, -1, mRef);
+    lua_remove(L, -2);
+
+    return L;
+}
+
+bool ScriptFunc::EndTypedCall(lua_State* L, int numArgs, int numResults) const
+{
+    bool success = ScriptUtils::CallLuaFunc(numArgs, numResults);
+
+    if (!success)
+    {
+        // Pop the error message
+        lua_pop(L, 1);
+    }
+
+    return success;
+}
+
 void ScriptFunc::Push(lua_State* L) const
 {
     // It's very important that this function pushes ONLY the function,
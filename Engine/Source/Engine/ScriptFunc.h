@@ -2,6 +2,7 @@
 
 #include "EngineTypes.h"
 #include "Datum.h"
+#include "ScriptCall.h"
 
 class ScriptComponent;
 
@@ -22,6 +23,39 @@ public:
     void Call(uint32_t numParams = 0, Datum* params = nullptr) const;
     Datum CallR(uint32_t numParams = 0, Datum* params = nullptr) const;
 
+    // Typed versions of Call()/CallR() that push args directly instead of building Datums.
+    template<typename... Args>
+    void CallTyped(const Args&... args) const
+    {
+#if LUA_ENABLED
+        lua_State* L = BeginTypedCall();
+        if (L != nullptr)
+        {
+            LuaPushValues(L, args...);
+            EndTypedCall(L, int(sizeof...(Args)), 0);
+        }
+#endif
+    }
+
+    template<typename Ret, typename... Args>
+    Ret CallTypedR(const Args&... args) const
+    {
+        Ret ret = Ret();
+#if LUA_ENABLED
+        lua_State* L = BeginTypedCall();
+        if (L != nullptr)
+        {
+            LuaPushValues(L, args...);
+            if (EndTypedCall(L, int(sizeof...(Args)), 1))
+            {
+                ret = LuaToValue<Ret>(L, -1);
+                lua_pop(L, 1);
+            }
+        }
+#endif
+        return ret;
+    }
+
     void Push(lua_State* L) const;
 
     bool IsValid() const;
@@ -34,6 +68,9 @@ protected:
     void UnregisterRef();
     void CopyRef(int ref);
 
+    lua_State* BeginTypedCall() const;
+    bool EndTypedCall(lua_State* L, int numArgs, int numResults) const;
+
     int mRef = LUA_REFNIL;
 };
 
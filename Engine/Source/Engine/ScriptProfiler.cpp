@@ -0,0 +1,244 @@
+#include "ScriptProfiler.h"
+#include "Engine.h"
+#include "Maths.h"
+#include "Log.h"
+
+#include "System/System.h"
+
+#include <algorithm>
+
+bool ScriptProfiler::sEnabled = false;
+uint32_t ScriptProfiler::sTotalSamples = 0;
+ScriptClassStat* ScriptProfiler::sScope = nullptr;
+std::unordered_map<std::string, ScriptClassStat> ScriptProfiler::sClassStats;
+std::unordered_map<std::string, ScriptSampleStat> ScriptProfiler::sSampleStats;
+
+void ScriptProfiler::Enable(bool enable, uint32_t instructionInterval)
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (enable)
+    {
+        // Coroutines created after this point inherit the hook.
+        lua_sethook(L, SampleHook, LUA_MASKCOUNT, int(glm::max<uint32_t>(instructionInterval, 1)));
+    }
+    else
+    {
+        lua_sethook(L, nullptr, 0, 0);
+    }
+
+    sEnabled = enable;
+#endif
+}
+
+bool ScriptProfiler::IsEnabled()
+{
+    return sEnabled;
+}
+
+void ScriptProfiler::Reset()
+{
+    // Class stats may be referenced by active scopes, so only clear their values.
+    for (auto& it : sClassStats)
+    {
+        it.second.mTotalTime = 0;
+        it.second.mFrameTime = 0;
+        it.second.mNumTicks = 0;
+        it.second.mSmoothedTime = 0.0f;
+    }
+
+    sSampleStats.clear();
+    sTotalSamples = 0;
+}
+
+void ScriptProfiler::EndFrame(float deltaTime)
+{
+    if (!sEnabled)
+        return;
+
+    for (auto& it : sClassStats)
+    {
+        ScriptClassStat& stat = it.second;
+        stat.mSmoothedTime = Maths::Damp(stat.mSmoothedTime, stat.mFrameTime / 1000.0f, 0.05f, deltaTime);
+        stat.mFrameTime = 0;
+    }
+}
+
+ScriptClassStat* ScriptProfiler::FindClassStat(const std::string& className)
+{
+    auto it = sClassStats.find(className);
+
+    if (it == sClassStats.end())
+    {
+        it = sClassStats.insert({ className, ScriptClassStat() }).first;
+        it->second.mClassName = className;
+    }
+
+    return &it->second;
+}
+
+ScriptClassStat* ScriptProfiler::SetScope(ScriptClassStat* classStat)
+{
+    ScriptClassStat* prevScope = sScope;
+    sScope = classStat;
+    return prevScope;
+}
+
+void ScriptProfiler::GetClassStats(std::vector<const ScriptClassStat*>& outStats)
+{
+    outStats.clear();
+
+    for (auto& it : sClassStats)
+    {
+        if (it.second.mNumTicks > 0)
+        {
+            outStats.push_back(&it.second);
+        }
+    }
+
+    std::sort(outStats.begin(), outStats.end(), [](const ScriptClassStat* a, const ScriptClassStat* b)
+    {
+        return a->mTotalTime > b->mTotalTime;
+    });
+}
+
+void ScriptProfiler::GetSampleStats(std::vector<const ScriptSampleStat*>& outStats)
+{
+    outStats.clear();
+
+    for (auto& it : sSampleStats)
+    {
+        outStats.push_back(&it.second);
+    }
+
+    std::sort(outStats.begin(), outStats.end(), [](const ScriptSampleStat* a, const ScriptSampleStat* b)
+    {
+        return a->mNumSamples > b->mNumSamples;
+    });
+}
+
+uint32_t ScriptProfiler::GetTotalSamples()
+{
+    return sTotalSamples;
+}
+
+void ScriptProfiler::Dump(const char* fileName)
+{
+    FILE* file = fopen(fileName, "w");
+
+    if (file != nullptr)
+    {
+        std::vector<const ScriptClassStat*> classStats;
+        GetClassStats(classStats);
+
+        fprintf(file, "----- Tick Time Per Class -----\n");
+        fprintf(file, "Class, Total ms, Ticks, Avg us/tick\n");
+
+        for (uint32_t i = 0; i < classStats.size(); ++i)
+        {
+            const ScriptClassStat* stat = classStats[i];
+            fprintf(file, "%s, %.3f, %u, %.3f\n",
+                stat->mClassName.c_str(),
+                stat->mTotalTime / 1000.0,
+                stat->mNumTicks,
+                double(stat->mTotalTime) / stat->mNumTicks);
+        }
+
+        std::vector<const ScriptSampleStat*> sampleStats;
+        GetSampleStats(sampleStats);
+
+        fprintf(file, "\n----- Samples (%u total) -----\n", sTotalSamples);
+        fprintf(file, "Class, Function, Location, Samples, Percent\n");
+
+        for (uint32_t i = 0; i < sampleStats.size(); ++i)
+        {
+            const ScriptSampleStat* stat = sampleStats[i];
+            fprintf(file, "%s, %s, %s, %u, %.2f\n",
+                stat->mClassName.c_str(),
+                stat->mFunction.c_str(),
+                stat->mLocation.c_str(),
+                stat->mNumSamples,
+                100.0f * stat->mNumSamples / glm::max<uint32_t>(sTotalSamples, 1));
+        }
+
+        fclose(file);
+        file = nullptr;
+
+        LogDebug("Script profile written to %s", fileName);
+    }
+    else
+    {
+        LogError("Failed to open %s for writing the script profile", fileName);
+    }
+}
+
+void ScriptProfiler::SampleHook(lua_State* L, lua_Debug* ar)
+{
+#if LUA_ENABLED
+    if (lua_getinfo(L, "Sln", ar) == 0)
+        return;
+
+    char location[128];
+    snprintf(location, 128, "%s:%d", ar->short_src, ar->currentline);
+
+    // The name is only known when the caller can tell (e.g. not for tail calls),
+    // so the line the function is defined on keeps functions apart.
+    char function[128];
+    if (ar->what != nullptr && strcmp(ar->what, "main") == 0)
+    {
+        snprintf(function, 128, "(main chunk)");
+    }
+    else
+    {
+        snprintf(function, 128, "%s:%d", (ar->name != nullptr) ? ar->name : "?", ar->linedefined);
+    }
+
+    const char* className = (sScope != nullptr) ? sScope->mClassName.c_str() : "";
+
+    std::string key = className;
+    key += '|';
+    key += function;
+    key += '|';
+    key += location;
+
+    ScriptSampleStat& stat = sSampleStats[key];
+
+    if (stat.mNumSamples == 0)
+    {
+        stat.mClassName = className;
+        stat.mFunction = function;
+        stat.mLocation = location;
+    }
+
+    stat.mNumSamples++;
+    sTotalSamples++;
+#endif
+}
+
+ScopedScriptProfile::ScopedScriptProfile(const std::string& className, bool tick)
+{
+    if (ScriptProfiler::IsEnabled())
+    {
+        mClassStat = ScriptProfiler::FindClassStat(className);
+        mPrevScope = ScriptProfiler::SetScope(mClassStat);
+        mTick = tick;
+        mStartTime = tick ? SYS_GetTimeMicroseconds() : 0;
+    }
+}
+
+ScopedScriptProfile::~ScopedScriptProfile()
+{
+    if (mClassStat != nullptr)
+    {
+        if (mTick)
+        {
+            uint64_t elapsed = SYS_GetTimeMicroseconds() - mStartTime;
+            mClassStat->mTotalTime += elapsed;
+            mClassStat->mFrameTime += elapsed;
+            mClassStat->mNumTicks++;
+        }
+
+        ScriptProfiler::SetScope(mPrevScope);
+    }
+}
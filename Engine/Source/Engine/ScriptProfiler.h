@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct lua_State;
+struct lua_Debug;
+
+// Time spent in script Tick() per script class.
+struct ScriptClassStat
+{
+    std::string mClassName;
+    uint64_t mTotalTime = 0;    // Microseconds since the profiler was reset
+    uint64_t mFrameTime = 0;    // Microseconds this frame
+    uint32_t mNumTicks = 0;
+    float mSmoothedTime = 0.0f; // Milliseconds per frame
+};
+
+// Number of times the Lua VM was sampled at a line while running a script class.
+struct ScriptSampleStat
+{
+    std::string mClassName;
+    std::string mFunction;      // name:line defined
+    std::string mLocation;      // source:line
+    uint32_t mNumSamples = 0;
+};
+
+// Sampling profiler for Lua. A count hook samples the running function and line every N VM instructions
+// and attributes it to the script class whose callback is currently running.
+class ScriptProfiler
+{
+public:
+
+    static void Enable(bool enable, uint32_t instructionInterval = 1000);
+    static bool IsEnabled();
+    static void Reset();
+    static void EndFrame(float deltaTime);
+
+    // Class stats are never removed, so pointers to them stay valid.
+    static ScriptClassStat* FindClassStat(const std::string& className);
+    static ScriptClassStat* SetScope(ScriptClassStat* classStat); // Returns the previous scope
+
+    // Stats sorted from most to least expensive.
+    static void GetClassStats(std::vector<const ScriptClassStat*>& outStats);
+    static void GetSampleStats(std::vector<const ScriptSampleStat*>& outStats);
+    static uint32_t GetTotalSamples();
+
+    static void Dump(const char* fileName = "ScriptProfile.txt");
+
+private:
+
+    static void SampleHook(lua_State* L, lua_Debug* ar);
+
+    static bool sEnabled;
+    static uint32_t sTotalSamples;
+    static ScriptClassStat* sScope;
+    static std::unordered_map<std::string, ScriptClassStat> sClassStats;
+    static std::unordered_map<std::string, ScriptSampleStat> sSampleStats;
+};
+
+// Attributes samples (and optionally tick time) to a script class for the lifetime of the object.
+// Does nothing when the profiler is disabled.
+struct ScopedScriptProfile
+{
+    ScopedScriptProfile(const std::string& className, bool tick);
+    ~ScopedScriptProfile();
+
+    ScriptClassStat* mClassStat = nullptr;
+    ScriptClassStat* mPrevScope = nullptr;
+    uint64_t mStartTime = 0;
+    bool mTick = false;
+};
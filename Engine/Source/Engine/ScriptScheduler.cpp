@@ -0,0 +1,523 @@
+#include "ScriptScheduler.h"
+#include "Engine.h"
+#include "Asset.h"
+#include "Log.h"
+#include "Script.h"
+#include "ScriptProfiler.h"
+
+#include "LuaBindings/Asset_Lua.h"
+
+#include <algorithm>
+
+double ScriptScheduler::sTime = 0.0;
+uint32_t ScriptScheduler::sNextId = 1;
+uint32_t ScriptScheduler::sRunningId = 0;
+std::unordered_map<uint32_t, ScriptCoroutine> ScriptScheduler::sCoroutines;
+std::vector<ScriptTimeWait> ScriptScheduler::sTimeHeap;
+std::vector<uint32_t> ScriptScheduler::sAssetWaits;
+std::vector<uint32_t> ScriptScheduler::sNextFrameWaits;
+std::unordered_map<std::string, std::vector<uint32_t>> ScriptScheduler::sSignalWaits;
+std::unordered_map<Node*, uint32_t> ScriptScheduler::sNodeRefs;
+
+static bool WakesLater(const ScriptTimeWait& a, const ScriptTimeWait& b)
+{
+    return a.mWakeTime > b.mWakeTime;
+}
+
+static bool IsAssetReady(lua_State* L, int assetRef)
+{
+    bool ready = false;
+
+#if LUA_ENABLED
+    lua_rawgeti(L, LUA_REGISTRYINDEX, assetRef);
+    Asset_Lua* assetLua = (Asset_Lua*)lua_touserdata(L, -1);
+    Asset* asset = (assetLua != nullptr) ? assetLua->mAsset.Get() : nullptr;
+    ready = (asset != nullptr && asset->IsLoaded());
+    lua_pop(L, 1);
+#endif
+
+    return ready;
+}
+
+void ScriptScheduler::Update(float deltaTime)
+{
+    // Coroutines are game logic. Like Tick, they don't run while paused or outside of play in editor.
+    if (!IsGameTickEnabled() || deltaTime == 0.0f)
+        return;
+
+    sTime += deltaTime;
+
+    if (sCoroutines.empty())
+        return;
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    // Gather everything that should wake up first. Coroutines resumed below can start new waits,
+    // which shouldn't be picked up until next frame (e.g. Wait(0) in a loop).
+    static std::vector<uint32_t> sWakeIds;
+    sWakeIds.clear();
+    sWakeIds.swap(sNextFrameWaits);
+
+    while (sTimeHeap.size() > 0 &&
+           sTimeHeap[0].mWakeTime <= sTime)
+    {
+        sWakeIds.push_back(sTimeHeap[0].mId);
+        std::pop_heap(sTimeHeap.begin(), sTimeHeap.end(), WakesLater);
+        sTimeHeap.pop_back();
+    }
+
+    for (int32_t i = int32_t(sAssetWaits.size()) - 1; i >= 0; --i)
+    {
+        auto it = sCoroutines.find(sAssetWaits[i]);
+
+        if (it == sCoroutines.end() ||
+            it->second.mWait != ScriptWaitType::Asset)
+        {
+            sAssetWaits.erase(sAssetWaits.begin() + i);
+        }
+        else if (IsAssetReady(L, it->second.mAssetRef))
+        {
+            sWakeIds.push_back(sAssetWaits[i]);
+            sAssetWaits.erase(sAssetWaits.begin() + i);
+        }
+    }
+
+    for (uint32_t i = 0; i < sWakeIds.size(); ++i)
+    {
+        Wake(sWakeIds[i]);
+    }
+#endif
+}
+
+uint32_t ScriptScheduler::StartCoroutine(lua_State* L, Node* owner, int numArgs)
+{
+    uint32_t retId = 0;
+
+#if LUA_ENABLED
+    lua_State* thread = lua_newthread(L);
+    int threadRef = luaL_ref(L, LUA_REGISTRYINDEX); // Pops thread
+
+    // Move the function and its args over to the new thread.
+    lua_xmove(L, thread, numArgs + 1);
+
+    uint32_t id = sNextId++;
+    if (sNextId == 0)
+    {
+        sNextId = 1;
+    }
+
+    ScriptCoroutine& coroutine = sCoroutines[id];
+    coroutine.mThread = thread;
+    coroutine.mThreadRef = threadRef;
+    coroutine.mOwner = owner;
+    AddNodeRef(owner);
+
+    Resume(id, L, numArgs);
+
+    retId = IsCoroutineRunning(id) ? id : 0;
+#endif
+
+    return retId;
+}
+
+void ScriptScheduler::StopCoroutine(uint32_t id)
+{
+    auto it = sCoroutines.find(id);
+
+    if (it != sCoroutines.end())
+    {
+        if (it->second.mResuming)
+        {
+            // Can't release a thread that is still on the call stack. Resume() releases it on the way out.
+            it->second.mStopRequested = true;
+        }
+        else
+        {
+            Release(id);
+        }
+    }
+}
+
+void ScriptScheduler::StopAllCoroutines()
+{
+    std::vector<uint32_t> stopIds;
+
+    for (auto& it : sCoroutines)
+    {
+        stopIds.push_back(it.first);
+    }
+
+    for (uint32_t i = 0; i < stopIds.size(); ++i)
+    {
+        StopCoroutine(stopIds[i]);
+    }
+
+    // Any remaining waits belong to coroutines that no longer exist.
+    sTimeHeap.clear();
+    sAssetWaits.clear();
+    sNextFrameWaits.clear();
+}
+
+bool ScriptScheduler::IsCoroutineRunning(uint32_t id)
+{
+    auto it = sCoroutines.find(id);
+    return (it != sCoroutines.end() && !it->second.mStopRequested);
+}
+
+bool ScriptScheduler::WaitForTime(lua_State* L, float seconds)
+{
+    ScriptCoroutine* coroutine = FindRunning(L);
+
+    if (coroutine != nullptr)
+    {
+        coroutine->mWait = ScriptWaitType::Time;
+
+        ScriptTimeWait wait;
+        wait.mWakeTime = sTime + seconds;
+        wait.mId = sRunningId;
+        sTimeHeap.push_back(wait);
+        std::push_heap(sTimeHeap.begin(), sTimeHeap.end(), WakesLater);
+    }
+
+    return (coroutine != nullptr);
+}
+
+bool ScriptScheduler::WaitForAsset(lua_State* L, int assetIdx)
+{
+    ScriptCoroutine* coroutine = FindRunning(L);
+
+#if LUA_ENABLED
+    if (coroutine != nullptr)
+    {
+        coroutine->mWait = ScriptWaitType::Asset;
+
+        lua_pushvalue(L, assetIdx);
+        coroutine->mAssetRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        sAssetWaits.push_back(sRunningId);
+    }
+#endif
+
+    return (coroutine != nullptr);
+}
+
+bool ScriptScheduler::WaitForSignal(lua_State* L, Node* node, const char* name)
+{
+    ScriptCoroutine* coroutine = FindRunning(L);
+
+    if (coroutine != nullptr)
+    {
+        coroutine->mWait = ScriptWaitType::Signal;
+        coroutine->mSignalNode = node;
+        coroutine->mSignalName = name;
+        AddNodeRef(node);
+
+        sSignalWaits[name].push_back(sRunningId);
+    }
+
+    return (coroutine != nullptr);
+}
+
+uint32_t ScriptScheduler::EmitSignal(lua_State* L, Node* node, const char* name, int numArgs)
+{
+    uint32_t numResumed = 0;
+
+#if LUA_ENABLED
+    int argsIdx = lua_gettop(L) - numArgs + 1;
+    std::vector<uint32_t> wakeIds;
+
+    auto mapIt = sSignalWaits.find(name);
+
+    if (mapIt != sSignalWaits.end())
+    {
+        // Pull the matching waits out before resuming anything, resumed coroutines may wait again.
+        std::vector<uint32_t>& waits = mapIt->second;
+        uint32_t numKept = 0;
+
+        for (uint32_t i = 0; i < waits.size(); ++i)
+        {
+            auto it = sCoroutines.find(waits[i]);
+
+            if (it == sCoroutines.end() ||
+                it->second.mWait != ScriptWaitType::Signal)
+            {
+                continue;
+            }
+
+            if (it->second.mSignalNode == node)
+            {
+                wakeIds.push_back(waits[i]);
+            }
+            else
+            {
+                waits[numKept++] = waits[i];
+            }
+        }
+
+        waits.resize(numKept);
+
+        if (waits.empty())
+        {
+            sSignalWaits.erase(mapIt);
+        }
+    }
+
+    for (uint32_t i = 0; i < wakeIds.size(); ++i)
+    {
+        auto it = sCoroutines.find(wakeIds[i]);
+
+        if (it == sCoroutines.end())
+            continue;
+
+        ScriptCoroutine& coroutine = it->second;
+        RemoveNodeRef(coroutine.mSignalNode);
+        coroutine.mSignalNode = nullptr;
+        coroutine.mSignalName.clear();
+
+        // Every waiter gets its own copy of the args.
+        for (int32_t a = 0; a < numArgs; ++a)
+        {
+            lua_pushvalue(L, argsIdx + a);
+        }
+
+        lua_xmove(L, coroutine.mThread, numArgs);
+        Resume(wakeIds[i], L, numArgs);
+        numResumed++;
+    }
+
+    lua_pop(L, numArgs);
+#endif
+
+    return numResumed;
+}
+
+uint32_t ScriptScheduler::EmitSignal(Node* node, const char* name)
+{
+    uint32_t numResumed = 0;
+
+#if LUA_ENABLED
+    numResumed = EmitSignal(GetLua(), node, name, 0);
+#endif
+
+    return numResumed;
+}
+
+void ScriptScheduler::HandleNodeDestroyed(Node* node)
+{
+    if (sNodeRefs.find(node) == sNodeRefs.end())
+        return;
+
+    // Coroutines owned by the node, or waiting on a signal it can no longer emit, are cancelled.
+    std::vector<uint32_t> stopIds;
+
+    for (auto& it : sCoroutines)
+    {
+        if (it.second.mOwner == node ||
+            it.second.mSignalNode == node)
+        {
+            stopIds.push_back(it.first);
+        }
+    }
+
+    for (uint32_t i = 0; i < stopIds.size(); ++i)
+    {
+        StopCoroutine(stopIds[i]);
+    }
+
+    // A coroutine that is mid-resume is only released after it yields, so drop its node pointers now.
+    for (auto& it : sCoroutines)
+    {
+        if (it.second.mOwner == node)
+        {
+            it.second.mOwner = nullptr;
+            RemoveNodeRef(node);
+        }
+
+        if (it.second.mSignalNode == node)
+        {
+            it.second.mSignalNode = nullptr;
+            RemoveNodeRef(node);
+        }
+    }
+}
+
+uint32_t ScriptScheduler::GetNumCoroutines()
+{
+    return uint32_t(sCoroutines.size());
+}
+
+ScriptCoroutine* ScriptScheduler::FindRunning(lua_State* L)
+{
+    ScriptCoroutine* retCoroutine = nullptr;
+    auto it = sCoroutines.find(sRunningId);
+
+    if (it != sCoroutines.end() &&
+        it->second.mThread == L)
+    {
+        retCoroutine = &it->second;
+    }
+
+    return retCoroutine;
+}
+
+void ScriptScheduler::Wake(uint32_t id)
+{
+#if LUA_ENABLED
+    auto it = sCoroutines.find(id);
+
+    if (it != sCoroutines.end())
+    {
+        ScriptCoroutine& coroutine = it->second;
+        int numArgs = 0;
+
+        if (coroutine.mWait == ScriptWaitType::Asset)
+        {
+            // The asset is returned from WaitForAsset().
+            lua_rawgeti(coroutine.mThread, LUA_REGISTRYINDEX, coroutine.mAssetRef);
+            luaL_unref(coroutine.mThread, LUA_REGISTRYINDEX, coroutine.mAssetRef);
+            coroutine.mAssetRef = LUA_REFNIL;
+            numArgs = 1;
+        }
+
+        Resume(id, GetLua(), numArgs);
+    }
+#endif
+}
+
+void ScriptScheduler::Resume(uint32_t id, lua_State* from, int numArgs)
+{
+#if LUA_ENABLED
+    auto it = sCoroutines.find(id);
+
+    if (it == sCoroutines.end())
+        return;
+
+    // Don't hold on to the map entry while the coroutine runs. It can start other coroutines.
+    lua_State* thread = it->second.mThread;
+    it->second.mWait = ScriptWaitType::None;
+    it->second.mResuming = true;
+
+    uint32_t prevRunningId = sRunningId;
+    sRunningId = id;
+
+    // Attribute the coroutine's samples to its owner's script class.
+    Node* owner = it->second.mOwner;
+    Script* ownerScript = (owner != nullptr) ? owner->GetScript() : nullptr;
+
+    int status = LUA_OK;
+#if LUA_VERSION_NUM >= 504
+    int numResults = 0;
+#endif
+
+    {
+        ScopedScriptProfile scriptProfile((ownerScript != nullptr) ? ownerScript->GetScriptClassName() : "Coroutine", false);
+
+#if LUA_VERSION_NUM >= 504
+        status = lua_resume(thread, from, numArgs, &numResults);
+#else
+        status = lua_resume(thread, from, numArgs);
+#endif
+    }
+
+    sRunningId = prevRunningId;
+
+    it = sCoroutines.find(id);
+    OCT_ASSERT(it != sCoroutines.end());
+    ScriptCoroutine& coroutine = it->second;
+    coroutine.mResuming = false;
+
+    if (status == LUA_YIELD && !coroutine.mStopRequested)
+    {
+        // Drop any values passed to yield. A plain coroutine.yield() resumes next frame.
+        lua_settop(thread, 0);
+
+        if (coroutine.mWait == ScriptWaitType::None)
+        {
+            sNextFrameWaits.push_back(id);
+        }
+    }
+    else
+    {
+        if (status != LUA_OK && status != LUA_YIELD)
+        {
+            lua_State* L = GetLua();
+            luaL_traceback(L, thread, lua_tostring(thread, -1), 0);
+            LogError("Coroutine Error: %s", lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+
+        Release(id);
+    }
+#endif
+}
+
+void ScriptScheduler::Release(uint32_t id)
+{
+    auto it = sCoroutines.find(id);
+
+    if (it == sCoroutines.end())
+        return;
+
+    ScriptCoroutine& coroutine = it->second;
+
+    if (coroutine.mSignalNode != nullptr)
+    {
+        auto mapIt = sSignalWaits.find(coroutine.mSignalName);
+
+        if (mapIt != sSignalWaits.end())
+        {
+            std::vector<uint32_t>& waits = mapIt->second;
+            waits.erase(std::remove(waits.begin(), waits.end(), id), waits.end());
+
+            if (waits.empty())
+            {
+                sSignalWaits.erase(mapIt);
+            }
+        }
+
+        RemoveNodeRef(coroutine.mSignalNode);
+    }
+
+    RemoveNodeRef(coroutine.mOwner);
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (L != nullptr)
+    {
+        if (coroutine.mAssetRef != LUA_REFNIL)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, coroutine.mAssetRef);
+        }
+
+        // Time and asset wait entries are skipped once the id is gone.
+        luaL_unref(L, LUA_REGISTRYINDEX, coroutine.mThreadRef);
+    }
+#endif
+
+    sCoroutines.erase(it);
+}
+
+void ScriptScheduler::AddNodeRef(Node* node)
+{
+    if (node != nullptr)
+    {
+        sNodeRefs[node]++;
+    }
+}
+
+void ScriptScheduler::RemoveNodeRef(Node* node)
+{
+    auto it = sNodeRefs.find(node);
+
+    if (it != sNodeRefs.end())
+    {
+        it->second--;
+
+        if (it->second == 0)
+        {
+            sNodeRefs.erase(it);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct lua_State;
+class Node;
+
+enum class ScriptWaitType : uint8_t
+{
+    None,       // Running, or yielded without a wait (resumed next frame)
+    Time,
+    Asset,
+    Signal,
+
+    Count
+};
+
+struct ScriptCoroutine
+{
+    lua_State* mThread = nullptr;
+    int mThreadRef = -1;
+    Node* mOwner = nullptr;
+    Node* mSignalNode = nullptr;
+    std::string mSignalName;
+    int mAssetRef = -1;
+    ScriptWaitType mWait = ScriptWaitType::None;
+    bool mResuming = false;
+    bool mStopRequested = false;
+};
+
+struct ScriptTimeWait
+{
+    double mWakeTime = 0.0;
+    uint32_t mId = 0;
+};
+
+// Resumes script coroutines when the thing they are waiting on happens, so scripts don't need to
+// tick just to poll a condition. Coroutines are started with Script.StartCoroutine(node, func, ...)
+// and suspend with Script.Wait(seconds), Script.WaitForAsset(asset) or Script.WaitForSignal(node, name).
+// Coroutines are cancelled when their owner node is destroyed.
+class ScriptScheduler
+{
+public:
+
+    static void Update(float deltaTime);
+
+    // The function and its args must be on top of L's stack (function first). They are popped.
+    // Returns the coroutine id, or 0 if it finished without waiting.
+    static uint32_t StartCoroutine(lua_State* L, Node* owner, int numArgs);
+    static void StopCoroutine(uint32_t id);
+    static void StopAllCoroutines();
+    static bool IsCoroutineRunning(uint32_t id);
+
+    // Called from the running coroutine right before it yields.
+    static bool WaitForTime(lua_State* L, float seconds);
+    static bool WaitForAsset(lua_State* L, int assetIdx);
+    static bool WaitForSignal(lua_State* L, Node* node, const char* name);
+
+    // Resumes everything waiting on this node's signal. The top numArgs values of L are passed to
+    // each coroutine as the results of WaitForSignal() and are popped.
+    static uint32_t EmitSignal(lua_State* L, Node* node, const char* name, int numArgs);
+    static uint32_t EmitSignal(Node* node, const char* name);
+
+    static void HandleNodeDestroyed(Node* node);
+
+    static uint32_t GetNumCoroutines();
+
+private:
+
+    static ScriptCoroutine* FindRunning(lua_State* L);
+    static void Wake(uint32_t id);
+    static void Resume(uint32_t id, lua_State* from, int numArgs);
+    static void Release(uint32_t id);
+    static void AddNodeRef(Node* node);
+    static void RemoveNodeRef(Node* node);
+
+    static double sTime;
+    static uint32_t sNextId;
+    static uint32_t sRunningId;
+    static std::unordered_map<uint32_t, ScriptCoroutine> sCoroutines;
+    static std::vector<ScriptTimeWait> sTimeHeap; // Min-heap on wake time
+    static std::vector<uint32_t> sAssetWaits;
+    static std::vector<uint32_t> sNextFrameWaits;
+    static std::unordered_map<std::string, std::vector<uint32_t>> sSignalWaits;
+    static std::unordered_map<Node*, uint32_t> sNodeRefs; // Owners and signal nodes, so node destruction can skip the scan
+};
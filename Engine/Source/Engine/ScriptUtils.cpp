@@ -1,12 +1,22 @@
 #include "ScriptUtils.h"
+#include "Script.h"
 #include "System/System.h"
 
+// Incremental collector tuning. A lower pause starts cycles sooner so each one has less work,
+// the per frame steps below keep up with it.
+#define OCT_LUA_GC_PAUSE 150
+#define OCT_LUA_GC_STEPMUL 200
+#define OCT_LUA_GC_STEP_KB 16
+
 std::unordered_set<std::string> ScriptUtils::sLoadedLuaFiles;
 std::unordered_set<std::string> ScriptUtils::sLoadingLuaFiles;
+std::unordered_map<std::string, ScriptFileInfo> ScriptUtils::sScriptFiles;
 EmbeddedFile* ScriptUtils::sEmbeddedScripts = nullptr;
 uint32_t ScriptUtils::sNumEmbeddedScripts = 0;
 uint32_t ScriptUtils::sNumScriptInstances = 0;
 bool ScriptUtils::sBreakOnScriptError = false;
+float ScriptUtils::sGcBudgetMs = 1.0f;
+float ScriptUtils::sGcTargetFrameTimeMs = 0.0f;
 
 bool ScriptUtils::IsScriptLoaded(const std::string& className)
 {
@@ -16,18 +26,105 @@ bool ScriptUtils::IsScriptLoaded(const std::string& className)
 bool ScriptUtils::ReloadScriptFile(const std::string& fileName)
 {
     std::string className = GetClassNameFromFileName(fileName);
+    bool wasLoaded = false;
 
     auto it = sLoadedLuaFiles.find(className);
     if (it != sLoadedLuaFiles.end())
     {
         sLoadedLuaFiles.erase(it);
+        wasLoaded = true;
     }
 
     bool success = LoadScriptFile(fileName, className);
 
+    if (!success && wasLoaded)
+    {
+        // The previous class table is still intact, so keep using it until the error is fixed.
+        LogWarning("Failed to reload %s, keeping the previous version.", className.c_str());
+        sLoadedLuaFiles.insert(className);
+    }
+
     return success;
 }
 
+void ScriptUtils::GatherModifiedScriptFiles(std::vector<std::string>& outFileNames)
+{
+    for (auto& it : sScriptFiles)
+    {
+        ScriptFileInfo& info = it.second;
+        uint64_t modifiedTime = SYS_GetFileModifiedTime(info.mPath.c_str());
+
+        if (modifiedTime != 0 &&
+            modifiedTime != info.mModifiedTime)
+        {
+            // Update now so a file that fails to load isn't retried until it is saved again.
+            info.mModifiedTime = modifiedTime;
+            outFileNames.push_back(info.mFileName);
+        }
+    }
+}
+
+// Copies the functions of a freshly loaded class table into the previous one so existing instances
+// and derived classes (which reference the previous table) see the new code. Removed functions are cleared
+// and class fields take their new values. Instance fields live on each node's uservalue and are untouched.
+static void PatchClassTable(lua_State* L, int dstIdx, int srcIdx, const std::string& className)
+{
+#if LUA_ENABLED
+    std::string classFlag = "cf" + className;
+
+    lua_pushnil(L);
+    while (lua_next(L, dstIdx) != 0)
+    {
+        if (lua_isfunction(L, -1))
+        {
+            lua_pushvalue(L, -2);
+            lua_rawget(L, srcIdx);
+            bool removed = lua_isnil(L, -1);
+            lua_pop(L, 1);
+
+            if (removed)
+            {
+                // Clearing existing fields is allowed while traversing.
+                lua_pushvalue(L, -2);
+                lua_pushnil(L);
+                lua_rawset(L, dstIdx);
+            }
+        }
+
+        // Pop value, keep key for next iteration
+        lua_pop(L, 1);
+    }
+
+    lua_pushnil(L);
+    while (lua_next(L, srcIdx) != 0)
+    {
+        bool assign = true;
+
+        // The class flag and __index are managed by LoadScriptFile() and refer to the table itself.
+        if (lua_type(L, -2) == LUA_TSTRING)
+        {
+            const char* key = lua_tostring(L, -2);
+            assign = (strcmp(key, "__index") != 0) && (classFlag != key);
+        }
+
+        if (assign)
+        {
+            lua_pushvalue(L, -2);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, dstIdx);
+        }
+
+        lua_pop(L, 1);
+    }
+
+    // Pick up a changed parent class. Tables without one are parented to the native node when instanced.
+    if (lua_getmetatable(L, srcIdx))
+    {
+        lua_setmetatable(L, dstIdx);
+    }
+#endif
+}
+
 bool ScriptUtils::CallLuaFunc(int numArgs, int numResults)
 {
     bool success = true;
@@ -60,10 +157,68 @@ bool ScriptUtils::LoadScriptFile(const std::string& fileName, const std::string&
     sLoadingLuaFiles.insert(fileName);
 
     lua_State* L = GetLua();
+
+    // Hold on to the previous class table so it can be patched in place if the class is being reloaded.
+    int prevClassRef = LUA_REFNIL;
+    lua_getglobal(L, className.c_str());
+    if (lua_istable(L, -1))
+    {
+        prevClassRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+    else
+    {
+        lua_pop(L, 1);
+    }
+
     successful = RunScript(fileName.c_str());
 
+    // Any cached property/net defs belong to the old class table.
+    Script::ClearClassCache(className);
+
+    if (successful && prevClassRef != LUA_REFNIL)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, prevClassRef);
+        int prevIdx = lua_gettop(L);
+        lua_getglobal(L, className.c_str());
+        int newIdx = lua_gettop(L);
+
+        if (lua_istable(L, newIdx) &&
+            !lua_rawequal(L, prevIdx, newIdx))
+        {
+            PatchClassTable(L, prevIdx, newIdx, className);
+
+            lua_pushvalue(L, prevIdx);
+            lua_setglobal(L, className.c_str());
+        }
+
+        lua_pop(L, 2);
+    }
+
+    if (prevClassRef != LUA_REFNIL)
+    {
+        if (!successful)
+        {
+            // The chunk may have replaced the global before failing. Put the working class table back.
+            lua_rawgeti(L, LUA_REGISTRYINDEX, prevClassRef);
+            lua_setglobal(L, className.c_str());
+        }
+
+        luaL_unref(L, LUA_REGISTRYINDEX, prevClassRef);
+    }
+
     if (successful)
     {
+        // Track the file on disk for hot reloading. Embedded scripts can't change at runtime.
+        std::string path = (FindEmbeddedScript(className) == nullptr) ? FindScriptFilePath(fileName) : "";
+
+        if (path != "")
+        {
+            ScriptFileInfo& info = sScriptFiles[className];
+            info.mFileName = fileName;
+            info.mPath = path;
+            info.mModifiedTime = SYS_GetFileModifiedTime(path.c_str());
+        }
+
         // Assign the __index metamethod to itself, so that tables with the class metatable
         // will have access to its methods/properties.
         lua_getglobal(L, className.c_str());
@@ -108,8 +263,6 @@ void ScriptUtils::ReloadAllScriptFiles()
         std::string className = GetClassNameFromFileName(fileNames[i]);
         LoadScriptFile(fileNames[i], className);
     }
-
-    // This doesn't re-gather the NetFuncs for this script file.
 }
 
 void ScriptUtils::LoadAllScripts()
@@ -219,13 +372,8 @@ EmbeddedFile* ScriptUtils::FindEmbeddedScript(const std::string& className)
     return retFile;
 }
 
-bool ScriptUtils::RunScript(const char* fileName, Datum* ret)
+std::string ScriptUtils::FindScriptFilePath(const std::string& fileName)
 {
-    bool successful = false;
-
-#if LUA_ENABLED
-    lua_State* L = GetLua();
-
     std::string relativeFileName = fileName;
 
     if (relativeFileName.length() < 4 ||
@@ -234,9 +382,33 @@ bool ScriptUtils::RunScript(const char* fileName, Datum* ret)
         relativeFileName.append(".lua");
     }
 
+    std::string fullFileName = GetEngineState()->mProjectDirectory + "Scripts/" + relativeFileName;
+
+    if (!SYS_DoesFileExist(fullFileName.c_str(), true))
+    {
+        // Fall back to Engine script directory
+        fullFileName = std::string("Engine/Scripts/") + relativeFileName;
+
+        if (!SYS_DoesFileExist(fullFileName.c_str(), true))
+        {
+            fullFileName = "";
+        }
+    }
+
+    return fullFileName;
+}
+
+bool ScriptUtils::RunScript(const char* fileName, Datum* ret)
+{
+    bool successful = false;
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
     bool fileExists = false;
     std::string className = GetClassNameFromFileName(fileName);
     EmbeddedFile* embeddedScript = nullptr;
+    std::string fullFileName;
 
     if (sEmbeddedScripts != nullptr &&
         sNumEmbeddedScripts > 0)
@@ -245,18 +417,10 @@ bool ScriptUtils::RunScript(const char* fileName, Datum* ret)
         fileExists = (embeddedScript != nullptr);
     }
 
-    std::string fullFileName = GetEngineState()->mProjectDirectory + "Scripts/" + relativeFileName;
-
-    if (!fileExists)
-    {
-        fileExists = SYS_DoesFileExist(fullFileName.c_str(), true);
-    }
-
     if (!fileExists)
     {
-        // Fall back to Engine script directory
-        fullFileName = std::string("Engine/Scripts/") + relativeFileName;
-        fileExists = SYS_DoesFileExist(fullFileName.c_str(), true);
+        fullFileName = FindScriptFilePath(fileName);
+        fileExists = (fullFileName != "");
     }
 
     if (fileExists)
@@ -369,6 +533,68 @@ void ScriptUtils::GarbageCollect()
 #endif
 }
 
+void ScriptUtils::InitGarbageCollector()
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+#if LUA_VERSION_NUM >= 504
+    lua_gc(L, LUA_GCGEN, 0, 0);
+#else
+    lua_gc(L, LUA_GCSETPAUSE, OCT_LUA_GC_PAUSE);
+    lua_gc(L, LUA_GCSETSTEPMUL, OCT_LUA_GC_STEPMUL);
+#endif
+#endif
+}
+
+void ScriptUtils::StepGarbageCollector(float cpuTimeMs, float framePeriodMs)
+{
+#if LUA_ENABLED
+    float targetMs = (sGcTargetFrameTimeMs > 0.0f) ? sGcTargetFrameTimeMs : framePeriodMs;
+    float budgetMs = glm::min(sGcBudgetMs, targetMs - cpuTimeMs);
+
+    if (budgetMs <= 0.0f)
+        return;
+
+    lua_State* L = GetLua();
+    uint64_t endTime = SYS_GetTimeMicroseconds() + uint64_t(budgetMs * 1000.0f);
+
+    do
+    {
+        // Stop once a cycle finishes, otherwise the next step would start a new one right away.
+        if (lua_gc(L, LUA_GCSTEP, OCT_LUA_GC_STEP_KB))
+            break;
+    } while (SYS_GetTimeMicroseconds() < endTime);
+#endif
+}
+
+void ScriptUtils::SetGarbageCollectBudget(float budgetMs)
+{
+    sGcBudgetMs = glm::max(budgetMs, 0.0f);
+}
+
+float ScriptUtils::GetGarbageCollectBudget()
+{
+    return sGcBudgetMs;
+}
+
+void ScriptUtils::SetGarbageCollectTargetFrameTime(float frameTimeMs)
+{
+    sGcTargetFrameTimeMs = frameTimeMs;
+}
+
+uint32_t ScriptUtils::GetMemoryUsage()
+{
+    uint32_t bytes = 0;
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+    bytes = uint32_t(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + uint32_t(lua_gc(L, LUA_GCCOUNTB, 0));
+#endif
+
+    return bytes;
+}
+
 Datum ScriptUtils::GetField(int userdataIdx, const char* key)
 {
     Datum ret;
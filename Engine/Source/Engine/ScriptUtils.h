@@ -2,6 +2,15 @@
 
 #include "ScriptMacros.h"
 #include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+struct ScriptFileInfo
+{
+    std::string mFileName;      // As passed to LoadScriptFile()
+    std::string mPath;          // Resolved path on disk
+    uint64_t mModifiedTime = 0;
+};
 
 class ScriptUtils
 {
@@ -15,6 +24,11 @@ public:
     static void LoadAllScripts();
     static void LoadScriptDirectory(const std::string& dirName, bool recurse = true);
 
+    // Returns the file names of loaded script classes whose files changed on disk since they were loaded.
+    // Embedded scripts are not tracked.
+    static void GatherModifiedScriptFiles(std::vector<std::string>& outFileNames);
+    static std::string FindScriptFilePath(const std::string& fileName);
+
     static std::string GetClassNameFromFileName(const std::string& fileName);
     static void SetEmbeddedScripts(EmbeddedFile* embeddedScripts, uint32_t numEmbeddedScripts);
     static EmbeddedFile* FindEmbeddedScript(const std::string& className);
@@ -27,6 +41,17 @@ public:
 
     static void GarbageCollect();
 
+    // The collector runs incrementally and the engine spends leftover frame time stepping it,
+    // so fewer collection steps land in the middle of script ticks. cpuTimeMs is the frame's work
+    // before presenting, framePeriodMs is the measured frame interval (vsync or frame cap).
+    // The target frame time defaults to 0, which follows the measured interval.
+    static void InitGarbageCollector();
+    static void StepGarbageCollector(float cpuTimeMs, float framePeriodMs);
+    static void SetGarbageCollectBudget(float budgetMs);
+    static float GetGarbageCollectBudget();
+    static void SetGarbageCollectTargetFrameTime(float frameTimeMs);
+    static uint32_t GetMemoryUsage();
+
     static Datum GetField(int userdataIdx, const char* key);
     static void SetField(int userdataIdx, const char* key, const Datum& value);
 
@@ -37,9 +62,12 @@ private:
 
     static std::unordered_set<std::string> sLoadedLuaFiles;
     static std::unordered_set<std::string> sLoadingLuaFiles;
+    static std::unordered_map<std::string, ScriptFileInfo> sScriptFiles;
     static EmbeddedFile* sEmbeddedScripts;
     static uint32_t sNumEmbeddedScripts;
     static uint32_t sNumScriptInstances;
 
     static bool sBreakOnScriptError;
+    static float sGcBudgetMs;
+    static float sGcTargetFrameTimeMs;
 };
@@ -20,7 +20,10 @@ Stream::Stream() :
     mCapacity(0),
     mPos(0),
     mAsyncRequest(nullptr),
-    mExternal(false)
+    mBitBuffer(0),
+    mNumBits(0),
+    mExternal(false),
+    mBitWriting(false)
 {
 
 }
@@ -32,7 +35,10 @@ Stream::Stream(const char* externalData, uint32_t externalSize) :
     mCapacity(externalSize),
     mPos(0),
     mAsyncRequest(nullptr),
-    mExternal(true)
+    mBitBuffer(0),
+    mNumBits(0),
+    mExternal(true),
+    mBitWriting(false)
 {
 
 }
@@ -82,6 +88,8 @@ void Stream::Reset()
     mCapacity = 0;
     mPos = 0;
     mAsyncRequest = nullptr;
+    mBitBuffer = 0;
+    mNumBits = 0;
     mExternal = false;
 }
 
@@ -487,6 +495,84 @@ void Stream::WriteMatrix(const glm::mat4& src)
     }
 }
 
+uint32_t Stream::ReadVarUint32()
+{
+    uint32_t ret = 0;
+
+    for (uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte = ReadUint8();
+        ret |= uint32_t(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+            break;
+    }
+
+    return ret;
+}
+
+void Stream::WriteVarUint32(uint32_t src)
+{
+    while (src >= 0x80)
+    {
+        WriteUint8(uint8_t(src | 0x80));
+        src >>= 7;
+    }
+
+    WriteUint8(uint8_t(src));
+}
+
+uint32_t Stream::ReadBits(uint32_t numBits)
+{
+    OCT_ASSERT(numBits <= 32);
+    OCT_ASSERT(mNumBits == 0 || !mBitWriting);
+    mBitWriting = false;
+
+    while (mNumBits < numBits)
+    {
+        mBitBuffer |= uint64_t(ReadUint8()) << mNumBits;
+        mNumBits += 8;
+    }
+
+    uint32_t ret = uint32_t(mBitBuffer & ((uint64_t(1) << numBits) - 1));
+    mBitBuffer >>= numBits;
+    mNumBits -= numBits;
+
+    return ret;
+}
+
+void Stream::WriteBits(uint32_t src, uint32_t numBits)
+{
+    OCT_ASSERT(numBits <= 32);
+    OCT_ASSERT(mNumBits == 0 || mBitWriting);
+    mBitWriting = true;
+
+    uint64_t mask = (uint64_t(1) << numBits) - 1;
+    mBitBuffer |= (uint64_t(src) & mask) << mNumBits;
+    mNumBits += numBits;
+
+    while (mNumBits >= 8)
+    {
+        WriteUint8(uint8_t(mBitBuffer & 0xff));
+        mBitBuffer >>= 8;
+        mNumBits -= 8;
+    }
+}
+
+void Stream::AlignBits()
+{
+    if (mBitWriting && mNumBits > 0)
+    {
+        // Pad out the final partial byte
+        WriteUint8(uint8_t(mBitBuffer & 0xff));
+    }
+
+    // When reading, any bits left in the buffer are just padding.
+    mBitBuffer = 0;
+    mNumBits = 0;
+    mBitWriting = false;
+}
+
 std::string Stream::GetLine()
 {
     std::string line;
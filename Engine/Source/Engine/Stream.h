@@ -74,6 +74,16 @@ public:
     void WriteQuat(const glm::quat& src);
     void WriteMatrix(const glm::mat4& src);
 
+    // Variable length (7 bits per byte) unsigned integers.
+    uint32_t ReadVarUint32();
+    void WriteVarUint32(uint32_t src);
+
+    // Bit packing. Bits are packed least significant first, independent of endianness.
+    // Call AlignBits() after the last bit read/write before using the byte-level functions again.
+    uint32_t ReadBits(uint32_t numBits);
+    void WriteBits(uint32_t src, uint32_t numBits);
+    void AlignBits();
+
     std::string GetLine();
     int32_t Scan(const char* format, ...);
 
@@ -166,5 +176,8 @@ private:
     uint32_t mCapacity;
     uint32_t mPos;
     AsyncLoadRequest* mAsyncRequest;
+    uint64_t mBitBuffer;
+    uint32_t mNumBits;
     bool mExternal;
+    bool mBitWriting;
 };
@@ -2,6 +2,10 @@
 
 #include "Nodes/Node.h"
 
+#define TIMER_SLOT_BITS 20
+#define TIMER_SLOT_MASK ((1 << TIMER_SLOT_BITS) - 1)
+#define TIMER_GENERATION_MASK 0x7ff
+
 TimerManager gTimerManager;
 
 TimerManager* GetTimerManager()
@@ -9,41 +13,52 @@ TimerManager* GetTimerManager()
     return &gTimerManager;
 }
 
+static int32_t MakeTimerId(uint32_t slot, uint16_t generation)
+{
+    return (int32_t)(((uint32_t)(generation & TIMER_GENERATION_MASK) << TIMER_SLOT_BITS) | slot);
+}
+
 void TimerManager::Update(float deltaTime)
 {
     static std::vector<TimerData> sTimersToExecute;
+    static std::vector<uint32_t> sTimersToReschedule;
     sTimersToExecute.clear();
+    sTimersToReschedule.clear();
 
-    for (int32_t i = 0; i < (int32_t)mTimerData.size(); ++i)
+    mTime += deltaTime;
+
+    // Only the timers that are due get touched. Looping timers are pushed back
+    // onto the heap after the pop loop so that a zero duration timer can't spin.
+    while (mTimerHeap.size() > 0 &&
+           mTimerHeap[0].mFireTime <= mTime)
     {
-        TimerData* timer = &(mTimerData[i]);
+        uint32_t slot = mTimerHeap[0].mSlot;
+        TimerData* timer = &(mTimerData[slot]);
+        HeapRemove(slot);
 
-        if (!timer->mPaused)
-        {
-            timer->mTimeRemaining -= deltaTime;
+        // Add this to the list of timers to execute.
+        // This has to be done after popping, otherwise these timer
+        // handler functions could add/remove timers from the timer heap.
+        sTimersToExecute.push_back(*timer);
 
-            if (timer->mTimeRemaining <= 0.0f)
-            {
-                // Add this to the list of timers to execute.
-                // This has to be done after iterating, otherwise these timer
-                // handler functions could add/remove timers from the timer array.
-                sTimersToExecute.push_back(*timer);
-
-                if (timer->mLoop)
-                {
-                    // If looping, reset time remaining
-                    timer->mTimeRemaining = timer->mDuration;
-                }
-                else
-                {
-                    // If not looping, remove the timer from the vector
-                    mTimerData.erase(mTimerData.begin() + i);
-                    --i;
-                }
-            }
+        if (timer->mLoop)
+        {
+            sTimersToReschedule.push_back(slot);
+        }
+        else
+        {
+            FreeTimer(slot);
         }
     }
 
+    for (uint32_t i = 0; i < sTimersToReschedule.size(); ++i)
+    {
+        uint32_t slot = sTimersToReschedule[i];
+        TimerData* timer = &(mTimerData[slot]);
+        timer->mFireTime = mTime + timer->mDuration;
+        HeapPush(slot);
+    }
+
     for (uint32_t i = 0; i < sTimersToExecute.size(); ++i)
     {
         TimerData* timer = &(sTimersToExecute[i]);
@@ -100,74 +115,53 @@ void TimerManager::Update(float deltaTime)
 
 int32_t TimerManager::SetTimer(TimerHandlerFP handler, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
+    TimerData* timerData = AllocTimer(TimerType::Void, time, loop);
+    timerData->mHandler = (void*)handler;
 
-    TimerData timerData;
-    timerData.mId = id;
-    timerData.mHandler = (void*)handler;
-    timerData.mType = TimerType::Void;
-    timerData.mDuration = time;
-    timerData.mLoop = loop;
-    timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
-
-    return id;
+    return timerData->mId;
 }
 
 int32_t TimerManager::SetTimer(void* vp, PointerTimerHandlerFP handler, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
-
-    TimerData timerData;
-    timerData.mId = id;
-    timerData.mHandler = (void*)handler;
-    timerData.mType = TimerType::Pointer;
-    timerData.mPointer = vp;
-    timerData.mDuration = time;
-    timerData.mLoop = loop;
-    timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
+    TimerData* timerData = AllocTimer(TimerType::Pointer, time, loop);
+    timerData->mHandler = (void*)handler;
+    timerData->mPointer = vp;
 
-    return id;
+    return timerData->mId;
 }
 
 int32_t TimerManager::SetTimer(Node* node, NodeTimerHandlerFP handler, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
-
-    TimerData timerData;
-    timerData.mId = id;
-    timerData.mHandler = (void*)handler;
-    timerData.mType = TimerType::Node;
-    timerData.mNode = node;
-    timerData.mDuration = time;
-    timerData.mLoop = loop;
-    timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
+    TimerData* timerData = AllocTimer(TimerType::Node, time, loop);
+    timerData->mHandler = (void*)handler;
+    timerData->mNode = node;
 
-    return id;
+    return timerData->mId;
 }
 
 int32_t TimerManager::SetTimer(ScriptFunc scriptFunc, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
+    TimerData* timerData = AllocTimer(TimerType::ScriptFunc, time, loop);
+    timerData->mScriptFunc = scriptFunc;
 
-    TimerData timerData;
-    timerData.mId = id;
-    timerData.mType = TimerType::ScriptFunc;
-    timerData.mScriptFunc = scriptFunc;
-    timerData.mDuration = time;
-    timerData.mLoop = loop;
-    timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
-
-    return id;
+    return timerData->mId;
 }
 
 void TimerManager::ClearAllTimers()
 {
-    mTimerData.clear();
-    mTimerData.shrink_to_fit();
+    // Free the slots individually instead of clearing the vector so that
+    // the slot generations survive and old handles stay invalid.
+    mTimerHeap.clear();
+    mTimerHeap.shrink_to_fit();
+
+    for (uint32_t i = 0; i < mTimerData.size(); ++i)
+    {
+        if (mTimerData[i].mId != -1)
+        {
+            mTimerData[i].mHeapIndex = -1;
+            FreeTimer(i);
+        }
+    }
 }
 
 void TimerManager::ClearTimer(int32_t id)
@@ -177,37 +171,52 @@ void TimerManager::ClearTimer(int32_t id)
 
     if (index >= 0)
     {
-        mTimerData.erase(mTimerData.begin() + index);
+        HeapRemove((uint32_t)index);
+        FreeTimer((uint32_t)index);
     }
 }
 
 void TimerManager::PauseTimer(int32_t id)
 {
-    TimerData* timerData = FindTimerData(id);
+    int32_t index = -1;
+    TimerData* timerData = FindTimerData(id, &index);
 
-    if (timerData)
+    if (timerData && !timerData->mPaused)
     {
+        timerData->mTimeRemaining = float(timerData->mFireTime - mTime);
         timerData->mPaused = true;
+        HeapRemove((uint32_t)index);
     }
 }
 
 void TimerManager::ResumeTimer(int32_t id)
 {
-    TimerData* timerData = FindTimerData(id);
+    int32_t index = -1;
+    TimerData* timerData = FindTimerData(id, &index);
 
-    if (timerData)
+    if (timerData && timerData->mPaused)
     {
+        timerData->mFireTime = mTime + timerData->mTimeRemaining;
         timerData->mPaused = false;
+        HeapPush((uint32_t)index);
     }
 }
 
 void TimerManager::ResetTimer(int32_t id)
 {
-    TimerData* timerData = FindTimerData(id);
+    int32_t index = -1;
+    TimerData* timerData = FindTimerData(id, &index);
 
     if (timerData)
     {
         timerData->mTimeRemaining = timerData->mDuration;
+
+        if (!timerData->mPaused)
+        {
+            HeapRemove((uint32_t)index);
+            timerData->mFireTime = mTime + timerData->mDuration;
+            HeapPush((uint32_t)index);
+        }
     }
 }
 
@@ -218,25 +227,28 @@ float TimerManager::GetTimeRemaining(int32_t id)
 
     if (timerData)
     {
-        ret = timerData->mTimeRemaining;
+        ret = timerData->mPaused ?
+            timerData->mTimeRemaining :
+            float(timerData->mFireTime - mTime);
     }
 
     return ret;
 }
 
-
 TimerData* TimerManager::FindTimerData(int32_t id, int32_t* outIndex)
 {
     TimerData* ret = nullptr;
     int32_t index = -1;
 
-    for (uint32_t i = 0; i < mTimerData.size(); ++i)
+    if (id >= 0)
     {
-        if (mTimerData[i].mId == id)
+        uint32_t slot = uint32_t(id) & TIMER_SLOT_MASK;
+
+        if (slot < mTimerData.size() &&
+            mTimerData[slot].mId == id)
         {
-            ret = &(mTimerData[i]);
-            index = (int32_t)i;
-            break;
+            ret = &(mTimerData[slot]);
+            index = (int32_t)slot;
         }
     }
 
@@ -248,4 +260,131 @@ TimerData* TimerManager::FindTimerData(int32_t id, int32_t* outIndex)
     return ret;
 }
 
+TimerData* TimerManager::AllocTimer(TimerType type, float time, bool loop)
+{
+    uint32_t slot = 0;
+
+    if (mFreeSlots.size() > 0)
+    {
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        slot = (uint32_t)mTimerData.size();
+        OCT_ASSERT(slot <= TIMER_SLOT_MASK);
+        mTimerData.push_back(TimerData());
+    }
+
+    TimerData* timerData = &(mTimerData[slot]);
+    timerData->mId = MakeTimerId(slot, timerData->mGeneration);
+    timerData->mType = type;
+    timerData->mDuration = time;
+    timerData->mTimeRemaining = time;
+    timerData->mFireTime = mTime + time;
+    timerData->mLoop = loop;
+    timerData->mPaused = false;
+
+    HeapPush(slot);
+
+    return timerData;
+}
+
+void TimerManager::FreeTimer(uint32_t slot)
+{
+    TimerData& timerData = mTimerData[slot];
+    OCT_ASSERT(timerData.mHeapIndex == -1);
+
+    uint16_t nextGeneration = (timerData.mGeneration + 1) & TIMER_GENERATION_MASK;
+
+    // Reset the data so the NodeRef / ScriptFunc release their references.
+    timerData = TimerData();
+    timerData.mGeneration = nextGeneration;
+
+    mFreeSlots.push_back(slot);
+}
+
+void TimerManager::HeapPush(uint32_t slot)
+{
+    TimerData& timerData = mTimerData[slot];
+    OCT_ASSERT(timerData.mHeapIndex == -1);
 
+    TimerHeapEntry entry;
+    entry.mFireTime = timerData.mFireTime;
+    entry.mSlot = slot;
+
+    timerData.mHeapIndex = (int32_t)mTimerHeap.size();
+    mTimerHeap.push_back(entry);
+    HeapSiftUp(timerData.mHeapIndex);
+}
+
+void TimerManager::HeapRemove(uint32_t slot)
+{
+    int32_t heapIndex = mTimerData[slot].mHeapIndex;
+
+    if (heapIndex < 0)
+        return;
+
+    int32_t lastIndex = (int32_t)mTimerHeap.size() - 1;
+
+    if (heapIndex != lastIndex)
+    {
+        HeapSwap(heapIndex, lastIndex);
+    }
+
+    mTimerHeap.pop_back();
+    mTimerData[slot].mHeapIndex = -1;
+
+    if (heapIndex != lastIndex)
+    {
+        HeapSiftDown(heapIndex);
+        HeapSiftUp(heapIndex);
+    }
+}
+
+void TimerManager::HeapSiftUp(int32_t heapIndex)
+{
+    while (heapIndex > 0)
+    {
+        int32_t parent = (heapIndex - 1) / 2;
+
+        if (mTimerHeap[parent].mFireTime <= mTimerHeap[heapIndex].mFireTime)
+            break;
+
+        HeapSwap(parent, heapIndex);
+        heapIndex = parent;
+    }
+}
+
+void TimerManager::HeapSiftDown(int32_t heapIndex)
+{
+    int32_t count = (int32_t)mTimerHeap.size();
+
+    while (true)
+    {
+        int32_t left = heapIndex * 2 + 1;
+        int32_t right = left + 1;
+        int32_t smallest = heapIndex;
+
+        if (left < count && mTimerHeap[left].mFireTime < mTimerHeap[smallest].mFireTime)
+            smallest = left;
+        if (right < count && mTimerHeap[right].mFireTime < mTimerHeap[smallest].mFireTime)
+            smallest = right;
+
+        if (smallest == heapIndex)
+            break;
+
+        HeapSwap(heapIndex, smallest);
+        heapIndex = smallest;
+    }
+}
+
+void TimerManager::HeapSwap(int32_t a, int32_t b)
+{
+    TimerHeapEntry temp = mTimerHeap[a];
+    mTimerHeap[a] = mTimerHeap[b];
+    mTimerHeap[b] = temp;
+
+    mTimerData[mTimerHeap[a].mSlot].mHeapIndex = a;
+    mTimerData[mTimerHeap[b].mSlot].mHeapIndex = b;
+}
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 #include "ObjectRef.h"
 
 class ScriptComponent;
@@ -32,7 +33,10 @@ struct TimerData
     int32_t mId = -1;
     void* mHandler = nullptr;
     float mDuration = 0.0f;
-    float mTimeRemaining = 0.0f;
+    float mTimeRemaining = 0.0f; // Only kept up to date while paused.
+    double mFireTime = 0.0;
+    int32_t mHeapIndex = -1;
+    uint16_t mGeneration = 0;
     bool mLoop = false;
     bool mPaused = false;
     TimerType mType = TimerType::Count;
@@ -61,8 +65,30 @@ public:
 
 protected:
 
-    int32_t mNextTimerId = 0;
+    struct TimerHeapEntry
+    {
+        double mFireTime = 0.0;
+        uint32_t mSlot = 0;
+    };
+
+    TimerData* AllocTimer(TimerType type, float time, bool loop);
+    void FreeTimer(uint32_t slot);
+
+    void HeapPush(uint32_t slot);
+    void HeapRemove(uint32_t slot);
+    void HeapSiftUp(int32_t heapIndex);
+    void HeapSiftDown(int32_t heapIndex);
+    void HeapSwap(int32_t a, int32_t b);
+
+    // Timers live in a slot map so handles resolve in O(1). The id encodes
+    // the slot index in the low bits and the slot generation in the high bits
+    // so that a stale handle never matches a recycled slot.
     std::vector<TimerData> mTimerData;
+    std::vector<uint32_t> mFreeSlots;
+
+    // Min-heap of running (unpaused) timers keyed on absolute fire time.
+    std::vector<TimerHeapEntry> mTimerHeap;
+    double mTime = 0.0;
 };
 
 TimerManager* GetTimerManager();
@@ -7,6 +7,7 @@
 #include "AudioManager.h"
 #include "AssetManager.h"
 #include "NetworkManager.h"
+#include "Script.h"
 #include "InputDevices.h"
 #include "Assets/Scene.h"
 #include "Nodes/3D/StaticMesh3d.h"
@@ -536,6 +537,7 @@ void World::RegisterNode(Node* node)
         OCT_ASSERT(std::find(mAudios.begin(), mAudios.end(), (Audio3D*)node) == mAudios.end());
 #endif
         mAudios.push_back((Audio3D*)node);
+        AudioManager::RegisterAudio3D((Audio3D*)node);
     }
     else if (node->IsLight3D())
     {
@@ -569,6 +571,7 @@ void World::UnregisterNode(Node* node)
         auto it = std::find(mAudios.begin(), mAudios.end(), (Audio3D*)node);
         OCT_ASSERT(it != mAudios.end());
         mAudios.erase(it);
+        AudioManager::UnregisterAudio3D((Audio3D*)node);
     }
     else if (node->IsLight3D())
     {
@@ -779,6 +782,8 @@ void World::Update(float deltaTime)
                 pair.mPrimitiveA->EndOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
             }
         }
+
+        Script::DispatchPhysicsEvents();
     }
 
     UpdateLines(deltaTime);
@@ -789,6 +794,10 @@ void World::Update(float deltaTime)
         {
             mRootNode->RecursiveTick(deltaTime, gameTickEnabled);
         }
+
+        // Sweeps during Tick report collisions too. Deliver those this frame rather than holding
+        // on to their primitives until the next Collisions pass.
+        Script::DispatchPhysicsEvents();
     }
 
     {
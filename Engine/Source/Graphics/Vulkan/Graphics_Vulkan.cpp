@@ -8,6 +8,10 @@
 
 extern VulkanContext* gVulkanContext;
 
+// Headless mode (-headless / -server) never creates a Vulkan context, so this backend acts as a null renderer.
+// Resource creation and draws are skipped, but assets still hold on to their CPU-side data.
+#define NULL_GFX_RETURN(...) if (gVulkanContext == nullptr) { return __VA_ARGS__; }
+
 void GFX_Initialize()
 {
     // On Android, it's possible that GFX_Initialize() was already called.
@@ -20,17 +24,20 @@ void GFX_Initialize()
 
 void GFX_Shutdown()
 {
+    NULL_GFX_RETURN();
     gVulkanContext->Destroy();
     DestroyVulkanContext();
 }
 
 void GFX_BeginFrame()
 {
+    NULL_GFX_RETURN();
     gVulkanContext->BeginFrame();
 }
 
 void GFX_EndFrame()
 {
+    NULL_GFX_RETURN();
     gVulkanContext->EndFrame();
 }
 
@@ -51,32 +58,39 @@ bool GFX_ShouldCullLights()
 
 void GFX_BeginRenderPass(RenderPassId renderPassId)
 {
+    NULL_GFX_RETURN();
     gVulkanContext->BeginRenderPass(renderPassId);
 }
 
 void GFX_EndRenderPass()
 {
+    NULL_GFX_RETURN();
     gVulkanContext->EndRenderPass();
 }
 
 void GFX_SetPipelineState(PipelineConfig pipelineConfig)
 {
+    NULL_GFX_RETURN();
     BindPipelineConfig(pipelineConfig);
 }
 
 void GFX_SetViewport(int32_t x, int32_t y, int32_t width, int32_t height, bool handlePrerotation)
 {
+    NULL_GFX_RETURN();
     gVulkanContext->SetViewport(x, y, width, height, handlePrerotation, false);
 }
 
 void GFX_SetScissor(int32_t x, int32_t y, int32_t width, int32_t height, bool handlePrerotation)
 {
+    NULL_GFX_RETURN();
     gVulkanContext->SetScissor(x, y, width, height, handlePrerotation, false);
 }
 
 glm::mat4 GFX_MakePerspectiveMatrix(float fovyDegrees, float aspectRatio, float zNear, float zFar)
 {
-    VkSurfaceTransformFlagBitsKHR preTransformFlag = gVulkanContext->GetPreTransformFlag();
+    VkSurfaceTransformFlagBitsKHR preTransformFlag = (gVulkanContext != nullptr) ?
+        gVulkanContext->GetPreTransformFlag() :
+        VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
 
     glm::mat4 preRotateMat = glm::mat4(1.0f);
     glm::vec3 rotationAxis = glm::vec3(0.0f, 0.0f, 1.0f);
@@ -102,7 +116,9 @@ glm::mat4 GFX_MakePerspectiveMatrix(float fovyDegrees, float aspectRatio, float
 
 glm::mat4 GFX_MakeOrthographicMatrix(float left, float right, float bottom, float top, float zNear, float zFar)
 {
-    VkSurfaceTransformFlagBitsKHR preTransformFlag = gVulkanContext->GetPreTransformFlag();
+    VkSurfaceTransformFlagBitsKHR preTransformFlag = (gVulkanContext != nullptr) ?
+        gVulkanContext->GetPreTransformFlag() :
+        VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
 
     glm::mat4 preRotateMat = glm::mat4(1.0f);
     glm::vec3 rotationAxis = glm::vec3(0.0f, 0.0f, 1.0f);
@@ -138,11 +154,13 @@ void GFX_Draw(void* data)
 
 void GFX_DrawLines(const std::vector<Line>& lines)
 {
+    NULL_GFX_RETURN();
     gVulkanContext->DrawLines(lines);
 }
 
 void GFX_DrawFullscreen()
 {
+    NULL_GFX_RETURN();
     gVulkanContext->DrawFullscreen();
 }
 
@@ -167,6 +185,7 @@ void GFX_Reset()
 
 Node3D* GFX_ProcessHitCheck(World* world, int32_t x, int32_t y)
 {
+    NULL_GFX_RETURN(nullptr);
 #if EDITOR
     return gVulkanContext->ProcessHitCheck(world, x, y);
 #else
@@ -186,6 +205,7 @@ void GFX_SetFrameRate(int32_t frameRate)
 
 void GFX_PathTrace()
 {
+    NULL_GFX_RETURN();
     if (gVulkanContext->IsRayTracingSupported())
     {
         gVulkanContext->GetRayTracer()->PathTraceWorld();
@@ -194,6 +214,7 @@ void GFX_PathTrace()
 
 void GFX_BeginLightBake()
 {
+    NULL_GFX_RETURN();
     if (gVulkanContext->IsRayTracingSupported())
     {
         gVulkanContext->GetRayTracer()->BeginLightBake();
@@ -206,6 +227,7 @@ void GFX_BeginLightBake()
 
 void GFX_UpdateLightBake()
 {
+    NULL_GFX_RETURN();
     if (gVulkanContext->IsRayTracingSupported())
     {
         gVulkanContext->GetRayTracer()->UpdateLightBake();
@@ -214,6 +236,7 @@ void GFX_UpdateLightBake()
 
 void GFX_EndLightBake()
 {
+    NULL_GFX_RETURN();
     if (gVulkanContext->IsRayTracingSupported())
     {
         gVulkanContext->GetRayTracer()->EndLightBake();
@@ -222,6 +245,7 @@ void GFX_EndLightBake()
 
 bool GFX_IsLightBakeInProgress()
 {
+    NULL_GFX_RETURN(false);
     bool ret = false;
 
     if (gVulkanContext->IsRayTracingSupported())
@@ -234,6 +258,7 @@ bool GFX_IsLightBakeInProgress()
 
 float GFX_GetLightBakeProgress()
 {
+    NULL_GFX_RETURN(0.0f);
     float ret = 0.0f;
 
     if (gVulkanContext->IsRayTracingSupported())
@@ -246,6 +271,7 @@ float GFX_GetLightBakeProgress()
 
 void GFX_EnableMaterials(bool enable)
 {
+    NULL_GFX_RETURN();
     // This function is used to signal whether draws should bind their material pipelines.
     // Otherwise, just use the current pipeline.
     // This is kinda hacky.
@@ -254,216 +280,259 @@ void GFX_EnableMaterials(bool enable)
 
 void GFX_BeginGpuTimestamp(const char* name)
 {
+    NULL_GFX_RETURN();
     gVulkanContext->BeginGpuTimestamp(name);
 }
 
 void GFX_EndGpuTimestamp(const char* name)
 {
+    NULL_GFX_RETURN();
     gVulkanContext->EndGpuTimestamp(name);
 }
 
 void GFX_CreateTextureResource(Texture* texture, std::vector<uint8_t>& data)
 {
+    NULL_GFX_RETURN();
     CreateTextureResource(texture, data.data());
 }
 
 void GFX_DestroyTextureResource(Texture* texture)
 {
+    NULL_GFX_RETURN();
     DestroyTextureResource(texture);
 }
 
 void GFX_CreateMaterialResource(Material* material)
 {
+    NULL_GFX_RETURN();
     CreateMaterialResource(material);
 }
 
 void GFX_DestroyMaterialResource(Material* material)
 {
+    NULL_GFX_RETURN();
     DestroyMaterialResource(material);
 }
 
 void GFX_CreateStaticMeshResource(StaticMesh* staticMesh, bool hasColor, uint32_t numVertices, void* vertices, uint32_t numIndices, IndexType* indices)
 {
+    NULL_GFX_RETURN();
     CreateStaticMeshResource(staticMesh, hasColor, numVertices, vertices, numIndices, indices);
 }
 
 void GFX_DestroyStaticMeshResource(StaticMesh* staticMesh)
 {
+    NULL_GFX_RETURN();
     DestroyStaticMeshResource(staticMesh);
 }
 
 void GFX_CreateSkeletalMeshResource(SkeletalMesh* skeletalMesh, uint32_t numVertices, VertexSkinned* vertices, uint32_t numIndices, uint32_t* indices)
 {
+    NULL_GFX_RETURN();
     CreateSkeletalMeshResource(skeletalMesh, numVertices, vertices, numIndices, indices);
 }
 
 void GFX_DestroySkeletalMeshResource(SkeletalMesh* skeletalMesh)
 {
+    NULL_GFX_RETURN();
     DestroySkeletalMeshResource(skeletalMesh);
 }
 
 void GFX_CreateStaticMeshCompResource(StaticMesh3D* staticMeshComp)
 {
+    NULL_GFX_RETURN();
 
 }
 
 void GFX_DestroyStaticMeshCompResource(StaticMesh3D* staticMeshComp)
 {
+    NULL_GFX_RETURN();
 
 }
 
 void GFX_UpdateStaticMeshCompResourceColors(StaticMesh3D* staticMeshComp)
 {
+    NULL_GFX_RETURN();
     UpdateStaticMeshCompResourceColors(staticMeshComp);
 }
 
 void GFX_DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverride)
 {
+    NULL_GFX_RETURN();
     DrawStaticMeshComp(staticMeshComp, meshOverride);
 }
 
 void GFX_CreateSkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp)
 {
+    NULL_GFX_RETURN();
 
 }
 
 void GFX_DestroySkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp)
 {
+    NULL_GFX_RETURN();
     DestroySkeletalMeshCompResource(skeletalMeshComp);
 }
 
 void GFX_ReallocateSkeletalMeshCompVertexBuffer(SkeletalMesh3D* skeletalMeshComp, uint32_t numVertices)
 {
+    NULL_GFX_RETURN();
     ReallocateSkeletalMeshCompVertexBuffer(skeletalMeshComp, numVertices);
 }
 
 void GFX_UpdateSkeletalMeshCompVertexBuffer(SkeletalMesh3D* skeletalMeshComp, const std::vector<Vertex>& skinnedVertices)
 {
+    NULL_GFX_RETURN();
     UpdateSkeletalMeshCompVertexBuffer(skeletalMeshComp, skinnedVertices);
 }
 
 void GFX_DrawSkeletalMeshComp(SkeletalMesh3D* skeletalMeshComp)
 {
+    NULL_GFX_RETURN();
     DrawSkeletalMeshComp(skeletalMeshComp);
 }
 
 bool GFX_IsCpuSkinningRequired(SkeletalMesh3D* skeletalMeshComp)
 {
+    NULL_GFX_RETURN(false);
     return IsCpuSkinningRequired(skeletalMeshComp);
 }
 
 void GFX_DrawShadowMeshComp(ShadowMesh3D* shadowMeshComp)
 {
+    NULL_GFX_RETURN();
     DrawShadowMeshComp(shadowMeshComp);
 }
 
 void GFX_CreateTextMeshCompResource(TextMesh3D* textMeshComp)
 {
+    NULL_GFX_RETURN();
 
 }
 
 void GFX_DestroyTextMeshCompResource(TextMesh3D* textMeshComp)
 {
+    NULL_GFX_RETURN();
     DestroyTextMeshCompResource(textMeshComp);
 }
 
 void GFX_UpdateTextMeshCompVertexBuffer(TextMesh3D* textMeshComp, const std::vector<Vertex>& vertices)
 {
+    NULL_GFX_RETURN();
     UpdateTextMeshCompVertexBuffer(textMeshComp, vertices);
 }
 
 void GFX_DrawTextMeshComp(TextMesh3D* textMeshComp)
 {
+    NULL_GFX_RETURN();
     DrawTextMeshComp(textMeshComp);
 }
 
 void GFX_CreateParticleCompResource(Particle3D* particleComp)
 {
+    NULL_GFX_RETURN();
 
 }
 
 void GFX_DestroyParticleCompResource(Particle3D* particleComp)
 {
+    NULL_GFX_RETURN();
     DestroyParticleCompResource(particleComp);
 }
 
 void GFX_UpdateParticleCompVertexBuffer(Particle3D* particleComp, const std::vector<VertexParticle>& vertices)
 {
+    NULL_GFX_RETURN();
     UpdateParticleCompVertexBuffer(particleComp, vertices);
 }
 
 void GFX_DrawParticleComp(Particle3D* particleComp)
 {
+    NULL_GFX_RETURN();
     DrawParticleComp(particleComp);
 }
 
 void GFX_CreateQuadResource(Quad* quad)
 {
+    NULL_GFX_RETURN();
     CreateQuadResource(quad);
 }
 
 void GFX_DestroyQuadResource(Quad* quad)
 {
+    NULL_GFX_RETURN();
     DestroyQuadResource(quad);
 }
 
 void GFX_UpdateQuadResourceVertexData(Quad* quad)
 {
+    NULL_GFX_RETURN();
     UpdateQuadResourceVertexData(quad);
 }
 
 void GFX_DrawQuad(Quad* quad)
 {
+    NULL_GFX_RETURN();
     DrawQuad(quad);
 }
 
 void GFX_CreateTextResource(Text* text)
 {
+    NULL_GFX_RETURN();
     CreateTextResource(text);
 }
 
 void GFX_DestroyTextResource(Text* text)
 {
+    NULL_GFX_RETURN();
     DestroyTextResource(text);
 }
 
 void GFX_UpdateTextResourceVertexData(Text* text)
 {
+    NULL_GFX_RETURN();
     UpdateTextResourceVertexData(text);
 }
 
 void GFX_DrawText(Text* text)
 {
+    NULL_GFX_RETURN();
     DrawTextWidget(text);
 }
 
 void GFX_CreatePolyResource(Poly* poly)
 {
+    NULL_GFX_RETURN();
     CreatePolyResource(poly);
 }
 
 void GFX_DestroyPolyResource(Poly* poly)
 {
+    NULL_GFX_RETURN();
     DestroyPolyResource(poly);
 }
 
 void GFX_UpdatePolyResourceVertexData(Poly* poly)
 {
+    NULL_GFX_RETURN();
     UpdatePolyResourceVertexData(poly);
 }
 
 void GFX_DrawPoly(Poly* poly)
 {
+    NULL_GFX_RETURN();
     DrawPoly(poly);
 }
 
 void GFX_DrawStaticMesh(StaticMesh* mesh, Material* material, const glm::mat4& transform, glm::vec4 color)
 {
+    NULL_GFX_RETURN();
     DrawStaticMesh(mesh, material, transform, color);
 }
 
 void GFX_RenderPostProcessPasses()
 {
+    NULL_GFX_RETURN();
     gVulkanContext->RenderPostProcessChain();
 }
 
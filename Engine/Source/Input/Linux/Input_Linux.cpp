@@ -191,6 +191,12 @@ void INP_SetCursorPos(int32_t x, int32_t y)
 void INP_ShowCursor(bool show)
 {
     SystemState& system = GetEngineState()->mSystem;
+
+    if (system.mXcbConnection == nullptr)
+    {
+        return;
+    }
+
     uint32_t mask = XCB_CW_CURSOR;
     uint32_t valueList = show ? XCB_NONE : system.mNullCursor;
     xcb_change_window_attributes (system.mXcbConnection, system.mXcbWindow, mask, &valueList);
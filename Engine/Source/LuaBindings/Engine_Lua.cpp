@@ -131,6 +131,14 @@ int Engine_Lua::IsPlayingInEditor(lua_State* L)
     return 1;
 }
 
+int Engine_Lua::IsHeadless(lua_State* L)
+{
+    bool ret = ::IsHeadless();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
 int Engine_Lua::IsPlaying(lua_State* L)
 {
     bool ret = ::IsPlaying();
@@ -149,6 +157,33 @@ int Engine_Lua::ReloadAllScripts(lua_State* L)
     return 0;
 }
 
+int Engine_Lua::ReloadModifiedScripts(lua_State* L)
+{
+    bool restartScripts = false;
+    if (!lua_isnone(L, 1)) { restartScripts = CHECK_BOOLEAN(L, 1); }
+
+    uint32_t ret = ::ReloadModifiedScripts(restartScripts);
+
+    lua_pushinteger(L, ret);
+    return 1;
+}
+
+int Engine_Lua::EnableScriptHotReload(lua_State* L)
+{
+    bool value = CHECK_BOOLEAN(L, 1);
+
+    ::EnableScriptHotReload(value);
+    return 0;
+}
+
+int Engine_Lua::IsScriptHotReloadEnabled(lua_State* L)
+{
+    bool ret = ::IsScriptHotReloadEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
 int Engine_Lua::SetPaused(lua_State* L)
 {
     bool value = CHECK_BOOLEAN(L, 1);
@@ -233,8 +268,16 @@ void Engine_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, IsPlaying);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, IsHeadless);
+
     REGISTER_TABLE_FUNC(L, tableIdx, ReloadAllScripts);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, ReloadModifiedScripts);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, EnableScriptHotReload);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsScriptHotReloadEnabled);
+
     REGISTER_TABLE_FUNC(L, tableIdx, SetPaused);
 
     REGISTER_TABLE_FUNC(L, tableIdx, IsPaused);
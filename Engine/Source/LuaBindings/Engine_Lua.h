@@ -22,7 +22,11 @@ struct Engine_Lua
     static int SetBreakOnScriptError(lua_State* L);
     static int IsPlayingInEditor(lua_State* L);
     static int IsPlaying(lua_State* L);
+    static int IsHeadless(lua_State* L);
     static int ReloadAllScripts(lua_State* L);
+    static int ReloadModifiedScripts(lua_State* L);
+    static int EnableScriptHotReload(lua_State* L);
+    static int IsScriptHotReloadEnabled(lua_State* L);
     static int SetPaused(lua_State* L);
     static int IsPaused(lua_State* L);
     static int FrameStep(lua_State* L);
@@ -296,6 +296,28 @@ void BindNetFuncType()
     OCT_ASSERT(lua_gettop(L) == 0);
 }
 
+void BindNetRelevancy()
+{
+    lua_State* L = GetLua();
+    OCT_ASSERT(lua_gettop(L) == 0);
+
+    lua_newtable(L);
+    int tableIdx = lua_gettop(L);
+
+    lua_pushinteger(L, (int)NetRelevancy::Default);
+    lua_setfield(L, tableIdx, "Default");
+
+    lua_pushinteger(L, (int)NetRelevancy::Always);
+    lua_setfield(L, tableIdx, "Always");
+
+    lua_pushinteger(L, (int)NetRelevancy::OwnerOnly);
+    lua_setfield(L, tableIdx, "OwnerOnly");
+
+    lua_setglobal(L, "NetRelevancy");
+
+    OCT_ASSERT(lua_gettop(L) == 0);
+}
+
 void BindJustification()
 {
     lua_State* L = GetLua();
@@ -409,6 +431,7 @@ void Misc_Lua::BindMisc()
     BindButtonState();
     BindDatumType();
     BindNetFuncType();
+    BindNetRelevancy();
     BindJustification();
     BindScreenOrientation();
     BindParticleOrientation();
@@ -1,7 +1,10 @@
 #include "NetworkManager.h"
+#include "NetworkBenchmark.h"
 #include "Engine.h"
 
 #include "LuaBindings/Network_Lua.h"
+#include "LuaBindings/Node_Lua.h"
+#include "LuaBindings/Vector_Lua.h"
 #include "LuaBindings/LuaUtils.h"
 
 #include "TableDatum.h"
@@ -352,6 +355,103 @@ int Network_Lua::IsIncrementalReplicationEnabled(lua_State* L)
     return 1;
 }
 
+int Network_Lua::SetClientViewNode(lua_State* L)
+{
+    NetHostId hostId = (NetHostId)CHECK_INTEGER(L, 1);
+    Node* node = nullptr;
+    if (!lua_isnil(L, 2)) { node = CHECK_NODE(L, 2); }
+
+    NetworkManager::Get()->SetClientViewNode(hostId, node);
+
+    return 0;
+}
+
+int Network_Lua::SetClientViewPosition(lua_State* L)
+{
+    NetHostId hostId = (NetHostId)CHECK_INTEGER(L, 1);
+    glm::vec3 position = CHECK_VECTOR(L, 2);
+
+    NetworkManager::Get()->SetClientViewPosition(hostId, position);
+
+    return 0;
+}
+
+int Network_Lua::SetRelevancyDistance(lua_State* L)
+{
+    float value = CHECK_NUMBER(L, 1);
+
+    NetworkManager::Get()->SetRelevancyDistance(value);
+
+    return 0;
+}
+
+int Network_Lua::GetRelevancyDistance(lua_State* L)
+{
+    float ret = NetworkManager::Get()->GetRelevancyDistance();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int Network_Lua::SetReplicationBandwidth(lua_State* L)
+{
+    int32_t value = (int32_t)CHECK_INTEGER(L, 1);
+
+    NetworkManager::Get()->SetReplicationBandwidth((uint32_t)glm::max(value, 0));
+
+    return 0;
+}
+
+int Network_Lua::GetReplicationBandwidth(lua_State* L)
+{
+    uint32_t ret = NetworkManager::Get()->GetReplicationBandwidth();
+
+    lua_pushinteger(L, (int)ret);
+    return 1;
+}
+
+int Network_Lua::SetInterpolationDelay(lua_State* L)
+{
+    float value = CHECK_NUMBER(L, 1);
+
+    NetworkManager::Get()->SetInterpolationDelay(value);
+
+    return 0;
+}
+
+int Network_Lua::GetInterpolationDelay(lua_State* L)
+{
+    float ret = NetworkManager::Get()->GetInterpolationDelay();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int Network_Lua::SetMaxExtrapolation(lua_State* L)
+{
+    float value = CHECK_NUMBER(L, 1);
+
+    NetworkManager::Get()->SetMaxExtrapolation(value);
+
+    return 0;
+}
+
+int Network_Lua::GetMaxExtrapolation(lua_State* L)
+{
+    float ret = NetworkManager::Get()->GetMaxExtrapolation();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int Network_Lua::GetServerTime(lua_State* L)
+{
+    double ret = NetworkManager::Get()->GetServerTime();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
 int Network_Lua::GetBytesSent(lua_State* L)
 {
     int32_t ret = NetworkManager::Get()->GetBytesSent();
@@ -368,6 +468,14 @@ int Network_Lua::GetBytesReceived(lua_State* L)
     return 1;
 }
 
+int Network_Lua::GetMessagesSent(lua_State* L)
+{
+    uint32_t ret = NetworkManager::Get()->GetMessagesSent();
+
+    lua_pushinteger(L, (int)ret);
+    return 1;
+}
+
 int Network_Lua::GetUploadRate(lua_State* L)
 {
     float ret = NetworkManager::Get()->GetUploadRate();
@@ -424,6 +532,47 @@ int Network_Lua::GetHostId(lua_State* L)
     return 1;
 }
 
+int Network_Lua::SetSimulatedConditions(lua_State* L)
+{
+    NetSimConditions conditions;
+    if (!lua_isnone(L, 1)) { conditions.mLatencyMs = CHECK_NUMBER(L, 1); }
+    if (!lua_isnone(L, 2)) { conditions.mJitterMs = CHECK_NUMBER(L, 2); }
+    if (!lua_isnone(L, 3)) { conditions.mPacketLoss = CHECK_NUMBER(L, 3); }
+    if (!lua_isnone(L, 4)) { conditions.mDuplicate = CHECK_NUMBER(L, 4); }
+    if (!lua_isnone(L, 5)) { conditions.mReorder = CHECK_NUMBER(L, 5); }
+    if (!lua_isnone(L, 6)) { conditions.mSeed = (uint32_t)CHECK_INTEGER(L, 6); }
+
+    NetworkManager::Get()->SetSimulatedConditions(conditions);
+
+    return 0;
+}
+
+int Network_Lua::RunLoopbackBenchmark(lua_State* L)
+{
+    uint32_t numClients = 16;
+    uint32_t packetsPerClient = 64;
+    uint32_t packetSize = 256;
+    if (!lua_isnone(L, 1)) { numClients = (uint32_t)CHECK_INTEGER(L, 1); }
+    if (!lua_isnone(L, 2)) { packetsPerClient = (uint32_t)CHECK_INTEGER(L, 2); }
+    if (!lua_isnone(L, 3)) { packetSize = (uint32_t)CHECK_INTEGER(L, 3); }
+
+    NET_RunLoopbackBenchmark(numClients, packetsPerClient, packetSize);
+
+    return 0;
+}
+
+int Network_Lua::RunReplicationBenchmark(lua_State* L)
+{
+    NetBenchmarkOptions options;
+    if (!lua_isnone(L, 1)) { options.mNumClients = (uint32_t)CHECK_INTEGER(L, 1); }
+    if (!lua_isnone(L, 2)) { options.mNumNodes = (uint32_t)CHECK_INTEGER(L, 2); }
+    if (!lua_isnone(L, 3)) { options.mNumTicks = (uint32_t)CHECK_INTEGER(L, 3); }
+
+    ::RunReplicationBenchmark(options);
+
+    return 0;
+}
+
 // Callbacks
 int Network_Lua::SetConnectCallback(lua_State* L)
 {
@@ -520,10 +669,34 @@ void Network_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, IsIncrementalReplicationEnabled);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetClientViewNode);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetClientViewPosition);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetRelevancyDistance);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetRelevancyDistance);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetReplicationBandwidth);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetReplicationBandwidth);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetInterpolationDelay);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetInterpolationDelay);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetMaxExtrapolation);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetMaxExtrapolation);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetServerTime);
+
     REGISTER_TABLE_FUNC(L, tableIdx, GetBytesSent);
 
     REGISTER_TABLE_FUNC(L, tableIdx, GetBytesReceived);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, GetMessagesSent);
+
     REGISTER_TABLE_FUNC(L, tableIdx, GetUploadRate);
 
     REGISTER_TABLE_FUNC(L, tableIdx, GetDownloadRate);
@@ -538,6 +711,12 @@ void Network_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, GetHostId);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetSimulatedConditions);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, RunLoopbackBenchmark);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, RunReplicationBenchmark);
+
     REGISTER_TABLE_FUNC(L, tableIdx, SetConnectCallback);
 
     REGISTER_TABLE_FUNC(L, tableIdx, SetAcceptCallback);
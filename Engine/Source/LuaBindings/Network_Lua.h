@@ -35,8 +35,20 @@ struct Network_Lua
     static int GetNetStatus(lua_State* L);
     static int EnableIncrementalReplication(lua_State* L);
     static int IsIncrementalReplicationEnabled(lua_State* L);
+    static int SetClientViewNode(lua_State* L);
+    static int SetClientViewPosition(lua_State* L);
+    static int SetRelevancyDistance(lua_State* L);
+    static int GetRelevancyDistance(lua_State* L);
+    static int SetReplicationBandwidth(lua_State* L);
+    static int GetReplicationBandwidth(lua_State* L);
+    static int SetInterpolationDelay(lua_State* L);
+    static int GetInterpolationDelay(lua_State* L);
+    static int SetMaxExtrapolation(lua_State* L);
+    static int GetMaxExtrapolation(lua_State* L);
+    static int GetServerTime(lua_State* L);
     static int GetBytesSent(lua_State* L);
     static int GetBytesReceived(lua_State* L);
+    static int GetMessagesSent(lua_State* L);
     static int GetUploadRate(lua_State* L);
     static int GetDownloadRate(lua_State* L);
     static int IsServer(lua_State* L);
@@ -44,6 +56,9 @@ struct Network_Lua
     static int IsLocal(lua_State* L);
     static int IsAuthority(lua_State* L);
     static int GetHostId(lua_State* L);
+    static int SetSimulatedConditions(lua_State* L);
+    static int RunLoopbackBenchmark(lua_State* L);
+    static int RunReplicationBenchmark(lua_State* L);
 
     // Callbacks
     static int SetConnectCallback(lua_State* L);
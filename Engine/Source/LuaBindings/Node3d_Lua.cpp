@@ -50,8 +50,7 @@ int Node3D_Lua::GetPosition(lua_State* L)
 
     glm::vec3 position = comp->GetPosition();
 
-    Vector_Lua::Create(L, glm::vec4(position, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(position, 0.0f), 2);
 }
 
 int Node3D_Lua::GetRotationEuler(lua_State* L)
@@ -60,8 +59,7 @@ int Node3D_Lua::GetRotationEuler(lua_State* L)
 
     glm::vec3 rotEuler = comp->GetRotationEuler();
 
-    Vector_Lua::Create(L, glm::vec4(rotEuler, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(rotEuler, 0.0f), 2);
 }
 
 int Node3D_Lua::GetRotationQuat(lua_State* L)
@@ -70,8 +68,7 @@ int Node3D_Lua::GetRotationQuat(lua_State* L)
 
     glm::quat rotQuat = comp->GetRotationQuat();
 
-    Vector_Lua::Create(L, LuaQuatToVector(rotQuat));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, LuaQuatToVector(rotQuat), 2);
 }
 
 int Node3D_Lua::GetScale(lua_State* L)
@@ -80,8 +77,7 @@ int Node3D_Lua::GetScale(lua_State* L)
 
     glm::vec3 scale = comp->GetScale();
 
-    Vector_Lua::Create(L, glm::vec4(scale, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(scale, 0.0f), 2);
 }
 
 int Node3D_Lua::SetPosition(lua_State* L)
@@ -142,8 +138,7 @@ int Node3D_Lua::GetWorldPosition(lua_State* L)
 
     glm::vec3 absPos = comp->GetWorldPosition();
 
-    Vector_Lua::Create(L, glm::vec4(absPos, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(absPos, 0.0f), 2);
 }
 
 int Node3D_Lua::GetWorldRotationEuler(lua_State* L)
@@ -152,8 +147,7 @@ int Node3D_Lua::GetWorldRotationEuler(lua_State* L)
 
     glm::vec3 absRotEuler = comp->GetWorldRotationEuler();
 
-    Vector_Lua::Create(L, glm::vec4(absRotEuler, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(absRotEuler, 0.0f), 2);
 }
 
 int Node3D_Lua::GetWorldRotationQuat(lua_State* L)
@@ -162,8 +156,7 @@ int Node3D_Lua::GetWorldRotationQuat(lua_State* L)
 
     glm::quat absQuatEuler = comp->GetWorldRotationQuat();
 
-    Vector_Lua::Create(L, LuaQuatToVector(absQuatEuler));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, LuaQuatToVector(absQuatEuler), 2);
 }
 
 int Node3D_Lua::GetWorldScale(lua_State* L)
@@ -172,8 +165,7 @@ int Node3D_Lua::GetWorldScale(lua_State* L)
 
     glm::vec3 absScale = comp->GetWorldScale();
 
-    Vector_Lua::Create(L, glm::vec4(absScale, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(absScale, 0.0f), 2);
 }
 
 int Node3D_Lua::SetWorldPosition(lua_State* L)
@@ -279,8 +271,7 @@ int Node3D_Lua::GetForwardVector(lua_State* L)
 
     glm::vec3 fwd = comp->GetForwardVector();
 
-    Vector_Lua::Create(L, glm::vec4(fwd, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(fwd, 0.0f), 2);
 }
 
 int Node3D_Lua::GetRightVector(lua_State* L)
@@ -289,8 +280,7 @@ int Node3D_Lua::GetRightVector(lua_State* L)
 
     glm::vec3 right = comp->GetRightVector();
 
-    Vector_Lua::Create(L, glm::vec4(right, 0.0f));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(right, 0.0f), 2);
 }
 
 int Node3D_Lua::GetUpVector(lua_State* L)
@@ -299,7 +289,26 @@ int Node3D_Lua::GetUpVector(lua_State* L)
 
     glm::vec3 up = comp->GetUpVector();
 
-    Vector_Lua::Create(L, glm::vec4(up, 0.0f));
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(up, 0.0f), 2);
+}
+
+int Node3D_Lua::EnableNetInterpolation(lua_State* L)
+{
+    Node3D* comp = CHECK_NODE_3D(L, 1);
+    bool enable = CHECK_BOOLEAN(L, 2);
+
+    comp->EnableNetInterpolation(enable);
+
+    return 0;
+}
+
+int Node3D_Lua::IsNetInterpolationEnabled(lua_State* L)
+{
+    Node3D* comp = CHECK_NODE_3D(L, 1);
+
+    bool ret = comp->IsNetInterpolationEnabled();
+
+    lua_pushboolean(L, ret);
     return 1;
 }
 
@@ -385,6 +394,10 @@ void Node3D_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, GetUpVector);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, EnableNetInterpolation);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, IsNetInterpolationEnabled);
+
     lua_pop(L, 1);
     OCT_ASSERT(lua_gettop(L) == 0);
 }
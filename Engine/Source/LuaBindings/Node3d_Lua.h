@@ -51,6 +51,9 @@ struct Node3D_Lua
     static int GetRightVector(lua_State* L);
     static int GetUpVector(lua_State* L);
 
+    static int EnableNetInterpolation(lua_State* L);
+    static int IsNetInterpolationEnabled(lua_State* L);
+
     static void Bind();
 };
 
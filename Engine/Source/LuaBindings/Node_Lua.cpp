@@ -4,6 +4,7 @@
 
 #include "Nodes/Node.h"
 #include "Assets/Scene.h"
+#include "Script.h"
 
 #include "LuaBindings/LuaUtils.h"
 #include "LuaBindings/Node_Lua.h"
@@ -58,6 +59,15 @@ int NodeWrapperNewIndex(lua_State* L)
     lua_pushvalue(L, 3);
     lua_rawset(L, uvIdx);
 
+    // Scripts cache their engine callbacks and track which replicated variables were written.
+    Node* node = ((Node_Lua*)lua_touserdata(L, 1))->mNode;
+    if (node != nullptr &&
+        node->GetScript() != nullptr &&
+        node->GetScript()->IsActive())
+    {
+        node->GetScript()->OnFieldAssigned(key);
+    }
+
     return 0;
 }
 
@@ -471,8 +481,7 @@ int Node_Lua::Traverse(lua_State* L)
 
     auto callScriptFunc = [&](Node* node) -> bool
     {
-        Datum args[1] = { node };
-        bool ret = scriptFunc.CallR(1, args);
+        bool ret = scriptFunc.CallTypedR<bool>(node);
         return ret;
     };
 
@@ -489,8 +498,7 @@ int Node_Lua::ForEach(lua_State* L)
 
     auto callScriptFunc = [&](Node* node) -> bool
     {
-        Datum args[1] = { node };
-        bool ret = scriptFunc.CallR(1, args);
+        bool ret = scriptFunc.CallTypedR<bool>(node);
         return ret;
     };
 
@@ -721,6 +729,46 @@ int Node_Lua::ForceReplication(lua_State* L)
     return 0;
 }
 
+int Node_Lua::SetNetRelevancy(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+    int value = CHECK_INTEGER(L, 2);
+
+    node->SetNetRelevancy((NetRelevancy)value);
+
+    return 0;
+}
+
+int Node_Lua::GetNetRelevancy(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+
+    NetRelevancy ret = node->GetNetRelevancy();
+
+    lua_pushinteger(L, (int)ret);
+    return 1;
+}
+
+int Node_Lua::SetNetRelevancyDistance(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    node->SetNetRelevancyDistance(value);
+
+    return 0;
+}
+
+int Node_Lua::GetNetRelevancyDistance(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+
+    float ret = node->GetNetRelevancyDistance();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
 int Node_Lua::HasTag(lua_State* L)
 {
     Node* node = CHECK_NODE(L, 1);
@@ -954,6 +1002,14 @@ void Node_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, ForceReplication);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, SetNetRelevancy);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetNetRelevancy);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetNetRelevancyDistance);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetNetRelevancyDistance);
+
     REGISTER_TABLE_FUNC(L, mtIndex, HasTag);
 
     REGISTER_TABLE_FUNC(L, mtIndex, AddTag);
@@ -80,6 +80,10 @@ struct Node_Lua
     static int SetReplicateTransform(lua_State* L);
     static int IsTransformReplicated(lua_State* L);
     static int ForceReplication(lua_State* L);
+    static int SetNetRelevancy(lua_State* L);
+    static int GetNetRelevancy(lua_State* L);
+    static int SetNetRelevancyDistance(lua_State* L);
+    static int GetNetRelevancyDistance(lua_State* L);
 
     static int HasTag(lua_State* L);
     static int AddTag(lua_State* L);
@@ -2,6 +2,7 @@
 #include "Engine.h"
 #include "AssetManager.h"
 #include "Utilities.h"
+#include "Nodes/Widgets/StatsOverlay.h"
 
 #include "LuaBindings/Renderer_Lua.h"
 #include "LuaBindings/LuaUtils.h"
@@ -23,6 +24,21 @@ int Renderer_Lua::EnableStatsOverlay(lua_State* L)
     return 0;
 }
 
+int Renderer_Lua::SetStatsDisplayMode(lua_State* L)
+{
+    int32_t mode = CHECK_INTEGER(L, 1);
+    StatsOverlay* statsWidget = Renderer::Get()->GetStatsWidget();
+
+    if (statsWidget != nullptr &&
+        mode >= 0 &&
+        mode < int32_t(StatDisplayMode::Count))
+    {
+        statsWidget->SetDisplayMode(StatDisplayMode(mode));
+    }
+
+    return 0;
+}
+
 int Renderer_Lua::EnableConsole(lua_State* L)
 {
     bool value = CHECK_BOOLEAN(L, 1);
@@ -343,6 +359,8 @@ void Renderer_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, EnableStatsOverlay);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetStatsDisplayMode);
+
     REGISTER_TABLE_FUNC(L, tableIdx, EnableConsole);
 
     REGISTER_TABLE_FUNC(L, tableIdx, SetModalWidget);
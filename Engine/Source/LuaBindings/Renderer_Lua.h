@@ -10,6 +10,7 @@
 struct Renderer_Lua
 {
     static int EnableStatsOverlay(lua_State* L);
+    static int SetStatsDisplayMode(lua_State* L);
     static int EnableConsole(lua_State* L);
     static int SetModalWidget(lua_State* L);
     static int GetModalWidget(lua_State* L);
@@ -3,9 +3,15 @@
 #include "Engine.h"
 #include "Utilities.h"
 #include "ScriptUtils.h"
+#include "ScriptProfiler.h"
+#include "ScriptScheduler.h"
+#include "Script.h"
+#include "Asset.h"
 
 #include "LuaBindings/LuaUtils.h"
 #include "LuaBindings/Script_Lua.h"
+#include "LuaBindings/Node_Lua.h"
+#include "LuaBindings/Asset_Lua.h"
 
 #if LUA_ENABLED
 
@@ -78,6 +84,84 @@ int Script_Lua::GarbageCollect(lua_State* L)
     return 0;
 }
 
+int Script_Lua::SetGarbageCollectBudget(lua_State* L)
+{
+    float budgetMs = CHECK_NUMBER(L, 1);
+
+    ScriptUtils::SetGarbageCollectBudget(budgetMs);
+
+    return 0;
+}
+
+int Script_Lua::GetGarbageCollectBudget(lua_State* L)
+{
+    float ret = ScriptUtils::GetGarbageCollectBudget();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int Script_Lua::GetMemoryUsage(lua_State* L)
+{
+    uint32_t ret = ScriptUtils::GetMemoryUsage();
+
+    lua_pushinteger(L, ret);
+    return 1;
+}
+
+int Script_Lua::EnableProfiler(lua_State* L)
+{
+    bool enable = CHECK_BOOLEAN(L, 1);
+    uint32_t interval = 1000;
+    if (!lua_isnone(L, 2)) { interval = (uint32_t)CHECK_INTEGER(L, 2); }
+
+    ScriptProfiler::Enable(enable, interval);
+
+    return 0;
+}
+
+int Script_Lua::IsProfilerEnabled(lua_State* L)
+{
+    bool ret = ScriptProfiler::IsEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Script_Lua::ResetProfiler(lua_State* L)
+{
+    ScriptProfiler::Reset();
+
+    return 0;
+}
+
+int Script_Lua::DumpProfile(lua_State* L)
+{
+    const char* fileName = "ScriptProfile.txt";
+    if (!lua_isnone(L, 1)) { fileName = CHECK_STRING(L, 1); }
+
+    ScriptProfiler::Dump(fileName);
+
+    return 0;
+}
+
+int Script_Lua::SetCollisionEventInterval(lua_State* L)
+{
+    float interval = CHECK_NUMBER(L, 1);
+
+    Script::SetCollisionEventInterval(interval);
+
+    return 0;
+}
+
+int Script_Lua::GetCollisionEventInterval(lua_State* L)
+{
+    float ret = Script::GetCollisionEventInterval();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
 int Script_Lua::LoadDirectory(lua_State* L)
 {
     const char* dirStr = CHECK_STRING(L, 1);
@@ -89,6 +173,96 @@ int Script_Lua::LoadDirectory(lua_State* L)
     return 0;
 }
 
+int Script_Lua::StartCoroutine(lua_State* L)
+{
+    Node* owner = nullptr;
+    if (!lua_isnil(L, 1)) { owner = CHECK_NODE(L, 1); }
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    int numArgs = lua_gettop(L) - 2;
+
+    uint32_t ret = ScriptScheduler::StartCoroutine(L, owner, numArgs);
+
+    lua_pushinteger(L, ret);
+    return 1;
+}
+
+int Script_Lua::StopCoroutine(lua_State* L)
+{
+    uint32_t id = (uint32_t)CHECK_INTEGER(L, 1);
+
+    ScriptScheduler::StopCoroutine(id);
+
+    return 0;
+}
+
+int Script_Lua::IsCoroutineRunning(lua_State* L)
+{
+    uint32_t id = (uint32_t)CHECK_INTEGER(L, 1);
+
+    bool ret = ScriptScheduler::IsCoroutineRunning(id);
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Script_Lua::Wait(lua_State* L)
+{
+    float seconds = 0.0f;
+    if (!lua_isnone(L, 1)) { seconds = CHECK_NUMBER(L, 1); }
+
+    if (!ScriptScheduler::WaitForTime(L, seconds))
+    {
+        return luaL_error(L, "Script.Wait() must be called from a coroutine started with Script.StartCoroutine()");
+    }
+
+    return lua_yield(L, 0);
+}
+
+int Script_Lua::WaitForAsset(lua_State* L)
+{
+    Asset_Lua* assetLua = CheckHierarchyLuaType<Asset_Lua>(L, 1, ASSET_LUA_NAME, ASSET_LUA_FLAG);
+    Asset* asset = assetLua->mAsset.Get();
+
+    // Already loaded, no need to suspend.
+    if (asset != nullptr && asset->IsLoaded())
+    {
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    if (!ScriptScheduler::WaitForAsset(L, 1))
+    {
+        return luaL_error(L, "Script.WaitForAsset() must be called from a coroutine started with Script.StartCoroutine()");
+    }
+
+    return lua_yield(L, 0);
+}
+
+int Script_Lua::WaitForSignal(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+    const char* name = CHECK_STRING(L, 2);
+
+    if (!ScriptScheduler::WaitForSignal(L, node, name))
+    {
+        return luaL_error(L, "Script.WaitForSignal() must be called from a coroutine started with Script.StartCoroutine()");
+    }
+
+    return lua_yield(L, 0);
+}
+
+int Script_Lua::EmitSignal(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+    const char* name = CHECK_STRING(L, 2);
+    int numArgs = lua_gettop(L) - 2;
+
+    uint32_t ret = ScriptScheduler::EmitSignal(L, node, name, numArgs);
+
+    lua_pushinteger(L, ret);
+    return 1;
+}
+
 void Script_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -108,8 +282,40 @@ void Script_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, GarbageCollect);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetGarbageCollectBudget);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetGarbageCollectBudget);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetMemoryUsage);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, EnableProfiler);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsProfilerEnabled);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, ResetProfiler);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, DumpProfile);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetCollisionEventInterval);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetCollisionEventInterval);
+
     REGISTER_TABLE_FUNC(L, tableIdx, LoadDirectory);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, StartCoroutine);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, StopCoroutine);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsCoroutineRunning);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, Wait);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, WaitForAsset);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, WaitForSignal);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, EmitSignal);
+
     lua_setglobal(L, SCRIPT_LUA_NAME);
 
     OCT_ASSERT(lua_gettop(L) == 0);
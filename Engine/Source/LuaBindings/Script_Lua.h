@@ -12,7 +12,23 @@ struct Script_Lua
     static int Inherit(lua_State* L);
     static int New(lua_State* L);
     static int GarbageCollect(lua_State* L);
+    static int SetGarbageCollectBudget(lua_State* L);
+    static int GetGarbageCollectBudget(lua_State* L);
+    static int GetMemoryUsage(lua_State* L);
+    static int EnableProfiler(lua_State* L);
+    static int IsProfilerEnabled(lua_State* L);
+    static int ResetProfiler(lua_State* L);
+    static int DumpProfile(lua_State* L);
+    static int SetCollisionEventInterval(lua_State* L);
+    static int GetCollisionEventInterval(lua_State* L);
     static int LoadDirectory(lua_State* L);
+    static int StartCoroutine(lua_State* L);
+    static int StopCoroutine(lua_State* L);
+    static int IsCoroutineRunning(lua_State* L);
+    static int Wait(lua_State* L);
+    static int WaitForAsset(lua_State* L);
+    static int WaitForSignal(lua_State* L);
+    static int EmitSignal(lua_State* L);
 
     static void Bind();
 };
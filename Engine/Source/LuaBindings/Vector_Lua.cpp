@@ -8,24 +8,19 @@
 
 #if LUA_ENABLED
 
-int Vector_Lua::Create(lua_State* L)
-{
-    int numArgs = lua_gettop(L);
+static int sTempPoolRef = LUA_REFNIL;
+static uint32_t sTempPoolSize = 0;
+static uint32_t sTempPoolUsed = 0;
 
-    Vector_Lua* newVector = (Vector_Lua*)lua_newuserdata(L, sizeof(Vector_Lua));
-    new (newVector) Vector_Lua();
-    luaL_getmetatable(L, VECTOR_LUA_NAME);
-    OCT_ASSERT(lua_istable(L, -1));
-    lua_setmetatable(L, -2);
+static glm::vec4 ArgsToVector(lua_State* L, int numArgs)
+{
+    glm::vec4 ret = { 0.0f, 0.0f, 0.0f, 0.0f };
 
-    // Initialize members is args were passed
     if (numArgs == 1 &&
         lua_isuserdata(L, 1))
     {
         // Initialize from other vector
-        luaL_checkudata(L, 1, VECTOR_LUA_NAME);
-        Vector_Lua* src = (Vector_Lua*)lua_touserdata(L, 1);
-        newVector->mVector = src->mVector;
+        ret = CHECK_VECTOR(L, 1);
     }
     else if (numArgs >= 1)
     {
@@ -33,10 +28,20 @@ int Vector_Lua::Create(lua_State* L)
         float y = (numArgs >= 2 && lua_isnumber(L, 2)) ? lua_tonumber(L, 2) : 0.0f;
         float z = (numArgs >= 3 && lua_isnumber(L, 3)) ? lua_tonumber(L, 3) : 0.0f;
         float w = (numArgs >= 4 && lua_isnumber(L, 4)) ? lua_tonumber(L, 4) : 0.0f;
-        newVector->mVector = glm::vec4(x, y, z, w);
+        ret = glm::vec4(x, y, z, w);
     }
 
-    return 1;
+    return ret;
+}
+
+int Vector_Lua::Create(lua_State* L)
+{
+    int numArgs = lua_gettop(L);
+
+    // Initialize members is args were passed
+    glm::vec4 value = ArgsToVector(L, numArgs);
+
+    return Vector_Lua::Create(L, value);
 }
 
 int Vector_Lua::Create(lua_State* L, glm::vec4 value)
@@ -61,6 +66,53 @@ int Vector_Lua::Create(lua_State* L, glm::vec2 value)
     return Vector_Lua::Create(L, glm::vec4(value, 0.0f, 0.0f));
 }
 
+int Vector_Lua::CreateOrAssign(lua_State* L, glm::vec4 value, int outArg)
+{
+    if (lua_isuserdata(L, outArg))
+    {
+        glm::vec4& outVec = CHECK_VECTOR(L, outArg);
+        outVec = value;
+        lua_pushvalue(L, outArg);
+        return 1;
+    }
+
+    return Vector_Lua::Create(L, value);
+}
+
+int Vector_Lua::Temp(lua_State* L)
+{
+    int numArgs = lua_gettop(L);
+    glm::vec4 value = ArgsToVector(L, numArgs);
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, sTempPoolRef);
+    int poolIdx = lua_gettop(L);
+
+    sTempPoolUsed++;
+
+    if (sTempPoolUsed > sTempPoolSize)
+    {
+        // Pool only grows to the peak number of temps used in one frame.
+        Vector_Lua::Create(L, value);
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, poolIdx, sTempPoolUsed);
+        sTempPoolSize = sTempPoolUsed;
+    }
+    else
+    {
+        lua_rawgeti(L, poolIdx, sTempPoolUsed);
+        Vector_Lua* vec = (Vector_Lua*)lua_touserdata(L, -1);
+        vec->mVector = value;
+    }
+
+    lua_remove(L, poolIdx);
+    return 1;
+}
+
+void Vector_Lua::ResetTempPool()
+{
+    sTempPoolUsed = 0;
+}
+
 int Vector_Lua::Destroy(lua_State* L)
 {
     // This isn't needed but im keeping it for furture reference for how to hookup destructor.
@@ -116,11 +168,11 @@ int Vector_Lua::Index(lua_State* L)
     }
     else
     {
-        lua_getglobal(L, VECTOR_LUA_NAME);
-        lua_pushstring(L, key);
+        // The Vector method table is bound as an upvalue so methods don't need a global lookup.
         // I think this could be a normal lua_tableget() if you wanted to follow an inheritance chain.
         // But vector doesn't need that.
-        lua_rawget(L, -2);
+        lua_pushvalue(L, 2);
+        lua_rawget(L, lua_upvalueindex(1));
         return 1;
     }
 }
@@ -236,8 +288,7 @@ int Vector_Lua::Add(lua_State* L)
         result = left + right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 3);
 }
 
 int Vector_Lua::Subtract(lua_State* L)
@@ -262,8 +313,7 @@ int Vector_Lua::Subtract(lua_State* L)
         result = left- right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 3);
 }
 
 int Vector_Lua::Multiply(lua_State* L)
@@ -288,8 +338,7 @@ int Vector_Lua::Multiply(lua_State* L)
         result = left * right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 3);
 }
 
 int Vector_Lua::Divide(lua_State* L)
@@ -315,8 +364,7 @@ int Vector_Lua::Divide(lua_State* L)
         result = left / right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 3);
 }
 
 int Vector_Lua::Equals(lua_State* L)
@@ -365,8 +413,7 @@ int Vector_Lua::Cross(lua_State* L)
 
     glm::vec3 result = glm::cross(l3, r3);
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(result, 0), 3);
 }
 
 int Vector_Lua::Lerp(lua_State* L)
@@ -377,8 +424,7 @@ int Vector_Lua::Lerp(lua_State* L)
 
     glm::vec4 result = glm::mix(a, b, alpha);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 4);
 }
 
 int Vector_Lua::Max(lua_State* L)
@@ -388,8 +434,7 @@ int Vector_Lua::Max(lua_State* L)
 
     glm::vec4 result = glm::max(a, b);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 3);
 }
 
 int Vector_Lua::Min(lua_State* L)
@@ -399,8 +444,7 @@ int Vector_Lua::Min(lua_State* L)
 
     glm::vec4 result = glm::min(a, b);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 3);
 }
 
 int Vector_Lua::Clamp(lua_State* L)
@@ -411,8 +455,7 @@ int Vector_Lua::Clamp(lua_State* L)
 
     glm::vec4 result = glm::clamp(value, min, max);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 4);
 }
 
 int Vector_Lua::Normalize(lua_State* L)
@@ -426,8 +469,7 @@ int Vector_Lua::Normalize(lua_State* L)
         result = glm::normalize(v4);
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 2);
 }
 
 int Vector_Lua::Normalize3(lua_State* L)
@@ -441,8 +483,7 @@ int Vector_Lua::Normalize3(lua_State* L)
         result = glm::normalize(v3);
     }
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(result, 0), 2);
 }
 
 int Vector_Lua::Reflect(lua_State* L)
@@ -452,8 +493,7 @@ int Vector_Lua::Reflect(lua_State* L)
 
     glm::vec3 result = glm::reflect(inc3, nrm3);
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(result, 0), 3);
 }
 
 int Vector_Lua::Damp(lua_State* L)
@@ -465,8 +505,7 @@ int Vector_Lua::Damp(lua_State* L)
 
     glm::vec4 result = Maths::Damp(src, dst, smoothing, deltaTime);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, result, 5);
 }
 
 int Vector_Lua::Rotate(lua_State* L)
@@ -477,8 +516,7 @@ int Vector_Lua::Rotate(lua_State* L)
 
     glm::vec3 result = glm::rotate(vect3, angle * DEGREES_TO_RADIANS, axis3);
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return Vector_Lua::CreateOrAssign(L, glm::vec4(result, 0), 4);
 }
 
 int Vector_Lua::Length(lua_State* L)
@@ -566,6 +604,8 @@ void Vector_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, Clone);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, Temp);
+
     REGISTER_TABLE_FUNC(L, mtIndex, Add);
     REGISTER_TABLE_FUNC_EX(L, mtIndex, Add, "__add");
 
@@ -622,7 +662,9 @@ void Vector_Lua::Bind()
 
     REGISTER_TABLE_FUNC_EX(L, mtIndex, Negate, "__unm");
 
-    REGISTER_TABLE_FUNC_EX(L, mtIndex, Index, "__index");
+    lua_pushvalue(L, mtIndex);
+    lua_pushcclosure(L, Vector_Lua::Index, 1);
+    lua_setfield(L, mtIndex, "__index");
 
     REGISTER_TABLE_FUNC_EX(L, mtIndex, NewIndex, "__newindex");
 
@@ -634,6 +676,11 @@ void Vector_Lua::Bind()
     lua_pushcfunction(L, Vector_Lua::Create);
     lua_setglobal(L, "Vec");
 
+    lua_newtable(L);
+    sTempPoolRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    sTempPoolSize = 0;
+    sTempPoolUsed = 0;
+
     OCT_ASSERT(lua_gettop(L) == 0);
 }
 
@@ -22,6 +22,14 @@ struct Vector_Lua
     static int Create(lua_State* L, glm::vec2 value);
     static int Destroy(lua_State* L);
 
+    // If the arg at outArg is a Vector, value is written into it and it is pushed. Otherwise a new Vector is pushed.
+    // Lets scripts pass in an existing vector (e.g. a:Add(b, a)) to avoid creating garbage.
+    static int CreateOrAssign(lua_State* L, glm::vec4 value, int outArg);
+
+    // Scratch vectors are pooled and recycled every frame. Don't hold on to them past the current frame.
+    static int Temp(lua_State* L);
+    static void ResetTempPool();
+
     static int Index(lua_State* L);
     static int NewIndex(lua_State* L);
     static int ToString(lua_State* L);
@@ -7,6 +7,12 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <ifaddrs.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <errno.h>
+
+// Max datagrams per recvmmsg()/sendmmsg() call
+#define NET_MAX_BATCH 64
 
 void NET_Initialize()
 {
@@ -72,6 +78,88 @@ int32_t NET_SocketSendTo(SocketHandle socketHandle, const char* buffer, uint32_t
     return bytesSent;
 }
 
+int32_t NET_SocketRecvBatch(SocketHandle socketHandle, NetDatagram* datagrams, uint32_t count)
+{
+    struct mmsghdr msgs[NET_MAX_BATCH];
+    struct iovec iovecs[NET_MAX_BATCH];
+    struct sockaddr_in fromAddrs[NET_MAX_BATCH];
+
+    count = (count < NET_MAX_BATCH) ? count : NET_MAX_BATCH;
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        iovecs[i].iov_base = datagrams[i].mData;
+        iovecs[i].iov_len = datagrams[i].mSize;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &fromAddrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(fromAddrs[i]);
+    }
+
+    int32_t numMsgs = recvmmsg(socketHandle, msgs, count, MSG_DONTWAIT, nullptr);
+
+    for (int32_t i = 0; i < numMsgs; ++i)
+    {
+        datagrams[i].mSize = msgs[i].msg_len;
+        datagrams[i].mAddr = ntohl(fromAddrs[i].sin_addr.s_addr);
+        datagrams[i].mPort = ntohs(fromAddrs[i].sin_port);
+    }
+
+    return (numMsgs > 0) ? numMsgs : 0;
+}
+
+int32_t NET_SocketSendBatch(SocketHandle socketHandle, const NetDatagram* datagrams, uint32_t count)
+{
+    struct mmsghdr msgs[NET_MAX_BATCH];
+    struct iovec iovecs[NET_MAX_BATCH];
+    struct sockaddr_in toAddrs[NET_MAX_BATCH];
+    int32_t numSent = 0;
+
+    while (count > 0)
+    {
+        uint32_t batchCount = (count < NET_MAX_BATCH) ? count : NET_MAX_BATCH;
+        memset(msgs, 0, sizeof(msgs[0]) * batchCount);
+
+        for (uint32_t i = 0; i < batchCount; ++i)
+        {
+            toAddrs[i].sin_family = AF_INET;
+            toAddrs[i].sin_addr.s_addr = htonl(datagrams[i].mAddr);
+            toAddrs[i].sin_port = htons(datagrams[i].mPort);
+            iovecs[i].iov_base = datagrams[i].mData;
+            iovecs[i].iov_len = datagrams[i].mSize;
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &toAddrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(toAddrs[i]);
+        }
+
+        int32_t batchSent = sendmmsg(socketHandle, msgs, batchCount, 0);
+
+        if (batchSent < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+
+            // sendmmsg() stops at the first message that fails. Drop it (e.g. unreachable
+            // destination, message too large) so the datagrams behind it still get sent.
+            batchSent = 1;
+        }
+        else if (batchSent == 0)
+        {
+            break;
+        }
+
+        numSent += batchSent;
+        datagrams += batchSent;
+        count -= batchSent;
+    }
+
+    return numSent;
+}
+
 void NET_SocketClose(SocketHandle socketHandle)
 {
     close(socketHandle);
@@ -0,0 +1,153 @@
+#include "Network/Network.h"
+#include "Network/NetworkConstants.h"
+#include "System/System.h"
+#include "Maths.h"
+#include "Log.h"
+
+#include <vector>
+
+#if !PLATFORM_LINUX
+
+int32_t NET_SocketRecvBatch(SocketHandle socketHandle, NetDatagram* datagrams, uint32_t count)
+{
+    int32_t numRecv = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        int32_t bytes = NET_SocketRecvFrom(socketHandle, datagrams[i].mData, datagrams[i].mSize, datagrams[i].mAddr, datagrams[i].mPort);
+
+        if (bytes <= 0)
+        {
+            break;
+        }
+
+        datagrams[i].mSize = uint32_t(bytes);
+        numRecv++;
+    }
+
+    return numRecv;
+}
+
+int32_t NET_SocketSendBatch(SocketHandle socketHandle, const NetDatagram* datagrams, uint32_t count)
+{
+    int32_t numSent = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // A datagram that fails to send is dropped, it shouldn't hold up the ones queued behind it.
+        NET_SocketSendTo(socketHandle, datagrams[i].mData, datagrams[i].mSize, datagrams[i].mAddr, datagrams[i].mPort);
+        numSent++;
+    }
+
+    return numSent;
+}
+
+#endif
+
+#define NET_BENCHMARK_BATCH 32
+#define NET_BENCHMARK_MAX_EMPTY_POLLS 10000
+
+void NET_RunLoopbackBenchmark(uint32_t numClients, uint32_t packetsPerClient, uint32_t packetSize)
+{
+    numClients = glm::clamp<uint32_t>(numClients, 1, 256);
+    packetsPerClient = glm::max<uint32_t>(packetsPerClient, 1);
+    packetSize = glm::clamp<uint32_t>(packetSize, 1, OCT_MAX_MSG_SIZE);
+
+    const uint32_t loopback = NET_IpStringToUint32("127.0.0.1");
+
+    SocketHandle serverSocket = NET_SocketCreate();
+    NET_SocketBind(serverSocket, loopback, 0);
+    NET_SocketSetBlocking(serverSocket, false);
+
+    uint32_t serverIp = 0;
+    uint16_t serverPort = 0;
+    NET_SocketGetIpAndPort(serverSocket, serverIp, serverPort);
+
+    std::vector<SocketHandle> clientSockets;
+    for (uint32_t i = 0; i < numClients; ++i)
+    {
+        SocketHandle clientSocket = NET_SocketCreate();
+        NET_SocketBind(clientSocket, loopback, 0);
+        clientSockets.push_back(clientSocket);
+    }
+
+    std::vector<char> payload(packetSize, 0x5a);
+    std::vector<char> recvData(NET_BENCHMARK_BATCH * OCT_RECV_BUFFER_SIZE);
+    NetDatagram datagrams[NET_BENCHMARK_BATCH];
+
+    for (uint32_t batched = 0; batched < 2; ++batched)
+    {
+        uint64_t recvTime = 0;
+        uint32_t numRecvCalls = 0;
+        uint32_t numReceived = 0;
+        uint32_t numLost = 0;
+
+        // Send one packet per client per round, so we never overflow the socket's receive buffer.
+        for (uint32_t round = 0; round < packetsPerClient; ++round)
+        {
+            for (uint32_t c = 0; c < numClients; ++c)
+            {
+                NET_SocketSendTo(clientSockets[c], payload.data(), packetSize, loopback, serverPort);
+            }
+
+            uint32_t roundReceived = 0;
+            uint32_t emptyPolls = 0;
+            uint64_t startTime = SYS_GetTimeMicroseconds();
+
+            while (roundReceived < numClients && emptyPolls < NET_BENCHMARK_MAX_EMPTY_POLLS)
+            {
+                int32_t count = 0;
+
+                if (batched)
+                {
+                    for (uint32_t d = 0; d < NET_BENCHMARK_BATCH; ++d)
+                    {
+                        datagrams[d].mData = &recvData[d * OCT_RECV_BUFFER_SIZE];
+                        datagrams[d].mSize = OCT_RECV_BUFFER_SIZE;
+                    }
+
+                    count = NET_SocketRecvBatch(serverSocket, datagrams, NET_BENCHMARK_BATCH);
+                }
+                else
+                {
+                    uint32_t addr = 0;
+                    uint16_t port = 0;
+                    count = (NET_SocketRecvFrom(serverSocket, recvData.data(), OCT_RECV_BUFFER_SIZE, addr, port) > 0) ? 1 : 0;
+                }
+
+                numRecvCalls++;
+
+                if (count > 0)
+                {
+                    roundReceived += count;
+                }
+                else
+                {
+                    emptyPolls++;
+                }
+            }
+
+            recvTime += SYS_GetTimeMicroseconds() - startTime;
+            numReceived += roundReceived;
+            numLost += (numClients - glm::min(roundReceived, numClients));
+        }
+
+        double nsPerPacket = numReceived ? (double(recvTime) * 1000.0 / numReceived) : 0.0;
+
+        LogDebug("[NetBenchmark] %s: %u packets (%u lost) from %u clients, %u recv calls, %.3f ms, %.1f ns/packet",
+            batched ? "Batched" : "Single",
+            numReceived,
+            numLost,
+            numClients,
+            numRecvCalls,
+            recvTime / 1000.0,
+            nsPerPacket);
+    }
+
+    for (uint32_t i = 0; i < clientSockets.size(); ++i)
+    {
+        NET_SocketClose(clientSockets[i]);
+    }
+
+    NET_SocketClose(serverSocket);
+}
@@ -14,6 +14,13 @@ int32_t NET_SocketRecv(SocketHandle socketHandle, char* buffer, uint32_t size);
 int32_t NET_SocketRecvFrom(SocketHandle socketHandle, char* buffer, uint32_t size, uint32_t& addr, uint16_t& port);
 int32_t NET_SocketSendTo(SocketHandle socketHandle, const char* buffer, uint32_t size, uint32_t addr, uint16_t port);
 void NET_SocketClose(SocketHandle socketHandle);
+
+// Batched datagram I/O. Linux uses recvmmsg()/sendmmsg(), other platforms loop over single calls.
+// Both return the number of datagrams received/sent (0 when the socket would block).
+// Sending stops early only when the socket would block. A datagram that fails for any other
+// reason is dropped and counted as sent, like any other lost UDP packet.
+int32_t NET_SocketRecvBatch(SocketHandle socketHandle, NetDatagram* datagrams, uint32_t count);
+int32_t NET_SocketSendBatch(SocketHandle socketHandle, const NetDatagram* datagrams, uint32_t count);
 void NET_SocketSetBlocking(SocketHandle socketHandle, bool blocking);
 void NET_SocketSetBroadcast(SocketHandle socketHandle, bool broadcast);
 void NET_SocketGetIpAndPort(SocketHandle socketHandle, uint32_t& ipAddr, uint16_t& port);
@@ -24,5 +31,10 @@ void NET_IpUint32ToString(uint32_t ipUint32, char* outIpString);
 uint32_t NET_GetIpAddress();
 uint32_t NET_GetSubnetMask();
 
+// Platform Independent
+// Pushes synthetic client traffic through loopback sockets and logs the throughput of
+// single vs batched receives. Used to measure the per packet cost of the server's recv path.
+void NET_RunLoopbackBenchmark(uint32_t numClients, uint32_t packetsPerClient, uint32_t packetSize);
+
 // TODO: Update LAN servers on NET_Update()
 //void NET_GetLanServers();
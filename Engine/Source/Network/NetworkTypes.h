@@ -36,3 +36,13 @@
     typedef int32_t SocketHandle;
 #endif
 
+// One datagram for batched socket I/O.
+// Recv: mData/mSize describe the buffer to fill, and mSize is set to the bytes received.
+// Send: mData/mSize describe the payload.
+struct NetDatagram
+{
+    char* mData = nullptr;
+    uint32_t mSize = 0;
+    uint32_t mAddr = 0;
+    uint16_t mPort = 0;
+};
@@ -72,6 +72,19 @@ bool SYS_DoesFileExist(const char* path, bool isAsset)
     return exists;
 }
 
+uint64_t SYS_GetFileModifiedTime(const char* path)
+{
+    struct stat info;
+    uint64_t modifiedTime = 0;
+
+    if (stat(path, &info) == 0)
+    {
+        modifiedTime = uint64_t(info.st_mtime);
+    }
+
+    return modifiedTime;
+}
+
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize)
 {
     outData = nullptr;
@@ -307,6 +320,49 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+ConditionObject* SYS_CreateCondition()
+{
+    ConditionObject* retCondition = new ConditionObject();
+
+    // Mutexes are kernel handles here, so the condition is an event.
+    // The event stays signaled until a waiter consumes it, so a signal sent between
+    // releasing the mutex and waiting is not lost.
+    int32_t result = svcCreateEvent(retCondition, RESET_ONESHOT);
+
+    if (result < 0)
+    {
+        LogError("Failed to create Condition");
+    }
+
+    return retCondition;
+}
+
+void SYS_WaitCondition(ConditionObject* condition, MutexObject* mutex)
+{
+    SYS_UnlockMutex(mutex);
+
+    // Broadcasts only wake a single waiter, so bound the wait to let the others recheck.
+    svcWaitSynchronization(*condition, 10 * 1000 * 1000);
+
+    SYS_LockMutex(mutex);
+}
+
+void SYS_SignalCondition(ConditionObject* condition)
+{
+    svcSignalEvent(*condition);
+}
+
+void SYS_BroadcastCondition(ConditionObject* condition)
+{
+    svcSignalEvent(*condition);
+}
+
+void SYS_DestroyCondition(ConditionObject* condition)
+{
+    svcCloseHandle(*condition);
+    delete condition;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     svcSleepThread(milliseconds * 1000 * 1000);
@@ -437,6 +437,19 @@ bool SYS_DoesFileExist(const char* path, bool isAsset)
     return exists;
 }
 
+uint64_t SYS_GetFileModifiedTime(const char* path)
+{
+    struct stat info;
+    uint64_t modifiedTime = 0;
+
+    if (stat(path, &info) == 0)
+    {
+        modifiedTime = uint64_t(info.st_mtime);
+    }
+
+    return modifiedTime;
+}
+
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize)
 {
     outData = nullptr;
@@ -732,6 +745,45 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+ConditionObject* SYS_CreateCondition()
+{
+    ConditionObject* retCondition = new ConditionObject();
+    int status = pthread_cond_init(retCondition, nullptr);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Condition");
+    }
+
+    return retCondition;
+}
+
+void SYS_WaitCondition(ConditionObject* condition, MutexObject* mutex)
+{
+    int status = pthread_cond_wait(condition, mutex);
+
+    if (status != 0)
+    {
+        LogError("Failed to wait on condition");
+    }
+}
+
+void SYS_SignalCondition(ConditionObject* condition)
+{
+    pthread_cond_signal(condition);
+}
+
+void SYS_BroadcastCondition(ConditionObject* condition)
+{
+    pthread_cond_broadcast(condition);
+}
+
+void SYS_DestroyCondition(ConditionObject* condition)
+{
+    pthread_cond_destroy(condition);
+    delete condition;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
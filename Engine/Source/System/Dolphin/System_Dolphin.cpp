@@ -101,6 +101,19 @@ bool SYS_DoesFileExist(const char* path, bool isAsset)
     return exists;
 }
 
+uint64_t SYS_GetFileModifiedTime(const char* path)
+{
+    struct stat info;
+    uint64_t modifiedTime = 0;
+
+    if (stat(path, &info) == 0)
+    {
+        modifiedTime = uint64_t(info.st_mtime);
+    }
+
+    return modifiedTime;
+}
+
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize)
 {
     outData = nullptr;
@@ -327,6 +340,41 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+ConditionObject* SYS_CreateCondition()
+{
+    ConditionObject* retCondition = new ConditionObject();
+
+    int32_t status = LWP_CondInit(retCondition);
+
+    if (status < 0)
+    {
+        LogError("Failed to create Condition");
+    }
+
+    return retCondition;
+}
+
+void SYS_WaitCondition(ConditionObject* condition, MutexObject* mutex)
+{
+    LWP_CondWait(*condition, *mutex);
+}
+
+void SYS_SignalCondition(ConditionObject* condition)
+{
+    LWP_CondSignal(*condition);
+}
+
+void SYS_BroadcastCondition(ConditionObject* condition)
+{
+    LWP_CondBroadcast(*condition);
+}
+
+void SYS_DestroyCondition(ConditionObject* condition)
+{
+    LWP_CondDestroy(*condition);
+    delete condition;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     // Uh... not sure how to sleep for a given duration.
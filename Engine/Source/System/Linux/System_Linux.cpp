@@ -267,6 +267,13 @@ void SYS_Initialize()
     EngineState& engine = *GetEngineState();
     SystemState& system = engine.mSystem;
 
+    if (GetEngineConfig()->mHeadless)
+    {
+        // No display connection or window. Window, cursor and clipboard functions do nothing.
+        LogDebug("Headless, skipping window creation");
+        return;
+    }
+
     // Create a window with XCB
     system.mXcbConnection = xcb_connect(NULL, NULL);
 
@@ -420,21 +427,27 @@ void SYS_Shutdown()
     ImGui_ImplXcb_Shutdown();
 #endif
 
-    xcb_free_cursor (system.mXcbConnection, system.mNullCursor);
-
-    if (system.mXcbWindow != 0)
-    {
-        xcb_destroy_window(system.mXcbConnection, system.mXcbWindow);
-    }
-    
     if (system.mXcbConnection != nullptr)
     {
+        xcb_free_cursor (system.mXcbConnection, system.mNullCursor);
+
+        if (system.mXcbWindow != 0)
+        {
+            xcb_destroy_window(system.mXcbConnection, system.mXcbWindow);
+        }
+
         xcb_disconnect(system.mXcbConnection);
     }
 }
 
 void SYS_Update()
 {
+    if (GetEngineState()->mSystem.mXcbConnection == nullptr)
+    {
+        // Headless
+        return;
+    }
+
     int32_t prevMouseX = 0;
     int32_t prevMouseY = 0;
     INP_GetMousePosition(prevMouseX, prevMouseY);
@@ -523,6 +536,19 @@ bool SYS_DoesFileExist(const char* path, bool isAsset)
     return exists;
 }
 
+uint64_t SYS_GetFileModifiedTime(const char* path)
+{
+    struct stat info;
+    uint64_t modifiedTime = 0;
+
+    if (stat(path, &info) == 0)
+    {
+        modifiedTime = uint64_t(info.st_mtime);
+    }
+
+    return modifiedTime;
+}
+
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize)
 {
     outData = nullptr;
@@ -788,6 +814,45 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+ConditionObject* SYS_CreateCondition()
+{
+    ConditionObject* retCondition = new ConditionObject();
+    int status = pthread_cond_init(retCondition, nullptr);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Condition");
+    }
+
+    return retCondition;
+}
+
+void SYS_WaitCondition(ConditionObject* condition, MutexObject* mutex)
+{
+    int status = pthread_cond_wait(condition, mutex);
+
+    if (status != 0)
+    {
+        LogError("Failed to wait on condition");
+    }
+}
+
+void SYS_SignalCondition(ConditionObject* condition)
+{
+    pthread_cond_signal(condition);
+}
+
+void SYS_BroadcastCondition(ConditionObject* condition)
+{
+    pthread_cond_broadcast(condition);
+}
+
+void SYS_DestroyCondition(ConditionObject* condition)
+{
+    pthread_cond_destroy(condition);
+    delete condition;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
@@ -941,6 +1006,12 @@ void SYS_SetClipboardText(const std::string& str)
     sClipboardString = str;
 
     SystemState& system = GetEngineState()->mSystem;
+
+    if (system.mXcbConnection == nullptr)
+    {
+        return;
+    }
+
     xcb_atom_t selection = InternAtom("CLIPBOARD");
     xcb_set_selection_owner(system.mXcbConnection, system.mXcbWindow, selection, XCB_CURRENT_TIME);
     xcb_flush(system.mXcbConnection);
@@ -960,6 +1031,11 @@ std::string SYS_GetClipboardText()
 
     SystemState& system = GetEngineState()->mSystem;
 
+    if (system.mXcbConnection == nullptr)
+    {
+        return retStr;
+    }
+
     xcb_connection_t* conn = system.mXcbConnection;
     
     xcb_atom_t selection = InternAtom("CLIPBOARD");
@@ -1057,6 +1133,12 @@ int32_t SYS_GetPlatformTier()
 void SYS_SetWindowTitle(const char* title)
 {
     SystemState& system = GetEngineState()->mSystem;
+
+    if (system.mXcbConnection == nullptr)
+    {
+        return;
+    }
+
 	xcb_change_property(system.mXcbConnection, XCB_PROP_MODE_REPLACE,
 		system.mXcbWindow, XCB_ATOM_WM_NAME, XCB_ATOM_STRING, 8,
 		strlen(title), title);
@@ -1081,7 +1163,8 @@ void SYS_SetFullscreen(bool fullscreen)
 {
     SystemState& system = GetEngineState()->mSystem;
 
-    if (system.mFullscreen != fullscreen)
+    if (system.mXcbConnection != nullptr &&
+        system.mFullscreen != fullscreen)
     {
         system.mFullscreen = fullscreen;
 
@@ -1110,6 +1193,12 @@ bool SYS_IsFullscreen()
 void SYS_SetWindowRect(int32_t x, int32_t y, int32_t width, int32_t height)
 {
     SystemState& system = GetEngineState()->mSystem;
+
+    if (system.mXcbConnection == nullptr)
+    {
+        return;
+    }
+
     uint32_t values[] = { (uint32_t)x, (uint32_t)y, (uint32_t)width, (uint32_t)height };
     xcb_configure_window(system.mXcbConnection, system.mXcbWindow, XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y | XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT, values);
 }
@@ -1117,6 +1206,16 @@ void SYS_SetWindowRect(int32_t x, int32_t y, int32_t width, int32_t height)
 void SYS_GetWindowRect(int32_t& outX, int32_t& outY, int32_t& outWidth, int32_t& outHeight)
 {
     SystemState& system = GetEngineState()->mSystem;
+
+    if (system.mXcbConnection == nullptr)
+    {
+        outX = 0;
+        outY = 0;
+        outWidth = int32_t(GetEngineState()->mWindowWidth);
+        outHeight = int32_t(GetEngineState()->mWindowHeight);
+        return;
+    }
+
     xcb_get_geometry_reply_t* geom = xcb_get_geometry_reply(system.mXcbConnection, xcb_get_geometry(system.mXcbConnection, system.mXcbWindow), NULL);
 
     /* Do something with the fields of geom */
@@ -14,6 +14,7 @@ void SYS_Update();
 
 // Files
 bool SYS_DoesFileExist(const char* path, bool isAsset);
+uint64_t SYS_GetFileModifiedTime(const char* path); // Seconds since epoch, 0 if the file doesn't exist
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize);
 void SYS_ReleaseFileData(char* data);
 std::string SYS_GetCurrentDirectoryPath();
@@ -38,6 +39,13 @@ MutexObject* SYS_CreateMutex();
 void SYS_LockMutex(MutexObject* mutex);
 void SYS_UnlockMutex(MutexObject* mutex);
 void SYS_DestroyMutex(MutexObject* mutex);
+// Conditions must be waited on with the mutex locked once, and signaled while holding the same mutex.
+// Waits may wake spuriously, so always recheck the predicate.
+ConditionObject* SYS_CreateCondition();
+void SYS_WaitCondition(ConditionObject* condition, MutexObject* mutex);
+void SYS_SignalCondition(ConditionObject* condition);
+void SYS_BroadcastCondition(ConditionObject* condition);
+void SYS_DestroyCondition(ConditionObject* condition);
 void SYS_Sleep(uint32_t milliseconds);
 
 // Time
@@ -37,20 +37,29 @@
 #endif
 
 #if PLATFORM_WINDOWS
+struct WindowsCondition
+{
+    HANDLE mSemaphore = nullptr;
+    int32_t mNumWaiters = 0;
+};
 typedef HANDLE ThreadObject;
 typedef HANDLE MutexObject;
+typedef WindowsCondition ConditionObject;
 typedef DWORD ThreadFuncRet;
 #elif (PLATFORM_LINUX || PLATFORM_ANDROID)
 typedef pthread_t ThreadObject;
 typedef pthread_mutex_t MutexObject;
+typedef pthread_cond_t ConditionObject;
 typedef void* ThreadFuncRet;
 #elif PLATFORM_DOLPHIN
 typedef lwp_t ThreadObject;
 typedef uint32_t MutexObject;
+typedef cond_t ConditionObject;
 typedef void* ThreadFuncRet;
 #elif PLATFORM_3DS
 typedef Thread ThreadObject;
 typedef uint32_t MutexObject;
+typedef uint32_t ConditionObject;
 typedef void ThreadFuncRet;
 #endif
 
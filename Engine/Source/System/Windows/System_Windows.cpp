@@ -371,6 +371,19 @@ bool SYS_DoesFileExist(const char* path, bool isAsset)
     return exists;
 }
 
+uint64_t SYS_GetFileModifiedTime(const char* path)
+{
+    struct stat info;
+    uint64_t modifiedTime = 0;
+
+    if (stat(path, &info) == 0)
+    {
+        modifiedTime = uint64_t(info.st_mtime);
+    }
+
+    return modifiedTime;
+}
+
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize)
 {
     outData = nullptr;
@@ -741,6 +754,57 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+ConditionObject* SYS_CreateCondition()
+{
+    ConditionObject* retCondition = new ConditionObject();
+
+    // Our mutexes are kernel objects, so the condition is emulated with a semaphore.
+    // SignalObjectAndWait() releases the mutex and starts waiting atomically, so no wakeups are lost.
+    retCondition->mSemaphore = CreateSemaphore(
+        NULL,       // default security attributes
+        0,          // initial count
+        LONG_MAX,   // maximum count
+        NULL);      // unnamed semaphore
+
+    if (retCondition->mSemaphore == 0)
+    {
+        LogError("Failed to create Condition");
+    }
+
+    return retCondition;
+}
+
+void SYS_WaitCondition(ConditionObject* condition, MutexObject* mutex)
+{
+    condition->mNumWaiters++;
+    SignalObjectAndWait(*mutex, condition->mSemaphore, INFINITE, FALSE);
+    SYS_LockMutex(mutex);
+}
+
+void SYS_SignalCondition(ConditionObject* condition)
+{
+    if (condition->mNumWaiters > 0)
+    {
+        condition->mNumWaiters--;
+        ReleaseSemaphore(condition->mSemaphore, 1, NULL);
+    }
+}
+
+void SYS_BroadcastCondition(ConditionObject* condition)
+{
+    if (condition->mNumWaiters > 0)
+    {
+        ReleaseSemaphore(condition->mSemaphore, condition->mNumWaiters, NULL);
+        condition->mNumWaiters = 0;
+    }
+}
+
+void SYS_DestroyCondition(ConditionObject* condition)
+{
+    CloseHandle(condition->mSemaphore);
+    delete condition;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     Sleep(milliseconds);